@@ -0,0 +1,45 @@
+
+#ifndef ACCESS_STRATEGY_H
+#define ACCESS_STRATEGY_H
+
+#include <memory>
+#include "MyDB_Page.h"
+#include <vector>
+
+using namespace std;
+
+class MyDB_AccessStrategy;
+typedef shared_ptr <MyDB_AccessStrategy> MyDB_AccessStrategyPtr;
+
+// a bulk-read ring, for big sequential scans.  The pages that a scan has to read in are
+// remembered in a ring of a few slots; when the scan needs a frame for a new page, it
+// first tries to take back the frame of the page that it read ringSize pages ago (if no
+// one has a handle to that page, and it is still buffered).  So once the ring is full,
+// the scan keeps re-using its own few frames, rather than pushing the rest of the buffer
+// out.  Pages that the scan finds already buffered are used as usual, and do not go into
+// the ring.  A strategy must only be used by one thread at a time
+class MyDB_AccessStrategy {
+
+public:
+
+	// creates a ring with the given number of slots
+	MyDB_AccessStrategy (size_t ringSize) {
+		ring.resize (ringSize == 0 ? 1 : ringSize);
+		next = 0;
+	}
+
+	// the number of slots
+	size_t size () {
+		return ring.size ();
+	}
+
+private:
+
+	friend class MyDB_BufferManager;
+
+	// the pages that the scan read in, and the slot that the next one goes into
+	vector <MyDB_PagePtr> ring;
+	size_t next;
+};
+
+#endif
@@ -13,16 +13,27 @@
 #ifndef BUFFER_MGR_H
 #define BUFFER_MGR_H
 
-#include "CheckLRU.h"
 #include <map>
 #include <memory>
+#include "MyDB_AccessStrategy.h"
+#include "MyDB_BufferOptions.h"
+#include "MyDB_BufferPool.h"
+#include "MyDB_BufferShard.h"
+#include "MyDB_BufferStats.h"
+#include "MyDB_FrameStack.h"
+#include "MyDB_IOBackend.h"
+#include "MyDB_Latch.h"
 #include "MyDB_Page.h"
+#include "MyDB_PageFlusher.h"
 #include "MyDB_PageHandle.h"
+#include "MyDB_Prefetcher.h"
+#include "MyDB_Reservation.h"
+#include "MyDB_SharedPool.h"
+#include "MyDB_SpillSpace.h"
+#include "MyDB_TempRun.h"
 #include "MyDB_Table.h"
-#include "PageCompare.h"
 #include <queue>
-#include "TableCompare.h"
-#include <set>
+#include <vector>
 
 using namespace std;
 
@@ -38,6 +49,15 @@ public:
 	// to that already-buffered page should be returned
 	MyDB_PageHandle getPage (MyDB_TablePtr whichTable, long i);
 
+	// like the above, except that if the page has to be read in, it is read through
+	// the given access strategy; a nullptr strategy means to use the buffer as usual
+	MyDB_PageHandle getPage (MyDB_TablePtr whichTable, long i, MyDB_AccessStrategyPtr strategy);
+
+	// gets an access strategy for a big sequential scan of the given table, whose pages
+	// are then recycled through a small ring of frames instead of filling up the whole
+	// buffer.  Returns a nullptr if the table is small enough that it does not matter
+	MyDB_AccessStrategyPtr getBulkReadStrategy (MyDB_TablePtr whichTable);
+
 	// gets a temporary page that will no longer exist (1) after the buffer manager
 	// has been destroyed, or (2) there are no more references to it anywhere in the
 	// program.  Typically such a temporary page will be used as buffer memory.
@@ -45,6 +65,14 @@ public:
 	// table
 	MyDB_PageHandle getPage ();
 
+	// starts a run of temp pages that will be written in order, and read back in
+	// order (such as a sorted run); see MyDB_TempRun
+	MyDB_TempRunPtr startTempRun ();
+
+	// like getPage (), except that the temp page is the next page of the given run (a
+	// nullptr run gives an ordinary temp page)
+	MyDB_PageHandle getPage (MyDB_TempRunPtr run);
+
 	// gets the i^th page in the table whichTable... the only difference 
 	// between this method and getPage (whicTable, i) is that the page will be 
 	// pinned in RAM; it cannot be written out to the file... note that in Chris'
@@ -55,14 +83,54 @@ public:
 	// gets a temporary page, like getPage (), except that this one is pinned
 	MyDB_PageHandle getPinnedPage ();
 
+	// reserves numFrames frames for a query (or an operator) that is going to pin pages,
+	// so that it knows up front whether it will have the memory that it needs.  Returns
+	// a nullptr if the frames cannot be granted: grants are never given the last few
+	// frames (so unpinned pages can still be read), or any frame that is pinned outside
+	// of a grant, or any frame that was already granted to someone else
+	MyDB_ReservationPtr reserve (size_t numFrames);
+
+	// the most frames that a call to reserve () could be granted right now
+	size_t getNumReservable ();
+
+	// like the two above, except that the pinned page counts against the given grant
+	// (which may be a nullptr, for no grant).  This returns a nullptr if the grant is
+	// used up.  A page that is pinned without a grant never takes a frame that has
+	// been granted, and not yet used, so that it gets a nullptr instead
+	MyDB_PageHandle getPinnedPage (MyDB_TablePtr whichTable, long i, MyDB_ReservationPtr grant);
+	MyDB_PageHandle getPinnedPage (MyDB_ReservationPtr grant);
+
 	// un-pins the specified page
 	void unpin (MyDB_PagePtr unpinMe);
 
+	// writes the warm-start manifest (see MyDB_BufferOptions :: warmStartFile): the
+	// buffered pages of each table, the most recently used first.  This is done
+	// anyway when the buffer manager is destroyed.  Returns false if there is no
+	// manifest file, or if it could not be written
+	bool checkpoint ();
+
+	// reads back in the pages listed in the warm-start manifest, the most recently used
+	// first, until the listed pages or the free frames run out; nothing is kicked out
+	// for them.  The pages are read with one big batch of vectored reads (one per run
+	// of pages that are next to each other in a file) and are then buffered as unpinned
+	// pages.  Anyone who asks for one of the pages in the meantime waits for it, so
+	// this can be run on its own thread while the tables are being set up (as long as
+	// the buffer manager is latched; see MyDB_BufferOptions).  Returns the number of
+	// pages read in
+	size_t warmStart ();
+
 	// creates an LRU buffer manager... params are as follows:
 	// 1) the size of each page is pageSize 
 	// 2) the number of pages managed by the buffer manager is numPages;
-	// 3) temporary pages are written to the file tempFile
+	// 3) temporary pages are written to the file tempFile (or, given options, to
+	//    files named after it)
 	MyDB_BufferManager (size_t pageSize, size_t numPages, string tempFile);
+
+	// like the above, except that the replacement policy (and so on) is given
+	// by the options, rather than always being LRU.  Note that in concurrent mode,
+	// an unpinned page can be kicked out by any thread at any time, so a page whose
+	// bytes are used while other threads are running should be a pinned page
+	MyDB_BufferManager (size_t pageSize, size_t numPages, string tempFile, MyDB_BufferOptions options);
 	
 	// when the buffer manager is destroyed, all of the dirty pages need to be
 	// written back to disk, and any temporary files need to be deleted
@@ -70,51 +138,234 @@ public:
 
 	// returns the page size
 	size_t getPageSize ();
-	
-private:
 
-	// tells us the LRU number of each of the pages
-	set <MyDB_PagePtr, CheckLRU> lastUsed;
+	// the number of page accesses that found the page in RAM, and the number
+	// that had to go to disk
+	size_t getNumHits ();
+	size_t getNumMisses ();
 
-	// list of ALL of the page objects that are currently in existence
-	map <pair <MyDB_TablePtr, size_t>, MyDB_PagePtr, PageCompare> allPages;
+	// gets a snapshot of all of the statistics that the buffer manager keeps (see
+	// MyDB_BufferStats); resetStats zeroes them all out, so that (for example) the
+	// stats for a single query can be had by resetting before it and getting after it
+	MyDB_BufferStats getStats ();
+	void resetStats ();
 	
-	// lists the FDs for all of the files
-	map <MyDB_TablePtr, int, TableCompare> fds;
-
-	// all of the chunks of RAM that are currently not allocated
-	vector <void *> availableRam;
+private:
 
-	// all of the positions in the temporary file that are currently not in use
-	priority_queue<size_t, vector<size_t>, greater<size_t>> availablePositions;
+	// the shards; a page lives in shard shardOf (table id, page number)
+	vector <MyDB_BufferShardPtr> shards;
+	
+	// lists the FDs for all of the tables' files, indexed by table id; a -1 means
+	// that the file has not been opened yet.  Slot 0 (the temp table id) is not
+	// used, since temp pages go to the spill space
+	vector <int> fds;
+	MyDB_Latch fdLatch;
+
+	// the name of each table, indexed by table id, for the stats
+	vector <string> tableNames;
+
+	// the buffer pools; pool 0 is the default pool.  Also the pool that each table's
+	// pages go in, indexed by table id (this is set when the table's file is opened,
+	// and is protected by fdLatch), the pools that the tables were assigned to by name,
+	// and the pool that temp pages go in
+	vector <MyDB_BufferPoolPtr> pools;
+	vector <size_t> tablePools;
+	map <string, size_t> namedTablePools;
+	size_t tempPool;
+
+	// true if the files are to be opened for direct I/O
+	bool directIO;
+
+	// all of the RAM, as one arena of numPages frames; frame i starts at byte
+	// i * pageSize.  Also, the numbers of the frames that are not allocated
+	char *arena;
+	size_t arenaSize;
+	MyDB_FrameStack freeFrames;
+
+	// the temp files that temp pages are spilled to, and the number of temp pages that
+	// have been handed out; both are protected by tempLatch
+	shared_ptr <MyDB_SpillSpace> spill;
+	size_t numTempAllocations;
+	MyDB_Latch tempLatch;
+
+	// the number of frames that have been granted to reservations, and the number of
+	// those that are pinned; and the number of reservations that were turned down
+	size_t numReserved;
+	atomic <size_t> numReservedPinned;
+	size_t numDenied;
+	MyDB_Latch reserveLatch;
+
+	// the number of pages held by the replacement policies; every other frame that is
+	// not free is pinned (or is being read into).  And the most frames that have been
+	// pinned at once
+	atomic <size_t> numEvictable;
+	atomic <size_t> pinnedHighWater;
+
+	// how long the reads and the writes took
+	MyDB_LatencyHistogram readLatency;
+	MyDB_LatencyHistogram writeLatency;
 
 	// the page size
 	size_t pageSize;
 
-	// the time tick associated with the MRU page
-	long lastTimeTick;
-
-	// the last position in the temporary file
-	size_t lastTempPos;
-
 	// where we write the data
 	string tempFile;
 
 	// the number of buffer pages
 	size_t numPages;
 
+	// does all of the file I/O
+	MyDB_IOBackendPtr io;
+
+	// the buffer that the table pages are shared through; a nullptr if they are kept
+	// in this buffer manager's own frames
+	MyDB_SharedPoolPtr sharedPool;
+
+	// does the read-ahead; a nullptr if read-ahead is off
+	shared_ptr <MyDB_Prefetcher> prefetcher;
+
+	// the warm-start manifest file ("" if there is none), the most pages to list in it,
+	// and the number of pages that warmStart () read in
+	string warmStartFile;
+	size_t warmStartLimit;
+	atomic <size_t> numWarmed;
+
+	// the background writer, and the number of clean frames it tries to keep; a
+	// nullptr if the background writer is off
+	shared_ptr <MyDB_PageFlusher> flusher;
+	size_t cleanTarget;
+
 	// so that the page can access these private methods
 	friend class MyDB_Page;
+	friend class MyDB_PageHandle;
+	friend class MyDB_Prefetcher;
+	friend class MyDB_PageFlusher;
+	friend class MyDB_Reservation;
+	friend class MyDB_TempRun;
 	friend class SortMergeJoin;
 
-	// kick out the LRU page
-	void kickOutPage ();
-
-	// process an access to the given page
-	void access (MyDB_PagePtr updateMe);
-
-	// removes all traces of the page from the buffer manager
-	void killPage (MyDB_PagePtr killMe);
+	// go between a frame number and the frame's bytes
+	inline void *frameBytes (size_t frame) {
+		return arena + frame * pageSize;
+	}
+	inline size_t frameOf (void *bytes) {
+		return ((char *) bytes - arena) / pageSize;
+	}
+
+	// the number of frames that are pinned (or being read into) now
+	size_t numPinnedNow ();
+
+	// updates the pinned high-water mark
+	void notePinned ();
+
+	// the number of frames that could be granted now; reserveLatch must be held
+	size_t numReservableLatched ();
+
+	// run by a reservation: adds frames to it (returning false if they cannot be had),
+	// and gives all of its frames back when it is done
+	bool growReservation (MyDB_Reservation &grant, size_t numMore);
+	void endReservation (MyDB_Reservation &grant);
+
+	// true if a page may be pinned outside of a grant without taking a granted frame
+	bool mayPinUngranted ();
+
+	// counts the pinned page against the grant (the grant has already been charged, if
+	// charged is true; the charge is given back if the page is already counted against
+	// a grant), and takes a page that is no longer pinned off of its grant.  The shard
+	// must be latched
+	void chargePage (MyDB_PagePtr page, MyDB_ReservationPtr grant, bool charged);
+	void releasePage (MyDB_PagePtr page);
+
+	// returns the shard that the given page belongs in
+	size_t shardOf (size_t tableId, size_t pos);
+
+	// gets a frame for a page of the given pool: a free frame if the pool may grow, or
+	// else one taken by kicking out a page (starting with the given shard), either of
+	// the pool's own or of a pool that is holding more than its share.  Returns false if
+	// there is nothing that the pool may kick out.  If granted is true, the frame is for
+	// a page pinned through a reservation, which may take a frame from any pool when
+	// there is nothing else
+	bool getFrame (size_t whichShard, size_t pool, size_t &frame, bool granted = false);
+
+	// counts one more frame against the pool, if it is not at its limit
+	bool growPool (size_t pool);
+
+	// takes a free frame for a page of the given pool, if there is one and the pool may
+	// grow; and gives a frame that the pool was holding back to the free frames
+	bool takeFreeFrame (size_t pool, size_t &frame);
+	void putFrame (size_t pool, size_t frame);
+
+	// kick out the page of the given pool chosen by the shard's replacement policy,
+	// returning its frame (which still counts against that pool); the shard must be
+	// latched
+	bool kickOutPage (MyDB_BufferShard &shard, size_t pool, size_t &frame);
+
+	// hands the page to the replacement policy / takes it away from the policy; the
+	// shard must be latched
+	void makeEvictable (MyDB_BufferShard &shard, MyDB_PagePtr page);
+	void makeUnevictable (MyDB_BufferShard &shard, MyDB_PagePtr page);
+
+	// process an access to the given page, returning its bytes; if the page has to be
+	// read in, and there is a strategy, its frame comes from the strategy's ring
+	void *access (const MyDB_PagePtr &updateMe, MyDB_AccessStrategy *strategy = nullptr);
+
+	// true if the page is kept in the shared buffer
+	inline bool isShared (const MyDB_PagePtr &page) {
+		return sharedPool != nullptr && page->myTable != nullptr;
+	}
+
+	// pins a page of the shared buffer (if its bytes are not already pinned there),
+	// returning its bytes; returns a nullptr if every shared frame is pinned
+	void *pinShared (const MyDB_PagePtr &page);
+
+	// tries to take back the frame of the page in the strategy's next ring slot, for a
+	// page of the given pool; returns false if there is no page there, if the page is
+	// being used, or if the frame would put the pool over its limit
+	bool recycleRingFrame (MyDB_AccessStrategy &strategy, size_t pool, size_t &frame);
+
+	// puts the page into the strategy's next ring slot
+	void addToRing (MyDB_AccessStrategy &strategy, MyDB_PagePtr page);
+
+	// run by a temp run when it is done
+	void endTempRun (MyDB_TempRun &run);
+
+	// run when the last handle to the page may be going away: drops the handle's
+	// reference, and if it was the last one, unpins the page (or kills it)
+	void releaseHandle (MyDB_Page *page);
+
+	// removes all traces of the page from the buffer manager; the shard must be latched
+	void killPageLatched (MyDB_BufferShard &shard, MyDB_PagePtr killMe);
+
+	// returns the FD for the given table id, opening the file if needed; pool is set to
+	// the buffer pool that the table's pages go in
+	int getFd (size_t tableId, MyDB_TablePtr whichTable, size_t &pool);
+
+	// opens the file with the given flags, asking for direct I/O if it is turned on
+	// (and falling back to the OS cache if the file system will not do it)
+	int openFile (string fName, int flags);
+
+	// sets aside frames for the pages first ... first + count - 1 of the page's table
+	// (stopping at the first page that is already buffered) and hands them to the
+	// read-ahead worker; this is run by the thread that asked for the page.  If there
+	// is a strategy, the frames come from its ring when they can
+	void startReadAhead (MyDB_PagePtr fromPage, size_t first, size_t count, MyDB_AccessStrategy *strategy);
+
+	// this is run by the read-ahead worker: it reads the pages in (all of the runs at
+	// once), and puts them in the buffer as unpinned pages
+	void finishReadAhead (vector <MyDB_ReadAheadRequest> &requests);
+
+	// run by the background writer: if there are fewer clean frames than the target,
+	// writes out all of the dirty, unpinned pages that no one has a handle to
+	void flushDirtyPages ();
+
+	// writes out the given pages, sorted by file and position, with the pages that
+	// are next to each other in a file written by a single request; all of the
+	// requests are given to the I/O backend at once
+	void writePages (vector <MyDB_PagePtr> &pages);
+
+	// move the page's bytes to and from its file
+	void readPage (MyDB_PagePtr page);
+	void writePage (MyDB_PagePtr page);
 
 };
 
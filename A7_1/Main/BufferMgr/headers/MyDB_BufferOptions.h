@@ -0,0 +1,125 @@
+
+#ifndef BUFFER_OPTIONS_H
+#define BUFFER_OPTIONS_H
+
+#include "MyDB_IOBackend.h"
+#include <map>
+#include "MyDB_ReplacementPolicy.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// a named buffer pool (a tablespace): a share of the buffer's frames that is set aside
+// for the pages assigned to it.  The pool always gets numPages frames if it wants them;
+// it can borrow more from the other pools while they are not using theirs, up to
+// maxPages in all (zero means up to the whole buffer).  Borrowed frames are taken back,
+// by evicting the borrower's pages, as soon as their owner needs them
+struct MyDB_PoolOptions {
+	string name;
+	size_t numPages;
+	size_t maxPages;
+
+	MyDB_PoolOptions (string nameIn, size_t numPagesIn, size_t maxPagesIn = 0) {
+		name = nameIn;
+		numPages = numPagesIn;
+		maxPages = maxPagesIn;
+	}
+};
+
+// the knobs that can be given to a buffer manager when it is created; the defaults
+// give the classic LRU buffer manager
+struct MyDB_BufferOptions {
+
+	// the page replacement policy to use
+	MyDB_ReplacementType replacement;
+
+	// the K used by the LRU-K policy
+	size_t lruK;
+
+	// if true, the buffer manager may be used by several threads at once; the pages
+	// are then split over numShards shards, each with its own latch and its own
+	// replacement policy
+	bool concurrent;
+	size_t numShards;
+
+	// the number of pages to read ahead when a table is being scanned; zero turns
+	// read-ahead off.  Read-ahead uses a worker thread, so it also turns on latching
+	size_t readAhead;
+
+	// the number of clean frames that the background writer tries to keep around;
+	// zero turns the background writer off.  This also turns on latching
+	size_t cleanTarget;
+
+	// how pages are moved to and from the files, and (for io_uring) how many requests
+	// can be in flight at once.  If io_uring cannot be set up, pread/pwrite is used
+	MyDB_IOType io;
+	unsigned ioDepth;
+
+	// if true, the buffer pool is put on huge pages (if there are none reserved, the
+	// kernel is asked to use transparent huge pages for it instead), which cuts down
+	// on TLB misses when a big pool is scanned
+	bool hugePages;
+
+	// if true, the table and temp files are opened for direct I/O (O_DIRECT), so that
+	// pages are not cached by the OS as well as by us.  This needs a page size that
+	// is a multiple of 4KB; if it is not, or if a file's file system will not do direct
+	// I/O, that file just uses the OS cache as usual
+	bool directIO;
+
+	// where temp pages are spilled to: numTempFiles files, spread round-robin over the
+	// directories in tempDirs (there is at least one file per directory).  With no
+	// directories, the files go next to the temp file given to the buffer manager (and
+	// a single file is that temp file).  The files are handed out tempExtentPages
+	// pages at a time
+	vector <string> tempDirs;
+	size_t numTempFiles;
+	size_t tempExtentPages;
+
+	// the warm-start manifest: if this is not empty, the buffer manager lists the pages
+	// that it is holding (the most recently used first) in this file when it is
+	// destroyed (or when it is checkpointed), and it can read those pages back in
+	// when it is started up again.  At most warmStartPages pages are listed; zero
+	// means as many as the buffer holds
+	string warmStartFile;
+	size_t warmStartPages;
+
+	// the named buffer pools.  The frames that are not given to a named pool make up
+	// the "default" pool, which can borrow from all of the others.  Each table whose
+	// name is in tablePools has its pages in the given pool, and the temp pages are in
+	// tempPool; everything else is in the default pool.  This way, the pages of (say)
+	// the indexes and the small dimension tables can be kept safe from a big sort that
+	// is spilling, or from a big scan
+	vector <MyDB_PoolOptions> pools;
+	map <string, string> tablePools;
+	string tempPool;
+
+	// the shared buffer: if this is not empty, the table pages are kept in the POSIX
+	// shared memory segment with this name (which should start with a "/"), which every
+	// process that gives the same name attaches to, so that they all share one copy of
+	// each page (see MyDB_SharedPool).  The first process to attach creates it with
+	// sharedPages frames (zero means as many as the private buffer has).  The temp pages
+	// still go in the private buffer; read-ahead, access strategies, the named pools and
+	// the warm-start manifest only apply to the private buffer
+	string sharedBuffer;
+	size_t sharedPages;
+
+	MyDB_BufferOptions () {
+		replacement = LRUReplacement;
+		lruK = 2;
+		concurrent = false;
+		numShards = 16;
+		readAhead = 0;
+		cleanTarget = 0;
+		io = PosixIO;
+		ioDepth = 64;
+		hugePages = false;
+		directIO = false;
+		numTempFiles = 1;
+		tempExtentPages = 64;
+		warmStartPages = 0;
+		sharedPages = 0;
+	}
+};
+
+#endif
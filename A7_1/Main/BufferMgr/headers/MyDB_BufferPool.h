@@ -0,0 +1,40 @@
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+struct MyDB_BufferPool;
+typedef shared_ptr <MyDB_BufferPool> MyDB_BufferPoolPtr;
+
+// one of the buffer manager's pools (see MyDB_PoolOptions).  The pool does not own any
+// particular frames; it just counts the frames that its pages hold, so that the buffer
+// manager can tell whether the pool may take one more, and whether it is holding
+// frames that it borrowed from the other pools
+struct MyDB_BufferPool {
+
+	// the pool's name, the number of frames that it is promised, and the most that it
+	// may hold
+	string name;
+	size_t numPages;
+	size_t maxPages;
+
+	// the number of frames held by the pool's pages (pinned or not, or being read
+	// into), and the number of its pages that were kicked out
+	atomic <size_t> numHeld;
+	atomic <size_t> numEvictions;
+
+	MyDB_BufferPool (string nameIn, size_t numPagesIn, size_t maxPagesIn) {
+		name = nameIn;
+		numPages = numPagesIn;
+		maxPages = maxPagesIn;
+		numHeld = 0;
+		numEvictions = 0;
+	}
+};
+
+#endif
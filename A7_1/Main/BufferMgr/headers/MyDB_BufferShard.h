@@ -0,0 +1,76 @@
+
+#ifndef BUFFER_SHARD_H
+#define BUFFER_SHARD_H
+
+#include <condition_variable>
+#include <memory>
+#include "MyDB_Latch.h"
+#include "MyDB_PageTable.h"
+#include "MyDB_ReplacementPolicy.h"
+#include <vector>
+
+using namespace std;
+
+class MyDB_BufferShard;
+typedef shared_ptr <MyDB_BufferShard> MyDB_BufferShardPtr;
+
+// one partition of the buffer manager.  Every page is hashed to a shard on its (table id,
+// page number), and the shard's latch protects the shard's page table and replacement
+// policy, as well as the buffer-manager-owned fields (bytes, isDirty, evictable, and the
+// policy bookkeeping) of every page in the shard
+struct MyDB_BufferShard {
+
+	// the non-temp pages in this shard
+	MyDB_PageTable allPages;
+
+	// decide which of this shard's pages gets kicked out; there is one policy for each
+	// buffer pool, indexed by the pool's number, holding that pool's pages
+	vector <MyDB_ReplacementPolicyPtr> policies;
+
+	// protects everything in here
+	MyDB_Latch latch;
+
+	// signalled when the read-ahead worker puts pages into this shard, or when the
+	// flusher is done writing pages of this shard
+	condition_variable_any ioDone;
+
+	// counts of the accesses to this shard that hit and missed the buffer, indexed
+	// by table id
+	vector <size_t> hits;
+	vector <size_t> misses;
+
+	// the number of pages kicked out of this shard, and the number of dirty pages of
+	// this shard that were written back
+	size_t numEvictions;
+	size_t numWriteBacks;
+
+	// counts the accesses to this shard's pages; each page is stamped with the count
+	// when it is accessed, so that the pages can be ranked by how recently they were used
+	long useTick;
+
+	MyDB_BufferShard () {
+		numEvictions = 0;
+		numWriteBacks = 0;
+		useTick = 0;
+	}
+
+	// count a hit or a miss on the given table, and stamp the page that was accessed
+	inline void noteHit (size_t tableId, long &lastUsed) {
+		if (tableId >= hits.size ()) {
+			hits.resize (tableId + 1, 0);
+			misses.resize (tableId + 1, 0);
+		}
+		hits[tableId]++;
+		lastUsed = ++useTick;
+	}
+	inline void noteMiss (size_t tableId, long &lastUsed) {
+		if (tableId >= hits.size ()) {
+			hits.resize (tableId + 1, 0);
+			misses.resize (tableId + 1, 0);
+		}
+		misses[tableId]++;
+		lastUsed = ++useTick;
+	}
+};
+
+#endif
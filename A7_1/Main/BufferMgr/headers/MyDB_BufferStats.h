@@ -0,0 +1,106 @@
+
+#ifndef BUFFER_STATS_H
+#define BUFFER_STATS_H
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the number of buckets in a latency histogram; bucket 0 counts the operations that took
+// under 2 microseconds, and bucket i > 0 counts the ones that took 2^i ... 2^(i + 1) - 1
+// microseconds (the last bucket also takes everything slower than that)
+#define NUM_LATENCY_BUCKETS 24
+
+// a histogram of how long some kind of I/O took; it can be added to by several threads
+// at once
+class MyDB_LatencyHistogram {
+
+public:
+
+	MyDB_LatencyHistogram ();
+
+	// counts one operation that took the given number of microseconds
+	void record (size_t micros);
+
+	// zeroes all of the buckets
+	void reset ();
+
+	// gets the counts in all of the buckets
+	vector <size_t> getCounts ();
+
+private:
+
+	atomic <size_t> buckets[NUM_LATENCY_BUCKETS];
+};
+
+// the hits and misses on one table
+struct MyDB_TableStats {
+	string name;
+	size_t hits;
+	size_t misses;
+};
+
+// one buffer pool: its guaranteed frames, the most that it may hold, the number that it
+// holds now, and the number of its pages that were kicked out
+struct MyDB_PoolStats {
+	string name;
+	size_t numPages;
+	size_t maxPages;
+	size_t numHeld;
+	size_t evictions;
+};
+
+// a snapshot of what the buffer manager has been doing since it was created (or since
+// the stats were last reset)
+struct MyDB_BufferStats {
+
+	// the page accesses that found the page in RAM, and the ones that had to read it, for
+	// each table that has been accessed, and in total; temp pages are under "(temp)"
+	vector <MyDB_TableStats> tables;
+	size_t hits;
+	size_t misses;
+
+	// the number of pages kicked out to make room, and the number of dirty pages written
+	// back (by eviction or by the background writer)
+	size_t evictions;
+	size_t writeBacks;
+
+	// the number of temp pages handed out, the number of extents of the temp files that
+	// are in use now, and the number of extents whose space was given back
+	size_t tempAllocations;
+	size_t tempExtentsInUse;
+	size_t tempExtentsReleased;
+
+	// the most frames that were ever pinned (or being read into) at once, out of numPages
+	size_t pinnedHighWater;
+	size_t numPages;
+
+	// the number of frames granted to reservations now, and the number of reservations
+	// (or requests to grow one) that were turned down
+	size_t reservedFrames;
+	size_t reservationsDenied;
+
+	// the number of pages read back in from the warm-start manifest
+	size_t warmStartPages;
+
+	// the buffer pools, the default pool first
+	vector <MyDB_PoolStats> pools;
+
+	// the number of frames in the shared buffer, and the number of processes using it
+	// (both are zero if the buffer is not shared)
+	size_t sharedFrames;
+	size_t sharedProcesses;
+
+	// how long the reads and writes took; each read or write call (which may be one
+	// page, or a whole batch) counts once.  See NUM_LATENCY_BUCKETS for the buckets
+	vector <size_t> readLatency;
+	vector <size_t> writeLatency;
+
+	// prints the stats in a readable form
+	friend std::ostream& operator<<(std::ostream& os, const MyDB_BufferStats &printMe);
+};
+
+#endif
@@ -0,0 +1,38 @@
+
+#ifndef CLOCK_POLICY_H
+#define CLOCK_POLICY_H
+
+#include "MyDB_ReplacementPolicy.h"
+#include <vector>
+
+// the CLOCK (second chance) policy.  Every candidate sits in a slot of a ring; an
+// access just sets the page's reference bit, so there is no ordered structure to
+// update on a hit.  To find a victim, the hand sweeps the ring, clearing reference
+// bits, until it finds a page whose bit is already clear
+class MyDB_ClockPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	MyDB_ClockPolicy ();
+
+	void insert (MyDB_PagePtr page) override;
+	void touch (MyDB_PagePtr page) override;
+	void remove (MyDB_PagePtr page) override;
+	MyDB_PagePtr victim () override;
+
+private:
+
+	// the ring; an empty slot holds a nullptr
+	vector <MyDB_PagePtr> ring;
+
+	// the empty slots in the ring
+	vector <size_t> freeSlots;
+
+	// where the hand is pointing
+	size_t hand;
+
+	// the number of pages in the ring
+	size_t numCandidates;
+};
+
+#endif
@@ -0,0 +1,43 @@
+
+#ifndef FRAME_STACK_H
+#define FRAME_STACK_H
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+using namespace std;
+
+// a lock-free (Treiber) stack of buffer frame numbers; this is the buffer manager's list
+// of free frames.  The head packs the top frame together with a tag that is bumped on
+// every change, so that a pop cannot be fooled by the top being popped and pushed back
+// in between its read and its compare-and-swap (the ABA problem)
+class MyDB_FrameStack {
+
+public:
+
+	// creates an empty stack that can hold the frames 0 ... numFrames - 1
+	MyDB_FrameStack (size_t numFrames);
+
+	// pushes the frame
+	void push (size_t whichFrame);
+
+	// pops a frame; returns false if the stack is empty
+	bool pop (size_t &whichFrame);
+
+	// the number of frames on the stack; only exact if no one is pushing or popping
+	size_t size ();
+
+private:
+
+	// the low 32 bits are one more than the top frame (zero means empty); the high
+	// 32 bits are the tag
+	atomic <uint64_t> head;
+
+	// for each frame on the stack, one more than the frame below it
+	unique_ptr <atomic <uint32_t> []> next;
+
+	atomic <size_t> count;
+};
+
+#endif
@@ -0,0 +1,44 @@
+
+#ifndef IO_BACKEND_H
+#define IO_BACKEND_H
+
+#include <memory>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <vector>
+
+using namespace std;
+
+// the ways that the buffer manager can move pages to and from its files
+enum MyDB_IOType {PosixIO, IOUringIO};
+
+class MyDB_IOBackend;
+typedef shared_ptr <MyDB_IOBackend> MyDB_IOBackendPtr;
+
+// one contiguous piece of a file, read into (or written from) a list of frames
+struct MyDB_IORequest {
+	int fd;
+	off_t offset;
+	vector <struct iovec> iov;
+};
+
+// this is the interface that the buffer manager uses to do all of its file I/O.  All of
+// the I/O is positional (there is no shared file offset), so any number of threads can
+// use a backend at the same time.  Every call returns once all of its I/O is done
+class MyDB_IOBackend {
+
+public:
+
+	// reads/writes len bytes at the given offset of the file
+	virtual void read (int fd, void *bytes, size_t len, off_t offset) = 0;
+	virtual void write (int fd, void *bytes, size_t len, off_t offset) = 0;
+
+	// does all of the requests; a backend that can have many requests in flight at
+	// once is free to do them in any order
+	virtual void readBatch (vector <MyDB_IORequest> &requests) = 0;
+	virtual void writeBatch (vector <MyDB_IORequest> &requests) = 0;
+
+	virtual ~MyDB_IOBackend () {}
+};
+
+#endif
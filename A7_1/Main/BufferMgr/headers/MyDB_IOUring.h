@@ -0,0 +1,73 @@
+
+#ifndef IO_URING_H
+#define IO_URING_H
+
+#include <linux/io_uring.h>
+#include "MyDB_IOBackend.h"
+#include <mutex>
+
+using namespace std;
+
+// a backend that uses an io_uring (set up with the raw system calls, so there is no
+// need for liburing).  A batch is put into the submission queue all at once, so the
+// kernel can have up to depth of the requests in flight, and the calling thread then
+// waits for all of them to complete.  A single page read or write cannot overlap with
+// anything, so it just goes straight to pread/pwrite.  A request that the ring fails
+// on is re-done with preadv/pwritev, and so is the rest of one that the ring only did
+// part of
+class MyDB_IOUring : public MyDB_IOBackend {
+
+public:
+
+	// sets up a ring with (at least) depth entries
+	MyDB_IOUring (unsigned depth);
+
+	// tears down the ring
+	~MyDB_IOUring ();
+
+	// returns false if the ring could not be set up (for example, because the kernel
+	// is too old, or io_uring is turned off); the backend must not be used then
+	bool isOpen ();
+
+	void read (int fd, void *bytes, size_t len, off_t offset) override;
+	void write (int fd, void *bytes, size_t len, off_t offset) override;
+	void readBatch (vector <MyDB_IORequest> &requests) override;
+	void writeBatch (vector <MyDB_IORequest> &requests) override;
+
+private:
+
+	// pushes all of the requests through the ring with the given opcode, returning
+	// once they are all done
+	void run (vector <MyDB_IORequest> &requests, unsigned char opcode);
+
+	// does the request with preadv/pwritev, for when the ring cannot; the first done
+	// bytes of it are already done
+	void byHand (MyDB_IORequest &request, unsigned char opcode, size_t done);
+
+	// the ring; -1 if it could not be set up
+	int ringFd;
+
+	// the ring is shared by all of the threads, so only one batch goes at a time
+	mutex latch;
+
+	// the mapped submission queue
+	void *sqRing;
+	size_t sqRingSize;
+	unsigned *sqHead;
+	unsigned *sqTail;
+	unsigned *sqMask;
+	unsigned *sqArray;
+	unsigned sqEntries;
+	struct io_uring_sqe *sqes;
+	size_t sqesSize;
+
+	// the mapped completion queue; this may be the same mapping as the submission queue
+	void *cqRing;
+	size_t cqRingSize;
+	unsigned *cqHead;
+	unsigned *cqTail;
+	unsigned *cqMask;
+	struct io_uring_cqe *cqes;
+};
+
+#endif
@@ -0,0 +1,76 @@
+
+#ifndef LRU_K_POLICY_H
+#define LRU_K_POLICY_H
+
+#include <deque>
+#include "MyDB_ReplacementPolicy.h"
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// the LRU-K policy (O'Neil, O'Neil and Weikum).  The victim is the page whose K-th most
+// recent reference is the oldest; pages with fewer than K references are taken first (in
+// LRU order).  The reference history of a page is kept for a while after the page has
+// been kicked out, so a page that comes back quickly keeps its history.  Back-to-back
+// references to the same page (such as a scan calling getBytes () for each record on a
+// page) are correlated, and are counted as one reference
+class MyDB_LRUKPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	// numPages is the number of pages in the buffer; k is the K in LRU-K
+	MyDB_LRUKPolicy (size_t numPages, size_t k);
+
+	void insert (MyDB_PagePtr page) override;
+	void touch (MyDB_PagePtr page) override;
+	void remove (MyDB_PagePtr page) override;
+	MyDB_PagePtr victim () override;
+
+private:
+
+	// a page is identified by (table id, page number)
+	typedef pair <size_t, size_t> PageKey;
+	struct PageKeyHash {
+		size_t operator() (const PageKey &key) const {
+			return (key.first * 0x9E3779B97F4A7C15ULL) ^ key.second;
+		}
+	};
+
+	// orders the candidates by K-th most recent reference, then by last reference
+	struct CheckLRUK {
+		bool operator() (const MyDB_PagePtr lhs, const MyDB_PagePtr rhs) const {
+			if (lhs->kthRef != rhs->kthRef)
+				return lhs->kthRef < rhs->kthRef;
+			return lhs->timeTick < rhs->timeTick;
+		}
+	};
+
+	// the reference history of one page: the times of the last K references, most
+	// recent first, with a zero for a reference that never happened
+	struct History {
+		vector <long> refs;
+		bool resident;
+	};
+
+	// records a reference to the page, updating its timeTick and kthRef
+	void reference (MyDB_PagePtr page);
+
+	// all of the candidates
+	set <MyDB_PagePtr, CheckLRUK> candidates;
+
+	// the histories of all of the pages we know about
+	unordered_map <PageKey, History, PageKeyHash> history;
+
+	// the pages that were kicked out, oldest first; their histories are dropped once
+	// there are more than numPages of them
+	deque <PageKey> retired;
+
+	// the time of the last (uncorrelated) reference
+	long lastTimeTick;
+
+	size_t numPages;
+	size_t k;
+};
+
+#endif
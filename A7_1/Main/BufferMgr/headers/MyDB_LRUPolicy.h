@@ -0,0 +1,34 @@
+
+#ifndef LRU_POLICY_H
+#define LRU_POLICY_H
+
+#include "CheckLRU.h"
+#include "MyDB_ReplacementPolicy.h"
+#include <set>
+
+// classic LRU, using the time tick of each page
+class MyDB_LRUPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	// numPages is the number of pages in the buffer
+	MyDB_LRUPolicy (size_t numPages);
+
+	void insert (MyDB_PagePtr page) override;
+	void touch (MyDB_PagePtr page) override;
+	void remove (MyDB_PagePtr page) override;
+	MyDB_PagePtr victim () override;
+
+private:
+
+	// tells us the LRU number of each of the pages
+	set <MyDB_PagePtr, CheckLRU> lastUsed;
+
+	// the time tick associated with the MRU page
+	long lastTimeTick;
+
+	// the number of buffer pages
+	size_t numPages;
+};
+
+#endif
@@ -0,0 +1,41 @@
+
+#ifndef LATCH_H
+#define LATCH_H
+
+#include <mutex>
+
+using namespace std;
+
+// a mutex that can be switched off.  The buffer manager only turns its latches on when
+// it is running in concurrent mode, so that a single-threaded program does not pay for
+// any locking.  Can be used with lock_guard and unique_lock
+class MyDB_Latch {
+
+public:
+
+	MyDB_Latch () {
+		enabled = false;
+	}
+
+	// turns the latch on or off; must be called before anyone uses it
+	void setEnabled (bool enabledIn) {
+		enabled = enabledIn;
+	}
+
+	void lock () {
+		if (enabled)
+			myMutex.lock ();
+	}
+
+	void unlock () {
+		if (enabled)
+			myMutex.unlock ();
+	}
+
+private:
+
+	mutex myMutex;
+	bool enabled;
+};
+
+#endif
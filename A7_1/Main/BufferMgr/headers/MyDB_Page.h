@@ -12,6 +12,8 @@
 #ifndef PAGE_H
 #define PAGE_H
 
+#include <atomic>
+#include <list>
 #include <memory>
 #include "MyDB_Table.h"
 #include <string>
@@ -23,13 +25,16 @@ typedef shared_ptr <MyDB_Page> MyDB_PagePtr;
 
 // forward deifnition to handle circular dependencies
 class MyDB_BufferManager;
+class MyDB_AccessStrategy;
+class MyDB_Reservation;
 
 class MyDB_Page {
 
 public:
 
-	// access the raw bytes in this page
-	void *getBytes (MyDB_PagePtr me);
+	// access the raw bytes in this page; if the page has to be read in, and
+	// strategy is not a nullptr, the read goes through the given access strategy
+	void *getBytes (MyDB_AccessStrategy *strategy = nullptr);
 
 	// let the page know that we have written to the bytes
 	void wroteBytes ();
@@ -47,19 +52,6 @@ public:
 	// sets the bytes in the page
 	void setBytes (void *bytes, size_t numBytes);
 
-	// decrements the ref count
-	inline void decRefCount (MyDB_PagePtr me) {
-		refCount--;
-		if (refCount == 0) {
-			killpage (me);
-		}
-	}
-
-	// increments the ref count
-	inline void incRefCount () {
-		refCount++;
-	}
-
 	// get the parent
 	MyDB_BufferManager& getParent ();
 
@@ -68,6 +60,12 @@ private:
 	friend class MyDB_BufferManager;
 	friend class PageComp;
 	friend class CheckLRU;
+	friend class MyDB_LRUPolicy;
+	friend class MyDB_ClockPolicy;
+	friend class MyDB_TwoQPolicy;
+	friend class MyDB_LRUKPolicy;
+	friend class MyDB_Prefetcher;
+	friend class MyDB_PageHandle;
 
 	// a pointer to the raw bytes
 	void *bytes;
@@ -85,17 +83,67 @@ private:
 	// this is a temp page that does not belong to any relation
 	MyDB_TablePtr myTable;
 
+	// the numeric id of myTable (0 for a temp page); this is what the buffer
+	// manager uses to find the page and its file
+	size_t tableId;
+
 	// this is the position of the page in the relation
 	size_t pos;
 
 	// this is the last time that the page had been accessed
 	long timeTick;
 
-	// the number of references
-	int refCount;
-
-	// kill the page
-	void killpage (MyDB_PagePtr me);
+	// the shard's use count when the page was last accessed (zero if it has not been
+	// accessed since it was read in); this is what the warm-start manifest is ranked by
+	long lastUsed;
+
+	// the number of handles to the page; this is atomic so that handles can be
+	// copied and dropped by several threads at once.  It only goes from zero to one
+	// and back with the page's shard latched.  While it is not zero, self holds on
+	// to the page (the handles themselves just point at it)
+	atomic <int> refCount;
+	MyDB_PagePtr self;
+
+	// the shard of the buffer manager that the page lives in, and the FD of its
+	// file; the buffer frame holding the bytes is found from the bytes themselves.
+	// A temp page also has the spill space extent that it is in
+	size_t shard;
+	int fd;
+	size_t extent;
+
+	// the number of the buffer pool whose frames the page is in
+	size_t pool;
+
+	// set on the first page of each run that is read ahead; when the page is
+	// accessed, the next run is requested
+	bool readAheadMark;
+
+	// set while the read-ahead worker is reading the page in, or while the
+	// background writer is writing it out
+	bool readPending;
+	bool writePending;
+
+	// set while a thread that is kicking the page out waits for the background writer
+	// to finish with it; no one may use the page's bytes until it is gone
+	bool evictPending;
+
+	// true if the page is buffered and not pinned, so that it is held by the
+	// replacement policy as a candidate for eviction
+	bool evictable;
+
+	// if the page is pinned through a reservation, the reservation that it counts
+	// against.  This does not keep the reservation alive: once its owner is done
+	// with it, the page just counts as pinned outside of any grant
+	weak_ptr <MyDB_Reservation> reservation;
+
+	// the rest of these are bookkeeping for the various replacement policies:
+	// CLOCK's reference bit, the ring slot (CLOCK) or queue (2Q) that the page
+	// is in, the page's position in that queue (2Q), and the time of the K-th
+	// most recent reference (LRU-K)
+	bool refBit;
+	size_t policySlot;
+	list <MyDB_PagePtr> :: iterator policyPos;
+	long kthRef;
 };
 
 #endif
@@ -0,0 +1,46 @@
+
+#ifndef PAGE_FLUSHER_H
+#define PAGE_FLUSHER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+class MyDB_BufferManager;
+
+// the buffer manager's background writer.  A worker thread wakes up every so often (or
+// when an eviction runs into a dirty page), and if there are fewer clean frames than the
+// target, it writes out the dirty pages that no one has a handle to, so that eviction can
+// usually take a clean page without having to wait for a write
+class MyDB_PageFlusher {
+
+public:
+
+	// starts the worker
+	MyDB_PageFlusher (MyDB_BufferManager &parent);
+
+	// stops the worker
+	~MyDB_PageFlusher ();
+
+	// asks the worker to do a round now
+	void wake ();
+
+private:
+
+	// the worker's main loop
+	void run ();
+
+	MyDB_BufferManager &parent;
+
+	// tells the worker when to do a round, or to quit
+	mutex latch;
+	condition_variable hasWork;
+	bool woken;
+	bool done;
+
+	thread worker;
+};
+
+#endif
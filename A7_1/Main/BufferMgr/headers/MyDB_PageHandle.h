@@ -14,22 +14,23 @@
 #define PAGE_HANDLE_H
 
 #include <memory>
+#include "MyDB_AccessStrategy.h"
 #include "MyDB_Page.h"
 #include "MyDB_Table.h"
 #include <string>
 
-// page handles are basically smart pointers
+// a page handle is a small value that is copied and moved like a smart pointer: it
+// counts itself in the page's reference count (the page stays pinned while any handle
+// to it is around), so making, copying, and dropping handles never allocates
 using namespace std;
-class MyDB_PageHandleBase;
-typedef shared_ptr <MyDB_PageHandleBase> MyDB_PageHandle;
 
-class MyDB_PageHandleBase {
+class MyDB_PageHandle {
 
 public:
 
 	// access the raw bytes in this page
 	void *getBytes () {
-		return page->getBytes (page);
+		return page->getBytes (strategy.get ());
 	}
 
 	// let the page know that we have written to the bytes.  Must always
@@ -40,33 +41,112 @@ public:
 		page->wroteBytes ();
 	}
 
-	// There are no more references to the handle when this is called...
-	// this should decrmeent a reference count to the number of handles
-	// to the particular page that it references.  If the number of 
-	// references to a pinned page goes down to zero, then the page should
-	// become unpinned.  
-	~MyDB_PageHandleBase () {
-		page->decRefCount (page);
+	// a handle is used just like the shared pointer that it replaced, so that
+	// handle->getBytes () and so on still work
+	MyDB_PageHandle *operator -> () {
+		return this;
+	}
+
+	// a handle that does not refer to any page
+	MyDB_PageHandle () {
+		page = nullptr;
+	}
+
+	MyDB_PageHandle (nullptr_t) {
+		page = nullptr;
+	}
+
+	MyDB_PageHandle (const MyDB_PageHandle &copyMe) : strategy (copyMe.strategy) {
+		page = copyMe.page;
+		if (page != nullptr)
+			page->refCount++;
+	}
+
+	MyDB_PageHandle (MyDB_PageHandle &&moveMe) : strategy (move (moveMe.strategy)) {
+		page = moveMe.page;
+		moveMe.page = nullptr;
+	}
+
+	MyDB_PageHandle &operator = (const MyDB_PageHandle &copyMe) {
+		if (copyMe.page != nullptr)
+			copyMe.page->refCount++;
+		release ();
+		page = copyMe.page;
+		strategy = copyMe.strategy;
+		return *this;
+	}
+
+	MyDB_PageHandle &operator = (MyDB_PageHandle &&moveMe) {
+		if (this != &moveMe) {
+			release ();
+			page = moveMe.page;
+			moveMe.page = nullptr;
+			strategy = move (moveMe.strategy);
+		}
+		return *this;
+	}
+
+	MyDB_PageHandle &operator = (nullptr_t) {
+		release ();
+		strategy = nullptr;
+		return *this;
+	}
+
+	bool operator == (nullptr_t) const {
+		return page == nullptr;
+	}
+
+	bool operator != (nullptr_t) const {
+		return page != nullptr;
+	}
+
+	explicit operator bool () const {
+		return page != nullptr;
 	}
 
-	// sets up the page...
-	MyDB_PageHandleBase (MyDB_PagePtr useMe) {
-		page = useMe;
-		page->incRefCount ();
+	// There are no more references to the handle when this is called...
+	// this decrements the number of handles to the particular page that it
+	// references.  If the number of references to a pinned page goes down
+	// to zero, then the page becomes unpinned.  
+	~MyDB_PageHandle () {
+		release ();
 	}
 
 private:
 
 	friend class MyDB_PageReaderWriter;
+	friend class MyDB_BufferManager;
+
+	// sets up the page; this is only done by the buffer manager, with the page's
+	// shard latched (or for a temp page that no one else can see yet)
+	explicit MyDB_PageHandle (const MyDB_PagePtr &useMe);
+
+	// drops this handle's reference.  Only the last reference has to go to the buffer
+	// manager (and latch the page's shard); the others just decrement the count
+	inline void release () {
+		if (page == nullptr)
+			return;
+		int count = page->refCount.load ();
+		while (count > 1) {
+			if (page->refCount.compare_exchange_weak (count, count - 1)) {
+				page = nullptr;
+				return;
+			}
+		}
+		releaseLast ();
+	}
+
+	void releaseLast ();
 
 	// get the buffer manager
 	MyDB_BufferManager &getParent () {
 		return page->getParent ();
 	}
 
-	friend class CheckLRU;
-	friend class MyDB_BufferManager;
-	MyDB_PagePtr page;
+	MyDB_Page *page;
+
+	// if not a nullptr, the page is read in through this strategy
+	MyDB_AccessStrategyPtr strategy;
 };
 
 #endif
@@ -0,0 +1,72 @@
+
+#ifndef PAGE_TABLE_H
+#define PAGE_TABLE_H
+
+#include <functional>
+#include "MyDB_Page.h"
+#include <vector>
+
+using namespace std;
+
+// this is the buffer manager's index of all of the page objects that are currently
+// in existence.  It is an open-addressing (linear probing) hash table keyed on the
+// pair (table id, page number), so that a page lookup is a couple of integer
+// compares, no matter how long the table's name is.  Temp pages use table id 0.
+class MyDB_PageTable {
+
+public:
+
+	// creates an empty table
+	MyDB_PageTable ();
+
+	// returns the page stored for the given key, or a nullptr if there is none
+	MyDB_PagePtr find (size_t tableId, size_t pos);
+
+	// returns a reference to the slot for the given key, creating an empty slot
+	// (holding a nullptr) if the key is not there.  This lets the caller do a
+	// lookup-or-create with a single probe sequence.  The reference is only good
+	// until the next call to findOrInsert or erase
+	MyDB_PagePtr &findOrInsert (size_t tableId, size_t pos);
+
+	// removes the key from the table; returns false if it was not there
+	bool erase (size_t tableId, size_t pos);
+
+	// the number of pages in the table
+	size_t size ();
+
+	// calls the given function on every page in the table
+	void forEach (function <void (MyDB_PagePtr &)> f);
+
+private:
+
+	// one entry in the table
+	struct Slot {
+		size_t tableId;
+		size_t pos;
+		MyDB_PagePtr page;
+		bool used;
+	};
+
+	// hashes the key
+	inline size_t hash (size_t tableId, size_t pos) {
+		size_t h = (tableId * 0x9E3779B97F4A7C15ULL) ^ (pos + 0x632BE59BD9B4E019ULL + (tableId << 6));
+		h ^= h >> 29;
+		h *= 0xBF58476D1CE4E5B9ULL;
+		h ^= h >> 32;
+		return h & mask;
+	}
+
+	// doubles the number of slots and re-inserts everything
+	void grow ();
+
+	// all of the slots; the size is always a power of two
+	vector <Slot> slots;
+
+	// slots.size () - 1
+	size_t mask;
+
+	// the number of used slots
+	size_t numUsed;
+};
+
+#endif
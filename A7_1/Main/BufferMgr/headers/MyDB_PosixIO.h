@@ -0,0 +1,19 @@
+
+#ifndef POSIX_IO_H
+#define POSIX_IO_H
+
+#include "MyDB_IOBackend.h"
+
+// the baseline backend: a pread/pwrite per page, and a preadv/pwritev per request, done
+// one after another by the calling thread
+class MyDB_PosixIO : public MyDB_IOBackend {
+
+public:
+
+	void read (int fd, void *bytes, size_t len, off_t offset) override;
+	void write (int fd, void *bytes, size_t len, off_t offset) override;
+	void readBatch (vector <MyDB_IORequest> &requests) override;
+	void writeBatch (vector <MyDB_IORequest> &requests) override;
+};
+
+#endif
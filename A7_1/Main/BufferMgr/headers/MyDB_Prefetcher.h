@@ -0,0 +1,98 @@
+
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <condition_variable>
+#include <deque>
+#include "MyDB_Page.h"
+#include "MyDB_PageHandle.h"
+#include "MyDB_Table.h"
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class MyDB_BufferManager;
+
+// one run of pages to be read ahead: the pages first, first + 1, ... of the file fd,
+// along with a handle to each page (so that the pages stay alive) and the buffer frame
+// that each page is to be read into
+struct MyDB_ReadAheadRequest {
+	int fd;
+	size_t first;
+	vector <MyDB_PageHandle> handles;
+	vector <size_t> frames;
+};
+
+// the buffer manager's read-ahead subsystem.  It watches the page misses on each table,
+// and when it sees a table being read sequentially, it asks for the next window of pages.
+// The buffer manager then sets aside frames for the window (this is done by the thread
+// that is scanning, inside of its own call to the buffer manager, so that the worker never
+// kicks out a page that some caller has just been handed the bytes of) and hands the
+// request to the worker thread, which hands all of the waiting windows to the I/O backend
+// at once, each window as one vectored read.  The first page of each window that is read
+// ahead is marked; when the scan gets to it, the window after that one is requested, so
+// the worker stays about one window ahead
+class MyDB_Prefetcher {
+
+public:
+
+	// starts the worker; window is the number of pages to read ahead
+	MyDB_Prefetcher (MyDB_BufferManager &parent, size_t window);
+
+	// stops the worker, dropping any requests that have not been started
+	~MyDB_Prefetcher ();
+
+	// tells the prefetcher that the given page had to be read from disk; returns true
+	// if the pages first ... first + count - 1 should be read ahead
+	bool noteMiss (MyDB_PagePtr page, size_t &first, size_t &count);
+
+	// tells the prefetcher that the scan reached a page with a read-ahead mark; returns
+	// true if the pages first ... first + count - 1 should be read ahead
+	bool noteMarkedHit (MyDB_PagePtr page, size_t &first, size_t &count);
+
+	// gives a request to the worker; returns false (and does not take the request)
+	// if the worker is too far behind
+	bool submit (MyDB_ReadAheadRequest &request);
+
+	// the most pages that can have been read ahead of a scan, but not yet reached
+	size_t reach ();
+
+private:
+
+	// what we know about the reads on one table
+	struct TableState {
+		size_t lastMiss;
+		size_t prefetchedTo;
+		TableState () {
+			lastMiss = (size_t) -1;
+			prefetchedTo = 0;
+		}
+	};
+
+	// figures out the count for a window starting at first, cut off at the end of the
+	// table; must be called with the latch held.  Returns false if there is nothing
+	bool window (MyDB_TablePtr table, TableState &state, size_t first, size_t &count);
+
+	// the worker's main loop
+	void run ();
+
+	MyDB_BufferManager &parent;
+	size_t windowSize;
+
+	// the state for each table, indexed by table id
+	vector <TableState> tables;
+
+	// the requests that the worker has not gotten to yet
+	deque <MyDB_ReadAheadRequest> requests;
+
+	// protects everything above, and tells the worker when there is work
+	mutex latch;
+	condition_variable hasWork;
+	bool done;
+
+	thread worker;
+};
+
+#endif
@@ -0,0 +1,42 @@
+
+#ifndef REPLACEMENT_POLICY_H
+#define REPLACEMENT_POLICY_H
+
+#include <memory>
+#include "MyDB_Page.h"
+
+using namespace std;
+
+// the page replacement policies that the buffer manager knows about
+enum MyDB_ReplacementType {LRUReplacement, ClockReplacement, TwoQReplacement, LRUKReplacement};
+
+class MyDB_ReplacementPolicy;
+typedef shared_ptr <MyDB_ReplacementPolicy> MyDB_ReplacementPolicyPtr;
+
+// this is the interface that the buffer manager uses to decide which page to kick out.
+// The policy only ever sees the "candidate" pages: those that are buffered in RAM and
+// not pinned.  The buffer manager keeps track of which pages are candidates (using the
+// page's evictable flag), so a policy never gets a remove or a touch for a page that
+// it does not hold, and never gets an insert for a page that it already holds
+class MyDB_ReplacementPolicy {
+
+public:
+
+	// called when the page becomes a candidate for eviction, either because it was just
+	// read into RAM or because it was just unpinned; this counts as a reference
+	virtual void insert (MyDB_PagePtr page) = 0;
+
+	// called on every access to a page that is a candidate
+	virtual void touch (MyDB_PagePtr page) = 0;
+
+	// called when the page stops being a candidate (it was pinned or killed)
+	virtual void remove (MyDB_PagePtr page) = 0;
+
+	// chooses the page to evict and removes it from the policy; returns a nullptr if
+	// there are no candidates
+	virtual MyDB_PagePtr victim () = 0;
+
+	virtual ~MyDB_ReplacementPolicy () {}
+};
+
+#endif
@@ -0,0 +1,60 @@
+
+#ifndef RESERVATION_H
+#define RESERVATION_H
+
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+class MyDB_BufferManager;
+class MyDB_Reservation;
+typedef shared_ptr <MyDB_Reservation> MyDB_ReservationPtr;
+
+// a grant of some of the buffer's frames to one query (or one operator), made by
+// MyDB_BufferManager :: reserve ().  The pages pinned through the grant count against
+// it; once it is used up, pinning through it fails (rather than taking frames that
+// belong to someone else) until one of its pages is unpinned, or until the grant is
+// grown.  The frames go back to the buffer manager when the grant is destroyed, which
+// has to happen before the buffer manager is destroyed; any of its pages that are still
+// pinned then stay pinned, as ordinary pinned pages
+class MyDB_Reservation {
+
+public:
+
+	// the number of frames granted, and the number of them that are pinned now
+	size_t getNumFrames ();
+	size_t getNumPinned ();
+
+	// the number of granted frames that are not pinned
+	size_t getNumLeft ();
+
+	// asks for numMore more frames; returns false (and leaves the grant as it was) if
+	// the buffer manager cannot give that many
+	bool grow (size_t numMore);
+
+	// gives the frames back
+	~MyDB_Reservation ();
+
+private:
+
+	friend class MyDB_BufferManager;
+
+	MyDB_Reservation (MyDB_BufferManager &parent, size_t numFrames);
+
+	// counts one more pinned page against the grant; returns false if the grant is
+	// used up
+	bool charge ();
+
+	// one pinned page was unpinned
+	void uncharge ();
+
+	MyDB_BufferManager &parent;
+
+	// the frames granted, and the pages pinned against them; numFrames only
+	// changes under the buffer manager's reservation latch
+	atomic <size_t> numFrames;
+	atomic <size_t> numPinned;
+};
+
+#endif
@@ -0,0 +1,123 @@
+
+#ifndef SHARED_POOL_H
+#define SHARED_POOL_H
+
+#include <functional>
+#include "MyDB_IOBackend.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the most files that the processes sharing a pool can have pages of, and the longest
+// path that one of those files can have
+#define MAX_SHARED_FILES 256
+#define MAX_SHARED_PATH 256
+
+struct MyDB_SharedPoolHeader;
+struct MyDB_SharedFile;
+struct MyDB_SharedFrame;
+
+class MyDB_SharedPool;
+typedef shared_ptr <MyDB_SharedPool> MyDB_SharedPoolPtr;
+
+// a buffer pool in a POSIX shared memory segment, which any number of processes can
+// attach to, so that they share one cache of the tables' pages instead of each keeping
+// a copy of the same hot pages.  The segment holds the frames, a hash table from (file,
+// page number) to frame, and a CLOCK replacement policy, all protected by one process-
+// shared latch.  Files are known by their device and inode, so the processes do not
+// have to agree on anything but the segment's name.  A page is pinned while any
+// process is using it; the pages that no one is using stay in the pool until CLOCK
+// picks them, at which point the process that needs the frame writes them back (if
+// they are dirty).  The last process to detach writes back everything and removes the
+// segment.  A process that dies while it has pages pinned leaves them pinned
+class MyDB_SharedPool {
+
+public:
+
+	// attaches to the pool with the given name (which should start with a "/"), creating
+	// it with numFrames frames of pageSize bytes if no process has it; a pool that
+	// already exists keeps the size that it was created with, but it must have the same
+	// page size.  io moves the pages to and from the files, and opener opens a file
+	// (returning -1 if it cannot), for writing back a page of a file that this process
+	// has not opened itself
+	MyDB_SharedPool (string name, size_t pageSize, size_t numFrames, MyDB_IOBackendPtr io,
+		function <int (string)> opener);
+
+	// detaches from the pool
+	~MyDB_SharedPool ();
+
+	// lets the pool know that the given FD (which this process opened) is the given file
+	void addFile (int fd, string path);
+
+	// pins the page at position pos of the file with the given FD, reading it in if it is
+	// not in the pool; hit is set to true if it was.  Returns the page's bytes, or a
+	// nullptr if every frame is pinned
+	void *pin (int fd, size_t pos, bool &hit);
+
+	// drops one pin on the page with the given bytes; dirty is true if the page was
+	// written to while it was pinned
+	void unpin (void *bytes, bool dirty);
+
+	// true if the bytes are in one of the pool's frames
+	bool holds (void *bytes);
+
+	// the number of frames, and the number of processes attached now
+	size_t getNumFrames ();
+	size_t getNumAttached ();
+
+private:
+
+	// latch and unlatch the pool; if a process died while it had the latch, the latch
+	// is just taken over
+	void lock ();
+	void unlock ();
+
+	// waits for some process to finish reading or writing a page; the pool is latched
+	void waitForIO ();
+
+	// the frame holding the given page, or -1 if it is not in the pool; and adds the
+	// frame to / takes it off of its hash chain
+	long find (long file, size_t pos);
+	void hashIn (long frame);
+	void hashOut (long frame);
+
+	// finds a frame that no one has pinned, giving each page a second chance; -1 if
+	// there is none
+	long victim ();
+
+	// this process' FD for a file of the pool, opening it if need be
+	int fdOf (long file);
+
+	// writes back every dirty page
+	void writeBackAll ();
+
+	inline char *frameBytes (long frame) {
+		return arena + frame * pageSize;
+	}
+
+	// the segment's name, and where its parts are mapped
+	string name;
+	char *segment;
+	size_t segmentSize;
+	MyDB_SharedPoolHeader *header;
+	MyDB_SharedFile *files;
+	long *buckets;
+	MyDB_SharedFrame *frames;
+	char *arena;
+	size_t pageSize;
+
+	MyDB_IOBackendPtr io;
+	function <int (string)> opener;
+
+	// this process' FDs: the pool's file number for each FD that it was told about, and
+	// the FD for each of the pool's files (-1 if it has not been opened); the FDs that
+	// the pool opened itself are closed when it detaches.  These are protected by the
+	// pool's latch
+	vector <long> fileOfFd;
+	vector <int> fdOfFile;
+	vector <int> openedFds;
+};
+
+#endif
@@ -0,0 +1,127 @@
+
+#ifndef SPILL_SPACE_H
+#define SPILL_SPACE_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// where a temp page lives: the extent it is in, its position (in pages) in the extent's
+// file, and that file's FD
+struct MyDB_SpillSlot {
+	size_t extent;
+	size_t pos;
+	int fd;
+};
+
+// the state of a run of temp pages that are written (and later read) in order; each
+// page of the run goes into the next slot of the run's current extent
+struct MyDB_SpillCursor {
+
+	// true if the cursor has an extent, and the next slot in it
+	bool open;
+	size_t extent;
+	size_t next;
+
+	MyDB_SpillCursor () {
+		open = false;
+		extent = 0;
+		next = 0;
+	}
+};
+
+// the space that temp pages are spilled to.  This is one or more temp files (possibly in
+// several directories, so that big sorts and joins do not all fight over one disk), cut
+// up into extents of extentPages pages.  A new extent is taken from the files round-robin,
+// and its space is preallocated with fallocate.  A run of pages (see MyDB_TempRun) fills
+// a whole extent before going on to the next one, so that a sorted run can be read back
+// sequentially; temp pages that are not part of a run share extents,
+// and re-use each other's slots.  Once all of the pages in an extent are freed, its disk
+// space is given back to the file system by punching a hole, and the extent goes back on
+// its file's free list.  This is not latched; the buffer manager latches it
+class MyDB_SpillSpace {
+
+public:
+
+	// sets up the temp files at the given paths; opener is used to create each file (and
+	// returns its FD, or -1 if it cannot)
+	MyDB_SpillSpace (vector <string> paths, size_t pageSize, size_t extentPages, function <int (string)> opener);
+
+	// closes and deletes the temp files
+	~MyDB_SpillSpace ();
+
+	// gets a slot for a new temp page: the next slot of the cursor's extent, or (if
+	// the cursor is a nullptr) a slot shared with the other pages that are not in a run
+	void allocate (MyDB_SpillCursor *cursor, MyDB_SpillSlot &slot);
+
+	// the page in the slot is gone
+	void release (MyDB_SpillSlot &slot);
+
+	// the run that the cursor belongs to will not get any more pages
+	void close (MyDB_SpillCursor &cursor);
+
+	// the number of extents that are in use now, and the number whose space has been
+	// given back to the file system (which resetNumReleased zeroes)
+	size_t getNumInUse ();
+	size_t getNumReleased ();
+	void resetNumReleased ();
+
+private:
+
+	struct MyDB_SpillFile {
+		string path;
+		int fd;
+
+		// the number of extents that the file has been grown to, and the ones that
+		// are free
+		size_t numExtents;
+		vector <size_t> freeExtents;
+
+		// false once the file system has said that it cannot preallocate space / punch
+		// holes in the file
+		bool canPreallocate;
+		bool canPunch;
+	};
+
+	struct MyDB_Extent {
+
+		// the file that the extent is in, and its first page in the file
+		size_t file;
+		size_t first;
+
+		// the number of pages in the extent, and whether a cursor is still filling it
+		size_t live;
+		bool open;
+
+		// true if the extent holds pages that are not in a run; those re-use the
+		// slots that are freed up
+		bool shared;
+		vector <size_t> freeSlots;
+	};
+
+	// gets a free extent, growing a file if need be
+	size_t newExtent ();
+
+	// gives the extent's disk space back, and puts it on the free list
+	void releaseExtent (size_t extent);
+
+	vector <MyDB_SpillFile> files;
+	vector <MyDB_Extent> extents;
+	size_t pageSize;
+	size_t extentPages;
+
+	// the file that the next new extent comes from
+	size_t nextFile;
+
+	// the cursor used for pages that are not in a run, and the shared extents that have
+	// freed slots (this may have extents that have since been released or filled up)
+	MyDB_SpillCursor sharedCursor;
+	vector <size_t> sharedWithFree;
+
+	size_t numInUse;
+	size_t numReleased;
+};
+
+#endif
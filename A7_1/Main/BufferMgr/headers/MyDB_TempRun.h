@@ -0,0 +1,39 @@
+
+#ifndef TEMP_RUN_H
+#define TEMP_RUN_H
+
+#include <memory>
+#include "MyDB_SpillSpace.h"
+
+using namespace std;
+
+class MyDB_BufferManager;
+class MyDB_TempRun;
+typedef shared_ptr <MyDB_TempRun> MyDB_TempRunPtr;
+
+// a run of temp pages that are written one after another, and later read back in the
+// same order (a sorted run, say), made by MyDB_BufferManager :: startTempRun ().  The
+// run's pages are put next to each other in the temp files, an extent at a time, so
+// that reading the run back is sequential.  The run must only be used by one thread at
+// a time, and it has to be destroyed before the buffer manager is; its pages can live
+// on after it is gone
+class MyDB_TempRun {
+
+public:
+
+	// the run will not get any more pages
+	~MyDB_TempRun ();
+
+private:
+
+	friend class MyDB_BufferManager;
+
+	MyDB_TempRun (MyDB_BufferManager &parent);
+
+	MyDB_BufferManager &parent;
+
+	// where the run's next page goes
+	MyDB_SpillCursor cursor;
+};
+
+#endif
@@ -0,0 +1,55 @@
+
+#ifndef TWO_Q_POLICY_H
+#define TWO_Q_POLICY_H
+
+#include <list>
+#include "MyDB_ReplacementPolicy.h"
+#include <unordered_map>
+#include <utility>
+
+// the 2Q policy (Johnson and Shasha).  A page that is read in for the first time goes
+// into the FIFO queue A1in, and a hit there does not move it.  When a page is kicked
+// out of A1in, its key is remembered in the "ghost" queue A1out.  If the page is read
+// in again while its key is still in A1out, then it has proven that it is re-used, and
+// it goes into the LRU queue Am.  A long sequential scan thus only ever cycles through
+// A1in, and cannot push the hot pages (B+-tree directory pages, etc.) out of Am
+class MyDB_TwoQPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	// numPages is the number of pages in the buffer; A1in gets a quarter of them, and
+	// A1out remembers the keys for half as many pages as there are in the buffer
+	MyDB_TwoQPolicy (size_t numPages);
+
+	void insert (MyDB_PagePtr page) override;
+	void touch (MyDB_PagePtr page) override;
+	void remove (MyDB_PagePtr page) override;
+	MyDB_PagePtr victim () override;
+
+private:
+
+	// a page is identified by (table id, page number)
+	typedef pair <size_t, size_t> PageKey;
+	struct PageKeyHash {
+		size_t operator() (const PageKey &key) const {
+			return (key.first * 0x9E3779B97F4A7C15ULL) ^ key.second;
+		}
+	};
+
+	// the values stored in a page's policySlot
+	enum Queue {A1in, Am};
+
+	// the two queues of resident pages; the front is the most recent end
+	list <MyDB_PagePtr> a1in;
+	list <MyDB_PagePtr> am;
+
+	// the ghost queue, and an index into it
+	list <PageKey> a1out;
+	unordered_map <PageKey, list <PageKey> :: iterator, PageKeyHash> a1outIndex;
+
+	// the target size of A1in, and the max size of A1out
+	size_t kin;
+	size_t kout;
+};
+
+#endif
@@ -13,79 +13,460 @@
 #ifndef BUFFER_MGR_C
 #define BUFFER_MGR_C
 
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <cstdio>
 #include <fcntl.h>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include "MyDB_BufferManager.h"
+#include "MyDB_ClockPolicy.h"
+#include "MyDB_IOUring.h"
+#include "MyDB_LRUKPolicy.h"
+#include "MyDB_LRUPolicy.h"
 #include "MyDB_Page.h"
+#include "MyDB_PosixIO.h"
+#include "MyDB_TwoQPolicy.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
+#include <limits.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <utility>
 
 using namespace std;
 
+// the number of dirty pages that eviction passes over looking for a clean one, when there
+// is a background writer
+#define MAX_DIRTY_SKIPS 8
+
+// a table that is bigger than 1 / BULK_READ_FRACTION of the buffer is scanned through a
+// ring of BULK_READ_RING frames (or more, if there is read-ahead)
+#define BULK_READ_FRACTION 4
+#define BULK_READ_RING 16
+
+// direct I/O has to be done in blocks that are aligned to this many bytes; the frames are
+// aligned to it when the page size is a multiple of it, since the buffer pool is page aligned
+#define DIRECT_IO_ALIGN 4096
+
+// reservations are never granted the last numPages / UNRESERVED_FRACTION frames (and never
+// the last MIN_UNRESERVED frames), so that there is always room to read unpinned pages
+#define UNRESERVED_FRACTION 8
+#define MIN_UNRESERVED 2
+
+// the first line of a warm-start manifest
+#define WARM_START_HEADER "MyDB buffer manifest 1"
+
+// the size of a huge page, which the buffer pool is rounded up to when it is put on them
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// the number of microseconds since the given time
+static inline size_t microsSince (chrono :: steady_clock :: time_point start) {
+	return chrono :: duration_cast <chrono :: microseconds> (chrono :: steady_clock :: now () - start).count ();
+}
+
 size_t MyDB_BufferManager :: getPageSize () {
 	return pageSize;
 }
 
-MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i) {
-		
-	// open the file, if it is not open
-	if (fds.count (whichTable) == 0) {
-		int fd = open (whichTable->getStorageLoc ().c_str (), O_CREAT | O_RDWR, 0666);
-		fds[whichTable] = fd;
+size_t MyDB_BufferManager :: shardOf (size_t tableId, size_t pos) {
+	if (shards.size () == 1)
+		return 0;
+	size_t h = (pos * 0x9E3779B97F4A7C15ULL) ^ (tableId * 0xBF58476D1CE4E5B9ULL);
+	return (h >> 32) % shards.size ();
+}
+
+int MyDB_BufferManager :: getFd (size_t tableId, MyDB_TablePtr whichTable, size_t &pool) {
+
+	lock_guard <MyDB_Latch> guard (fdLatch);
+
+	// make room for the id, if we have never seen it
+	if (tableId >= fds.size ()) {
+		fds.resize (tableId + 1, -1);
+		tablePools.resize (tableId + 1, 0);
+	}
+
+	// open the file, if it is not open, and see which pool the table is in
+	if (fds[tableId] == -1) {
+		if (tableId >= tableNames.size ())
+			tableNames.resize (tableId + 1);
+		tableNames[tableId] = whichTable->getName ();
+		fds[tableId] = openFile (whichTable->getStorageLoc (), O_CREAT | O_RDWR);
+		if (sharedPool != nullptr)
+			sharedPool->addFile (fds[tableId], whichTable->getStorageLoc ());
+		auto named = namedTablePools.find (whichTable->getName ());
+		tablePools[tableId] = (named == namedTablePools.end ()) ? 0 : named->second;
+	}
+
+	pool = tablePools[tableId];
+	return fds[tableId];
+}
+
+int MyDB_BufferManager :: openFile (string fName, int flags) {
+
+	if (!directIO)
+		return open (fName.c_str (), flags, 0666);
+
+#ifdef O_DIRECT
+	// some file systems refuse O_DIRECT when the file is opened, and some only when it
+	// is read, so we also try reading the first block
+	int fd = open (fName.c_str (), flags | O_DIRECT, 0666);
+	if (fd != -1) {
+		void *block;
+		if (posix_memalign (&block, DIRECT_IO_ALIGN, DIRECT_IO_ALIGN) != 0)
+			return fd;
+		ssize_t res = pread (fd, block, DIRECT_IO_ALIGN, 0);
+		free (block);
+		if (res != -1 || errno != EINVAL)
+			return fd;
+		close (fd);
+	}
+
+	// no direct I/O here, so use the OS cache
+	return open (fName.c_str (), flags, 0666);
+#else
+	// on OS X, the closest thing is to turn off caching for the file
+	int fd = open (fName.c_str (), flags, 0666);
+#ifdef F_NOCACHE
+	if (fd != -1)
+		fcntl (fd, F_NOCACHE, 1);
+#endif
+	return fd;
+#endif
+}
+
+void MyDB_BufferManager :: readPage (MyDB_PagePtr page) {
+	chrono :: steady_clock :: time_point start = chrono :: steady_clock :: now ();
+	io->read (page->fd, page->bytes, pageSize, page->pos * pageSize);
+	readLatency.record (microsSince (start));
+}
+
+void MyDB_BufferManager :: writePage (MyDB_PagePtr page) {
+	chrono :: steady_clock :: time_point start = chrono :: steady_clock :: now ();
+	io->write (page->fd, page->bytes, pageSize, page->pos * pageSize);
+	writeLatency.record (microsSince (start));
+}
+
+void MyDB_BufferManager :: writePages (vector <MyDB_PagePtr> &pages) {
+
+	sort (pages.begin (), pages.end (), [] (const MyDB_PagePtr &lhs, const MyDB_PagePtr &rhs) {
+		if (lhs->fd != rhs->fd)
+			return lhs->fd < rhs->fd;
+		return lhs->pos < rhs->pos;
+	});
+
+	// now make one request for each run of adjacent pages
+	vector <MyDB_IORequest> requests;
+	for (size_t i = 0; i < pages.size (); i += requests.back ().iov.size ()) {
+		requests.push_back (MyDB_IORequest ());
+		MyDB_IORequest &request = requests.back ();
+		request.fd = pages[i]->fd;
+		request.offset = pages[i]->pos * pageSize;
+		while (i + request.iov.size () < pages.size () && request.iov.size () < IOV_MAX) {
+			MyDB_PagePtr next = pages[i + request.iov.size ()];
+			if (request.iov.size () > 0 && (next->fd != pages[i]->fd || next->pos != pages[i]->pos + request.iov.size ()))
+				break;
+			struct iovec one;
+			one.iov_base = next->bytes;
+			one.iov_len = pageSize;
+			request.iov.push_back (one);
+		}
+	}
+	if (requests.size () == 0)
+		return;
+	chrono :: steady_clock :: time_point start = chrono :: steady_clock :: now ();
+	io->writeBatch (requests);
+	writeLatency.record (microsSince (start));
+}
+
+void MyDB_BufferManager :: flushDirtyPages () {
+
+	// count the clean frames, and find the dirty pages that we can write; a page that
+	// someone has a handle to may be in the middle of being written to, so we leave it
+	size_t numClean = freeFrames.size ();
+	vector <MyDB_PagePtr> toWrite;
+	for (auto &shard : shards) {
+		lock_guard <MyDB_Latch> guard (shard->latch);
+		shard->allPages.forEach ([&] (MyDB_PagePtr &page) {
+			if (!page->evictable || page->refCount != 0 || page->writePending)
+				return;
+			if (page->isDirty)
+				toWrite.push_back (page);
+			else
+				numClean++;
+		});
+	}
+
+	if (numClean >= cleanTarget || toWrite.size () == 0)
+		return;
+
+	// mark the pages, so that no one gets a handle to them (or kicks them out) while
+	// we are writing them; things may have changed since we looked, so check again
+	vector <MyDB_PagePtr> marked;
+	for (auto &page : toWrite) {
+		lock_guard <MyDB_Latch> guard (shards[page->shard]->latch);
+		if (page->evictable && page->refCount == 0 && page->isDirty && !page->writePending) {
+			page->writePending = true;
+			marked.push_back (page);
+		}
+	}
+
+	writePages (marked);
+
+	// and they are clean
+	for (auto &page : marked) {
+		MyDB_BufferShard &shard = *shards[page->shard];
+		lock_guard <MyDB_Latch> guard (shard.latch);
+		page->isDirty = false;
+		page->writePending = false;
+		shard.numWriteBacks++;
+		shard.ioDone.notify_all ();
 	}
+}
 
+MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i) {
+		
 	// make sure we don't have a null table
 	if (whichTable == nullptr) {
 		cout << "Can't allocate a page with a null table!!\n";
 		exit (1);
 	}
-	
-	// next, see if the page is already in existence
-	pair <MyDB_TablePtr, long> whichPage = make_pair (whichTable, i);
-	if (allPages.count (whichPage) == 0) {
 
-		// it is not there, so create a page
+	// open the file, if it is not open
+	size_t tableId = whichTable->getId (), pool;
+	int fd = getFd (tableId, whichTable, pool);
+	size_t whichShard = shardOf (tableId, i);
+	MyDB_BufferShard &shard = *shards[whichShard];
+	unique_lock <MyDB_Latch> guard (shard.latch);
+	
+	// next, see if the page is already in existence; if it is not, create it
+	MyDB_PagePtr &slot = shard.allPages.findOrInsert (tableId, i);
+	if (slot == nullptr) {
 		//cout << "Didn't find it\n";
-		MyDB_PagePtr returnVal = make_shared <MyDB_Page> (whichTable, i, *this);
-		allPages [whichPage] = returnVal;
-		return make_shared <MyDB_PageHandleBase> (returnVal);
+		slot = make_shared <MyDB_Page> (whichTable, i, *this);
+		slot->shard = whichShard;
+		slot->fd = fd;
+		slot->pool = pool;
 	}
 
-	// it is there, so return it
-	return make_shared <MyDB_PageHandleBase> (allPages [whichPage]);
+	// if the background writer is writing the page, we cannot let anyone at it yet
+	MyDB_PagePtr returnVal = slot;
+	while (returnVal->writePending)
+		shard.ioDone.wait (guard);
+
+	return MyDB_PageHandle (returnVal);
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i, MyDB_AccessStrategyPtr strategy) {
+	MyDB_PageHandle returnVal = getPage (whichTable, i);
+	returnVal.strategy = strategy;
+	return returnVal;
+}
+
+MyDB_AccessStrategyPtr MyDB_BufferManager :: getBulkReadStrategy (MyDB_TablePtr whichTable) {
+
+	// the pages of a shared buffer are not recycled by this process
+	if (sharedPool != nullptr)
+		return nullptr;
+
+	// a table that takes up less than a quarter of the buffer can just be buffered
+	size_t limit = numPages / BULK_READ_FRACTION;
+	if (whichTable == nullptr || whichTable->lastPage () < 0 || (size_t) whichTable->lastPage () + 1 <= limit)
+		return nullptr;
+
+	// the ring has to be big enough to hold everything that is read ahead of the scan,
+	// or the scan would recycle pages before it gets to them
+	size_t ringSize = BULK_READ_RING;
+	if (prefetcher != nullptr && prefetcher->reach () + 1 > ringSize)
+		ringSize = prefetcher->reach () + 1;
+	if (ringSize > limit)
+		ringSize = limit;
+	return make_shared <MyDB_AccessStrategy> (ringSize);
 }
 
 MyDB_PageHandle MyDB_BufferManager :: getPage () {
+	return getPage (nullptr);
+}
 
-	// open the file, if it is not open
-	if (fds.count (nullptr) == 0) {
-		int fd = open (tempFile.c_str (), O_TRUNC | O_CREAT | O_RDWR, 0666);
-		fds[nullptr] = fd;
+MyDB_TempRunPtr MyDB_BufferManager :: startTempRun () {
+	return MyDB_TempRunPtr (new MyDB_TempRun (*this));
+}
+
+void MyDB_BufferManager :: endTempRun (MyDB_TempRun &run) {
+	lock_guard <MyDB_Latch> guard (tempLatch);
+	spill->close (run.cursor);
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TempRunPtr run) {
+
+	// find a place in the temp files for the page
+	MyDB_SpillSlot slot;
+	{
+		lock_guard <MyDB_Latch> guard (tempLatch);
+		spill->allocate ((run == nullptr) ? nullptr : &run->cursor, slot);
+		numTempAllocations++;
 	}
 
-	// check if we are extending the size of the temp file
-	size_t pos;
-	if (availablePositions.size () == 0) {
-		pos = lastTempPos++;
-	} else {
-		pos = availablePositions.top ();
-		availablePositions.pop ();
+	// no one else can see this page yet, so there is no need to latch its shard
+	MyDB_PagePtr returnVal = make_shared <MyDB_Page> (nullptr, slot.pos, *this);
+	returnVal->shard = shardOf (0, slot.pos);
+	returnVal->fd = slot.fd;
+	returnVal->extent = slot.extent;
+	returnVal->pool = tempPool;
+	return MyDB_PageHandle (returnVal);
+}
+
+void MyDB_BufferManager :: makeEvictable (MyDB_BufferShard &shard, MyDB_PagePtr page) {
+	releasePage (page);
+	if (!page->evictable) {
+		page->evictable = true;
+		numEvictable++;
+		shard.policies[page->pool]->insert (page);
 	}
+}
 
-	MyDB_PagePtr returnVal = make_shared <MyDB_Page> (nullptr, pos, *this);
-	return make_shared <MyDB_PageHandleBase> (returnVal);
+void MyDB_BufferManager :: makeUnevictable (MyDB_BufferShard &shard, MyDB_PagePtr page) {
+	if (page->evictable) {
+		page->evictable = false;
+		numEvictable--;
+		shard.policies[page->pool]->remove (page);
+	}
 }
 
-void MyDB_BufferManager :: kickOutPage () {
+bool MyDB_BufferManager :: growPool (size_t pool) {
+	MyDB_BufferPool &growMe = *pools[pool];
+	size_t held = growMe.numHeld;
+	do {
+		if (held >= growMe.maxPages)
+			return false;
+	} while (!growMe.numHeld.compare_exchange_weak (held, held + 1));
+	return true;
+}
+
+bool MyDB_BufferManager :: takeFreeFrame (size_t pool, size_t &frame) {
+	if (!growPool (pool))
+		return false;
+	if (freeFrames.pop (frame))
+		return true;
+	pools[pool]->numHeld--;
+	return false;
+}
+
+void MyDB_BufferManager :: putFrame (size_t pool, size_t frame) {
+	pools[pool]->numHeld--;
+	freeFrames.push (frame);
+}
+
+bool MyDB_BufferManager :: getFrame (size_t whichShard, size_t pool, size_t &frame, bool granted) {
+
+	// see if there is a free one that the pool may have
+	if (takeFreeFrame (pool, frame))
+		return true;
+
+	// there is not, so kick someone out, trying the page's own shard first.  A pool
+	// that holds fewer frames than it was promised takes them back from the pools that
+	// are holding more than theirs; any other pool kicks out one of its own pages,
+	// and only borrows (if it may) when it has none that it can give up
+	MyDB_BufferPool &mine = *pools[pool];
+	bool owed = mine.numHeld < mine.numPages;
+	for (int pass = 0; pass < 2; pass++) {
+		bool borrow = ((pass == 0) == owed);
+		if (borrow && pools.size () == 1)
+			continue;
+		for (size_t i = 0; i < shards.size (); i++) {
+			MyDB_BufferShard &shard = *shards[(whichShard + i) % shards.size ()];
+			lock_guard <MyDB_Latch> guard (shard.latch);
+			if (!borrow) {
+				if (kickOutPage (shard, pool, frame))
+					return true;
+				continue;
+			}
+			for (size_t other = 0; other < pools.size (); other++) {
+				if (other == pool || pools[other]->numHeld <= pools[other]->numPages)
+					continue;
+				if (!growPool (pool))
+					break;
+				if (kickOutPage (shard, other, frame)) {
+					pools[other]->numHeld--;
+					return true;
+				}
+				mine.numHeld--;
+			}
+		}
+	}
+
+	// last chance: some other thread may have given a frame back in the meantime
+	if (takeFreeFrame (pool, frame))
+		return true;
+
+	// a page pinned through a grant was promised a frame by the buffer as a whole, so
+	// it may have one from any pool, even if that puts its own pool over its limit
+	if (!granted)
+		return false;
+	for (size_t i = 0; i < shards.size (); i++) {
+		MyDB_BufferShard &shard = *shards[(whichShard + i) % shards.size ()];
+		lock_guard <MyDB_Latch> guard (shard.latch);
+		for (size_t other = 0; other < pools.size (); other++) {
+			if (other != pool && kickOutPage (shard, other, frame)) {
+				pools[other]->numHeld--;
+				mine.numHeld++;
+				return true;
+			}
+		}
+	}
+	if (!freeFrames.pop (frame))
+		return false;
+	mine.numHeld++;
+	return true;
+}
+
+bool MyDB_BufferManager :: kickOutPage (MyDB_BufferShard &shard, size_t pool, size_t &frame) {
 	
-	// find the oldest page
-	auto it = lastUsed.begin();
-	auto page = *it;
+	// find the page to kick out; if there is a background writer, we pass over a few
+	// dirty pages looking for a clean one, and give the dirty ones back to the policy
+	MyDB_PagePtr page;
+	vector <MyDB_PagePtr> skipped;
+	while (true) {
+		page = shard.policies[pool]->victim ();
+		if (page == nullptr)
+			break;
+		page->evictable = false;
+		numEvictable--;
+		if (flusher == nullptr || (!page->isDirty && !page->writePending) || skipped.size () >= MAX_DIRTY_SKIPS)
+			break;
+		skipped.push_back (page);
+	}
+
+	// if there was nothing but dirty pages, take the first of them
+	if (page == nullptr && skipped.size () > 0) {
+		page = skipped[0];
+		skipped.erase (skipped.begin ());
+	}
 
-	if (lastUsed.size () == 0)
-		cout << "Bad: all buffer memory is exhaisted!";
+	for (auto &dirty : skipped)
+		makeEvictable (shard, dirty);
+	if (skipped.size () > 0)
+		flusher->wake ();
+
+	if (page == nullptr)
+		return false;
+
+	// if the background writer is writing him, wait for it to finish.  The shard is not
+	// latched while we wait, so he is marked, so that no one uses his bytes (or hands
+	// him back to the policy) in the meantime
+	bool waited = page->writePending;
+	if (waited) {
+		page->evictPending = true;
+		unique_lock <MyDB_Latch> guard (shard.latch, adopt_lock);
+		while (page->writePending)
+			shard.ioDone.wait (guard);
+		guard.release ();
+	}
 
 	// make sure we don't have a null pointer
 	if (page->bytes == nullptr) {
@@ -95,188 +476,963 @@ void MyDB_BufferManager :: kickOutPage () {
 
 	// write it back if necessary
 	if (page->isDirty) {
-		lseek (fds[page->myTable], page->pos * pageSize, SEEK_SET);
-		write (fds[page->myTable], page->bytes, pageSize);
+		writePage (page);
 		page->isDirty = false;
+		shard.numWriteBacks++;
 	}
+	shard.numEvictions++;
+	pools[pool]->numEvictions++;
 
-	// remove it
-	lastUsed.erase (page);
-
-	// remember its RAM
-	availableRam.push_back (page->bytes);
+	// take its RAM
+	frame = frameOf (page->bytes);
 	page->bytes = nullptr;
+	if (waited) {
+		page->evictPending = false;
+		shard.ioDone.notify_all ();
+	}
 
 	// if this guy has no references, kill him
 	if (page->refCount == 0)
-		killPage (page);
+		killPageLatched (shard, page);
+
+	return true;
 }
 
-void MyDB_BufferManager :: killPage (MyDB_PagePtr killMe) {
+void MyDB_BufferManager :: releaseHandle (MyDB_Page *page) {
+
+	// the page is let go of after the shard is unlatched, since this may be the last
+	// reference to it
+	MyDB_PagePtr killMe;
+	MyDB_BufferShard &shard = *shards[page->shard];
+	lock_guard <MyDB_Latch> guard (shard.latch);
+	if (--page->refCount != 0)
+		return;
+	killMe = move (page->self);
+	killPageLatched (shard, killMe);
+}
+
+void MyDB_BufferManager :: killPageLatched (MyDB_BufferShard &shard, MyDB_PagePtr killMe) {
 	
 	//cout << "killing " << killMe->myTable << " " << killMe->pos << "\n";
 
 	// if this is an anon page...
 	if (killMe->myTable == nullptr) {
 
-		// recycle him
-		availablePositions.push (killMe->pos);
+		// if the policy has him, remove him
+		makeUnevictable (shard, killMe);
+		releasePage (killMe);
+
+		// recycle his place in the temp files
+		{
+			MyDB_SpillSlot slot;
+			slot.extent = killMe->extent;
+			slot.pos = killMe->pos;
+			slot.fd = killMe->fd;
+			lock_guard <MyDB_Latch> guard (tempLatch);
+			spill->release (slot);
+		}
 		if (killMe->bytes != nullptr) {
-			availableRam.push_back (killMe->bytes);
+			putFrame (killMe->pool, frameOf (killMe->bytes));
+			killMe->bytes = nullptr;
 		}
 
-		// if he is in the LRU list, remove him
-		if (lastUsed.count (killMe) != 0) {
-			auto page = *(lastUsed.find (killMe));
-			lastUsed.erase (page);
+	// someone got a new handle to this guy since his count went to zero
+	} else if (killMe->refCount != 0) {
+		return;
+
+	// a page of the shared buffer is unpinned there, and is forgotten about here
+	} else if (sharedPool != nullptr) {
+		releasePage (killMe);
+		if (killMe->bytes != nullptr) {
+			sharedPool->unpin (killMe->bytes, killMe->isDirty);
+			killMe->bytes = nullptr;
+			killMe->isDirty = false;
 		}
+		if (shard.allPages.find (killMe->tableId, killMe->pos) == killMe)
+			shard.allPages.erase (killMe->tableId, killMe->pos);
 
-	// if this is a pinned, non-anon page whose data is buffered it converts...
-	} else if (lastUsed.count (killMe) == 0 && killMe->bytes != nullptr) {
-		killMe->timeTick = ++lastTimeTick;
-		lastUsed.insert (killMe);
+	// if this is a pinned, non-anon page whose data is buffered it converts (unless it
+	// is being kicked out)...
+	} else if (!killMe->evictable && killMe->bytes != nullptr && !killMe->evictPending) {
+		makeEvictable (shard, killMe);
 
-	// this guy has no data, so just kill him
+	// this guy has no data, so just kill him (unless he was already replaced)
 	} else if (killMe->bytes == nullptr) {
-		pair <MyDB_TablePtr, long> whichPage = make_pair (killMe->myTable, killMe->pos);
-		allPages.erase (whichPage);
+		if (shard.allPages.find (killMe->tableId, killMe->pos) == killMe)
+			shard.allPages.erase (killMe->tableId, killMe->pos);
 	}
 }
 
-void MyDB_BufferManager :: access (MyDB_PagePtr updateMe) {
-	
-	// if this page was just accessed, get outta here
-	if (updateMe->timeTick > lastTimeTick - (numPages / 2) && updateMe->bytes != nullptr) {
-		return;
+void *MyDB_BufferManager :: access (const MyDB_PagePtr &updateMe, MyDB_AccessStrategy *strategy) {
+
+	// the pages of a shared buffer are pinned there for as long as they have handles
+	if (isShared (updateMe)) {
+		void *bytes = pinShared (updateMe);
+		if (bytes == nullptr) {
+			cout << "Can't get any RAM in the shared buffer to read a page!!\n";
+			exit (1);
+		}
+		return bytes;
 	}
 
-	// first, see if it is currently in the LRU list; if it is, update it
-	if (lastUsed.count (updateMe) == 1) {
-		auto page = *(lastUsed.find (updateMe));
-		lastUsed.erase (page);
-		updateMe->timeTick = ++lastTimeTick;
-		lastUsed.insert (updateMe);
+	MyDB_BufferShard &shard = *shards[updateMe->shard];
+	{
+		unique_lock <MyDB_Latch> guard (shard.latch);
+
+		// if the read-ahead worker is reading the page, or it is being kicked out, wait
+		while (updateMe->readPending || updateMe->evictPending)
+			shard.ioDone.wait (guard);
+
+		// first, see if it is currently held by the policy; if it is, update it
+		if (updateMe->evictable) {
+			shard.noteHit (updateMe->tableId, updateMe->lastUsed);
+			shard.policies[updateMe->pool]->touch (updateMe);
+			void *bytes = updateMe->bytes;
+
+			// if the scan got to the start of a run that was read ahead, ask for more
+			if (updateMe->readAheadMark) {
+				updateMe->readAheadMark = false;
+				guard.unlock ();
+				size_t first, count;
+				if (prefetcher->noteMarkedHit (updateMe, first, count))
+					startReadAhead (updateMe, first, count, strategy);
+			}
+			return bytes;
+		}
 
-	// here, we don't have the bytes...
-	} else if (updateMe->bytes == nullptr) {
-		
-		// not in the LRU list means that we don't have its contents buffered
-		// see if there is space
-		if (availableRam.size () == 0)
-			kickOutPage ();
-
-		// if there is no space, we cannot do anything
-		if (availableRam.size () == 0) {
-			cout << "Can't get any RAM to read a page!!\n";
-			exit (1);
+		// this is a pinned page, which is always in RAM
+		if (updateMe->bytes != nullptr) {
+			shard.noteHit (updateMe->tableId, updateMe->lastUsed);
+			return updateMe->bytes;
 		}
+	}
+
+	// we don't have the bytes, so get some RAM; we cannot hold our own shard's
+	// latch while doing this, since we may need to kick out a page from another
+	size_t frame;
+	if ((strategy == nullptr || !recycleRingFrame (*strategy, updateMe->pool, frame)) && 
+		!getFrame (updateMe->shard, updateMe->pool, frame)) {
+		cout << "Can't get any RAM to read a page!!\n";
+		exit (1);
+	}
+
+	unique_lock <MyDB_Latch> guard (shard.latch);
+	while (updateMe->readPending || updateMe->evictPending)
+		shard.ioDone.wait (guard);
+
+	// some other thread may have read the page in the meantime
+	if (updateMe->bytes != nullptr) {
+		putFrame (updateMe->pool, frame);
+		shard.noteHit (updateMe->tableId, updateMe->lastUsed);
+		if (updateMe->evictable)
+			shard.policies[updateMe->pool]->touch (updateMe);
+		return updateMe->bytes;
+	}
+
+	// get some RAM for the page
+	shard.noteMiss (updateMe->tableId, updateMe->lastUsed);
+	updateMe->bytes = frameBytes (frame);
+	updateMe->numBytes = pageSize;
+
+	// and read it
+	readPage (updateMe);
+	//cout << "reading " << updateMe->myTable << " " << updateMe->pos << "\n";
+
+	makeEvictable (shard, updateMe);
+	void *bytes = updateMe->bytes;
+	guard.unlock ();
+	if (strategy != nullptr)
+		addToRing (*strategy, updateMe);
+
+	// see if this looks like a scan
+	size_t first, count;
+	if (prefetcher != nullptr && prefetcher->noteMiss (updateMe, first, count))
+		startReadAhead (updateMe, first, count, strategy);
+	return bytes;
+}
 
-		// get some RAM for the page
-		updateMe->bytes = availableRam[availableRam.size () - 1]; 
-		updateMe->numBytes = pageSize;
-		availableRam.pop_back ();
+void *MyDB_BufferManager :: pinShared (const MyDB_PagePtr &page) {
 
-		// and read it
-		lseek (fds[updateMe->myTable], updateMe->pos * pageSize, SEEK_SET);
-		read (fds[updateMe->myTable], updateMe->bytes, pageSize);
-		//cout << "reading " << updateMe->myTable << " " << updateMe->pos << "\n";
+	MyDB_BufferShard &shard = *shards[page->shard];
+	{
+		lock_guard <MyDB_Latch> guard (shard.latch);
+		if (page->bytes != nullptr) {
+			shard.noteHit (page->tableId, page->lastUsed);
+			return page->bytes;
+		}
+	}
 
-		updateMe->timeTick = ++lastTimeTick;
-		lastUsed.insert (updateMe);
+	// the shard is not latched while the page is read in, since other processes may
+	// be waiting on us
+	bool hit;
+	void *bytes = sharedPool->pin (page->fd, page->pos, hit);
+	lock_guard <MyDB_Latch> guard (shard.latch);
+
+	// some other thread may have pinned the page in the meantime
+	if (page->bytes != nullptr) {
+		if (bytes != nullptr)
+			sharedPool->unpin (bytes, false);
+		shard.noteHit (page->tableId, page->lastUsed);
+		return page->bytes;
 	}
+	if (bytes == nullptr)
+		return nullptr;
+
+	if (hit)
+		shard.noteHit (page->tableId, page->lastUsed);
+	else
+		shard.noteMiss (page->tableId, page->lastUsed);
+	page->bytes = bytes;
+	page->numBytes = pageSize;
+	return bytes;
 }
 
-MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, long i) {
+bool MyDB_BufferManager :: recycleRingFrame (MyDB_AccessStrategy &strategy, size_t pool, size_t &frame) {
 
-	// open the file, if it is not open
-	if (fds.count (whichTable) == 0) {
-		int fd = open (whichTable->getStorageLoc ().c_str (), O_CREAT | O_RDWR, 0666);
-		fds[whichTable] = fd;
+	MyDB_PagePtr page = strategy.ring[strategy.next];
+	if (page == nullptr)
+		return false;
+
+	// we can only take him if he is still buffered, and no one is using him
+	MyDB_BufferShard &shard = *shards[page->shard];
+	lock_guard <MyDB_Latch> guard (shard.latch);
+	if (page->bytes == nullptr || !page->evictable || page->refCount != 0 || page->readPending || page->writePending)
+		return false;
+
+	// the frame moves to the new page's pool, if that is a different one
+	if (page->pool != pool) {
+		if (!growPool (pool))
+			return false;
+		pools[page->pool]->numHeld--;
 	}
 
+	// kick him out
+	makeUnevictable (shard, page);
+	if (page->isDirty) {
+		writePage (page);
+		page->isDirty = false;
+		shard.numWriteBacks++;
+	}
+	shard.numEvictions++;
+	pools[page->pool]->numEvictions++;
+	frame = frameOf (page->bytes);
+	page->bytes = nullptr;
+	killPageLatched (shard, page);
+	return true;
+}
+
+void MyDB_BufferManager :: addToRing (MyDB_AccessStrategy &strategy, MyDB_PagePtr page) {
+	strategy.ring[strategy.next] = page;
+	strategy.next = (strategy.next + 1) % strategy.ring.size ();
+}
+
+void MyDB_BufferManager :: startReadAhead (MyDB_PagePtr fromPage, size_t first, size_t count, 
+	MyDB_AccessStrategy *strategy) {
+
+	// get a handle and a frame for each page in the run; the handles keep the pages from
+	// being killed while they are being read.  We stop at the first page that is already
+	// buffered, so that what we read is contiguous in the file
+	MyDB_ReadAheadRequest request;
+	request.fd = fromPage->fd;
+	request.first = first;
+	for (size_t i = 0; i < count && i < IOV_MAX; i++) {
+
+		size_t whichShard = shardOf (fromPage->tableId, first + i);
+		MyDB_BufferShard &shard = *shards[whichShard];
+		MyDB_PageHandle handle;
+		{
+			lock_guard <MyDB_Latch> guard (shard.latch);
+			MyDB_PagePtr &slot = shard.allPages.findOrInsert (fromPage->tableId, first + i);
+			if (slot == nullptr) {
+				slot = make_shared <MyDB_Page> (fromPage->myTable, first + i, *this);
+				slot->shard = whichShard;
+				slot->fd = fromPage->fd;
+				slot->pool = fromPage->pool;
+			} else if (slot->bytes != nullptr || slot->readPending) {
+				break;
+			}
+			handle = MyDB_PageHandle (slot);
+		}
+
+		size_t frame;
+		if ((strategy == nullptr || !recycleRingFrame (*strategy, fromPage->pool, frame)) && 
+			!getFrame (whichShard, fromPage->pool, frame))
+			break;
+
+		// from now on, anyone who wants the page waits for the worker
+		{
+			lock_guard <MyDB_Latch> guard (shard.latch);
+			if (handle.page->bytes != nullptr) {
+				putFrame (fromPage->pool, frame);
+				break;
+			}
+			handle.page->readPending = true;
+		}
+		if (strategy != nullptr)
+			addToRing (*strategy, handle.page->self);
+
+		request.handles.push_back (move (handle));
+		request.frames.push_back (frame);
+	}
+
+	if (request.frames.size () == 0)
+		return;
+
+	// if the worker is too far behind, just give everything back
+	if (!prefetcher->submit (request)) {
+		for (size_t i = 0; i < request.frames.size (); i++) {
+			MyDB_PagePtr page = request.handles[i].page->self;
+			MyDB_BufferShard &shard = *shards[page->shard];
+			{
+				lock_guard <MyDB_Latch> guard (shard.latch);
+				page->readPending = false;
+			}
+			shard.ioDone.notify_all ();
+			putFrame (page->pool, request.frames[i]);
+		}
+	}
+}
+
+void MyDB_BufferManager :: finishReadAhead (vector <MyDB_ReadAheadRequest> &requests) {
+
+	// read all of the runs at once
+	vector <MyDB_IORequest> reads (requests.size ());
+	for (size_t i = 0; i < requests.size (); i++) {
+		reads[i].fd = requests[i].fd;
+		reads[i].offset = requests[i].first * pageSize;
+		reads[i].iov.resize (requests[i].frames.size ());
+		for (size_t j = 0; j < requests[i].frames.size (); j++) {
+			reads[i].iov[j].iov_base = frameBytes (requests[i].frames[j]);
+			reads[i].iov[j].iov_len = pageSize;
+		}
+	}
+	chrono :: steady_clock :: time_point start = chrono :: steady_clock :: now ();
+	io->readBatch (reads);
+	readLatency.record (microsSince (start));
+
+	// and put the pages in the buffer
+	for (auto &request : requests) {
+		for (size_t i = 0; i < request.handles.size (); i++) {
+			MyDB_PagePtr page = request.handles[i].page->self;
+			MyDB_BufferShard &shard = *shards[page->shard];
+			lock_guard <MyDB_Latch> guard (shard.latch);
+			page->readPending = false;
+			shard.ioDone.notify_all ();
+			if (page->bytes != nullptr) {
+				putFrame (page->pool, request.frames[i]);
+				continue;
+			}
+			page->bytes = frameBytes (request.frames[i]);
+			page->numBytes = pageSize;
+			page->readAheadMark = (i == 0);
+			makeEvictable (shard, page);
+		}
+	}
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, long i) {
+	return getPinnedPage (whichTable, i, nullptr);
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, long i, MyDB_ReservationPtr grant) {
+
 	// make sure we don't have a null table
 	if (whichTable == nullptr) {
 		cout << "Can't allocate a page with a null table!!\n";
 		exit (1);
 	}
 
-	// first, see if the page is there in the buffer
-	pair <MyDB_TablePtr, long> whichPage = make_pair (whichTable, i);
-	MyDB_PagePtr returnVal;
+	// count the page against the grant up front, so that two threads pinning through
+	// the same grant cannot both get its last frame
+	bool charged = (grant != nullptr && grant->charge ());
+
+	// open the file, if it is not open
+	size_t tableId = whichTable->getId (), pool;
+	int fd = getFd (tableId, whichTable, pool);
+	size_t whichShard = shardOf (tableId, i);
+	MyDB_BufferShard &shard = *shards[whichShard];
+
+	MyDB_PageHandle returnVal;
+	bool hit, marked = false;
+	{
+		unique_lock <MyDB_Latch> guard (shard.latch);
+
+		// if the grant is used up, the page can only be had if it is already pinned
+		// through the grant
+		if (grant != nullptr && !charged) {
+			MyDB_PagePtr pinnedBy = shard.allPages.find (tableId, i);
+			if (pinnedBy == nullptr || pinnedBy->reservation.lock () != grant)
+				return nullptr;
+		}
 
-	// see if we already know him
-	if (allPages.count (whichPage) == 0) {
+		// first, see if the page is there in the buffer
+		MyDB_PagePtr &slot = shard.allPages.findOrInsert (tableId, i);
 
-		//cout << "could not find pinned page\n";
-		// in this case, we do not
-		returnVal = make_shared <MyDB_Page> (whichTable, i, *this);
-		allPages [whichPage] = returnVal;
-		//cout << "are " << allPages.size () << " entries.\n";
+		// see if we already know him
+		if (slot == nullptr) {
 
-	// in this case, we do
-	} else {
+			//cout << "could not find pinned page\n";
+			// in this case, we do not
+			slot = make_shared <MyDB_Page> (whichTable, i, *this);
+			slot->shard = whichShard;
+			slot->fd = fd;
+			slot->pool = pool;
 
-		// get him out of the LRU list if he is there
-		//cout << "found pinned page\n";
-		returnVal = allPages [whichPage];
-		if (lastUsed.count (returnVal) != 0) {
-			auto page = *(lastUsed.find (returnVal));
-	       		lastUsed.erase (page);
+		// in this case, we do
+		} else {
+
+			// get him away from the replacement policy if it has him
+			//cout << "found pinned page\n";
+			makeUnevictable (shard, slot);
 		}
-	}
 
-	// see if we need to get his data
-	if (returnVal->bytes == nullptr) {
+		// if the read-ahead worker is reading the page, the background writer is
+		// writing it, or it is being kicked out, wait for it
+		MyDB_PagePtr page = slot;
+		while (page->readPending || page->writePending || page->evictPending)
+			shard.ioDone.wait (guard);
+
+		// the handle keeps him alive while we go looking for RAM
+		returnVal = MyDB_PageHandle (page);
+
+		// note that the worker may have handed him to the policy
+		makeUnevictable (shard, page);
+		hit = (page->bytes != nullptr);
+		if (hit) {
+			shard.noteHit (page->tableId, page->lastUsed);
+			marked = page->readAheadMark;
+			page->readAheadMark = false;
+			chargePage (page, grant, charged);
+		}
+	}
 
-		// see if there is space to make a pinned page
-		if (availableRam.size () == 0)
-			kickOutPage ();
+	// if the scan got to the start of a run that was read ahead, ask for more
+	size_t first, count;
+	if (marked && prefetcher->noteMarkedHit (returnVal.page->self, first, count))
+		startReadAhead (returnVal.page->self, first, count, nullptr);
+	if (hit) {
+		notePinned ();
+		return returnVal;
+	}
 
-		// if there is no space, we cannot do anything
-		if (availableRam.size () == 0) 
+	// a page of the shared buffer takes a shared frame, rather than one of ours
+	if (sharedPool != nullptr) {
+		MyDB_PagePtr page = returnVal.page->self;
+		if (pinShared (page) == nullptr) {
+			if (charged)
+				grant->uncharge ();
 			return nullptr;
+		}
+		lock_guard <MyDB_Latch> guard (shard.latch);
+		chargePage (page, grant, charged);
+		return returnVal;
+	}
 
-		// set up the return val
-		returnVal->bytes = availableRam[availableRam.size () - 1];
-		returnVal->numBytes = pageSize;
-		availableRam.pop_back ();
+	// see if there is space to make a pinned page; if there is no space, we cannot
+	// do anything
+	size_t frame;
+	if ((grant == nullptr && !mayPinUngranted ()) || !getFrame (whichShard, returnVal.page->pool, frame, grant != nullptr)) {
+		if (charged)
+			grant->uncharge ();
+		return nullptr;
+	}
 
-		// and read it
-		lseek (fds[returnVal->myTable], returnVal->pos * pageSize, SEEK_SET);
-		read (fds[returnVal->myTable], returnVal->bytes, pageSize);
+	MyDB_PagePtr page = returnVal.page->self;
+	bool missed = false;
+	{
+		unique_lock <MyDB_Latch> guard (shard.latch);
+		while (page->readPending || page->evictPending)
+			shard.ioDone.wait (guard);
+		if (page->bytes != nullptr) {
+
+			// some other thread read him in the meantime
+			putFrame (page->pool, frame);
+			shard.noteHit (page->tableId, page->lastUsed);
+		} else {
+
+			// set up the return val
+			shard.noteMiss (page->tableId, page->lastUsed);
+			page->bytes = frameBytes (frame);
+			page->numBytes = pageSize;
+
+			// and read it
+			readPage (page);
+			missed = true;
+		}	
+
+		// and make sure that no one handed him to the policy in the meantime
+		makeUnevictable (shard, page);
+		chargePage (page, grant, charged);
+	}
 
-	}	
+	// see if this looks like a scan
+	if (missed && prefetcher != nullptr && prefetcher->noteMiss (page, first, count))
+		startReadAhead (page, first, count, nullptr);
 
 	// get outta here
-	return make_shared <MyDB_PageHandleBase> (returnVal);
+	notePinned ();
+	return returnVal;
 }
 
 MyDB_PageHandle MyDB_BufferManager :: getPinnedPage () {
+	return getPinnedPage (nullptr);
+}
 
-	// see if there is space to make a pinned page
-	if (availableRam.size () == 0)
-		kickOutPage ();
+MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_ReservationPtr grant) {
 
-	// if there is no space, we cannot do anything
-	if (availableRam.size () == 0) 
+	if (grant != nullptr && !grant->charge ())
 		return nullptr;
 
 	// get a page to return
 	MyDB_PageHandle returnVal = getPage ();
-	returnVal->page->bytes = availableRam[availableRam.size () - 1];
-	returnVal->page->numBytes = pageSize;
-	availableRam.pop_back ();
+	MyDB_PagePtr page = returnVal.page->self;
+
+	// see if there is space to make a pinned page; if there is no space, we cannot
+	// do anything
+	size_t frame;
+	if ((grant == nullptr && !mayPinUngranted ()) || !getFrame (page->shard, page->pool, frame, grant != nullptr)) {
+		if (grant != nullptr)
+			grant->uncharge ();
+		return nullptr;
+	}
+
+	MyDB_BufferShard &shard = *shards[page->shard];
+	lock_guard <MyDB_Latch> guard (shard.latch);
+	page->bytes = frameBytes (frame);
+	page->numBytes = pageSize;
+	chargePage (page, grant, true);
 
 	// and get outta here
+	notePinned ();
 	return returnVal;
 }
 
+MyDB_ReservationPtr MyDB_BufferManager :: reserve (size_t numFrames) {
+	lock_guard <MyDB_Latch> guard (reserveLatch);
+	if (numFrames > numReservableLatched ()) {
+		numDenied++;
+		return nullptr;
+	}
+	numReserved += numFrames;
+	return MyDB_ReservationPtr (new MyDB_Reservation (*this, numFrames));
+}
+
+size_t MyDB_BufferManager :: getNumReservable () {
+	lock_guard <MyDB_Latch> guard (reserveLatch);
+	return numReservableLatched ();
+}
+
+size_t MyDB_BufferManager :: numReservableLatched () {
+
+	size_t headroom = max ((size_t) MIN_UNRESERVED, numPages / UNRESERVED_FRACTION);
+	if (numPages <= headroom)
+		return 0;
+
+	// the frames pinned outside of a grant are not available, and neither are the
+	// ones already granted
+	size_t pinned = numPinnedNow ();
+	size_t grantedPinned = numReservedPinned;
+	size_t used = numReserved + ((pinned > grantedPinned) ? pinned - grantedPinned : 0);
+	size_t limit = numPages - headroom;
+	return (used < limit) ? limit - used : 0;
+}
+
+bool MyDB_BufferManager :: growReservation (MyDB_Reservation &grant, size_t numMore) {
+	lock_guard <MyDB_Latch> guard (reserveLatch);
+	if (numMore > numReservableLatched ()) {
+		numDenied++;
+		return false;
+	}
+	numReserved += numMore;
+	grant.numFrames += numMore;
+	return true;
+}
+
+void MyDB_BufferManager :: endReservation (MyDB_Reservation &grant) {
+
+	// the pages still pinned through the grant now count as pinned outside of a grant
+	lock_guard <MyDB_Latch> guard (reserveLatch);
+	numReserved -= grant.numFrames;
+	numReservedPinned -= grant.numPinned;
+}
+
+bool MyDB_BufferManager :: mayPinUngranted () {
+
+	size_t unused;
+	{
+		lock_guard <MyDB_Latch> guard (reserveLatch);
+		size_t grantedPinned = numReservedPinned;
+		unused = (numReserved > grantedPinned) ? numReserved - grantedPinned : 0;
+	}
+	return numPinnedNow () + unused < numPages;
+}
+
+void MyDB_BufferManager :: chargePage (MyDB_PagePtr page, MyDB_ReservationPtr grant, bool charged) {
+	if (grant == nullptr)
+		return;
+
+	// a page that is already pinned through a grant is only counted once
+	if (!page->reservation.expired ()) {
+		if (charged)
+			grant->uncharge ();
+		return;
+	}
+	page->reservation = grant;
+	numReservedPinned++;
+}
+
+void MyDB_BufferManager :: releasePage (MyDB_PagePtr page) {
+
+	// if the grant is gone, it already took its pages off of numReservedPinned
+	MyDB_ReservationPtr grant = page->reservation.lock ();
+	page->reservation.reset ();
+	if (grant == nullptr)
+		return;
+	grant->uncharge ();
+	numReservedPinned--;
+}
+
 void MyDB_BufferManager :: unpin (MyDB_PagePtr unpinMe) {
-	unpinMe->timeTick = ++lastTimeTick;
-	lastUsed.insert (unpinMe);
+	MyDB_BufferShard &shard = *shards[unpinMe->shard];
+	lock_guard <MyDB_Latch> guard (shard.latch);
+
+	// a page of the shared buffer stays pinned there until its last handle goes away
+	if (isShared (unpinMe))
+		releasePage (unpinMe);
+	else if (unpinMe->bytes != nullptr)
+		makeEvictable (shard, unpinMe);
+}
+
+bool MyDB_BufferManager :: checkpoint () {
+
+	// the table pages of a shared buffer are not ours to list
+	if (warmStartFile == "" || sharedPool != nullptr)
+		return false;
+
+	// a buffered page, and where it is in its shard's list of pages, most recently used
+	// first (as a fraction of the list, since the shards are not all the same size)
+	struct ListedPage {
+		MyDB_TablePtr table;
+		size_t pos;
+		long lastUsed;
+		double rank;
+	};
+
+	// get the pages that have been used since they were read in, shard by shard; since
+	// the pages are spread evenly over the shards, interleaving the shards' lists by
+	// their ranks comes close to ordering all of the pages by when they were used
+	vector <ListedPage> listed;
+	for (auto &shard : shards) {
+		vector <ListedPage> fromShard;
+		{
+			lock_guard <MyDB_Latch> guard (shard->latch);
+			shard->allPages.forEach ([&] (MyDB_PagePtr &page) {
+				if (page->bytes != nullptr && page->lastUsed > 0 && !page->readPending) {
+					ListedPage listMe;
+					listMe.table = page->myTable;
+					listMe.pos = page->pos;
+					listMe.lastUsed = page->lastUsed;
+					listMe.rank = 0;
+					fromShard.push_back (listMe);
+				}
+			});
+		}
+		sort (fromShard.begin (), fromShard.end (), [] (const ListedPage &lhs, const ListedPage &rhs) {
+			return lhs.lastUsed > rhs.lastUsed;
+		});
+		for (size_t i = 0; i < fromShard.size (); i++) {
+			fromShard[i].rank = (double) i / fromShard.size ();
+			listed.push_back (fromShard[i]);
+		}
+	}
+	stable_sort (listed.begin (), listed.end (), [] (const ListedPage &lhs, const ListedPage &rhs) {
+		return lhs.rank < rhs.rank;
+	});
+	if (listed.size () > warmStartLimit)
+		listed.resize (warmStartLimit);
+
+	// number the tables
+	map <size_t, size_t> tableNums;
+	vector <MyDB_TablePtr> tables;
+	for (auto &page : listed) {
+		if (tableNums.count (page.table->getId ()) == 0) {
+			tableNums[page.table->getId ()] = tables.size ();
+			tables.push_back (page.table);
+		}
+	}
+
+	// the manifest is written next to the old one, and then moved over it, so that a
+	// crash part way through does not leave a broken manifest
+	string newFile = warmStartFile + ".new";
+	ofstream out (newFile);
+	out << WARM_START_HEADER << "\n" << tables.size () << "\n";
+	for (auto &table : tables)
+		out << table->getName () << " " << table->getStorageLoc () << " " << table->lastPage () << "\n";
+	out << listed.size () << "\n";
+	for (auto &page : listed)
+		out << tableNums[page.table->getId ()] << " " << page.pos << "\n";
+	out.close ();
+	if (!out || rename (newFile.c_str (), warmStartFile.c_str ()) != 0) {
+		unlink (newFile.c_str ());
+		return false;
+	}
+	return true;
+}
+
+size_t MyDB_BufferManager :: warmStart () {
+
+	if (warmStartFile == "" || sharedPool != nullptr)
+		return 0;
+	ifstream in (warmStartFile);
+	string header;
+	size_t numTables, numListed;
+	if (!getline (in, header) || header != WARM_START_HEADER || !(in >> numTables))
+		return 0;
+
+	// make a stand-in for each table; it has the same name as the real table, and so
+	// the same id, which means that the real table finds the pages when it asks for them
+	vector <MyDB_TablePtr> tables;
+	vector <int> tableFds;
+	vector <size_t> tablePages, tablePool;
+	for (size_t i = 0; i < numTables; i++) {
+		string name, storageLoc;
+		long last;
+		if (!(in >> name >> storageLoc >> last))
+			return 0;
+		MyDB_TablePtr table = make_shared <MyDB_Table> (name, storageLoc);
+		if (last >= 0)
+			table->setLastPage (last);
+		tables.push_back (table);
+
+		// only the pages that are still in the file are read back
+		size_t pool;
+		int fd = getFd (table->getId (), table, pool);
+		struct stat info;
+		tableFds.push_back (fd);
+		tablePool.push_back (pool);
+		tablePages.push_back ((fstat (fd, &info) == 0) ? info.st_size / pageSize : 0);
+	}
+	if (!(in >> numListed))
+		return 0;
+
+	// set aside a free frame for each listed page that is not known to the buffer
+	// already (as long as its pool has room); the handles keep the pages alive while
+	// they are being read
+	vector <MyDB_PageHandle> handles;
+	vector <size_t> frames;
+	size_t whichTable, pos, frame;
+	for (size_t i = 0; i < numListed && in >> whichTable >> pos; i++) {
+		if (whichTable >= tables.size () || pos >= tablePages[whichTable])
+			continue;
+		if (!takeFreeFrame (tablePool[whichTable], frame)) {
+			if (freeFrames.size () == 0)
+				break;
+			continue;
+		}
+
+		size_t tableId = tables[whichTable]->getId ();
+		size_t whichShard = shardOf (tableId, pos);
+		MyDB_BufferShard &shard = *shards[whichShard];
+		lock_guard <MyDB_Latch> guard (shard.latch);
+		MyDB_PagePtr &slot = shard.allPages.findOrInsert (tableId, pos);
+		if (slot != nullptr) {
+			putFrame (tablePool[whichTable], frame);
+			continue;
+		}
+		slot = make_shared <MyDB_Page> (tables[whichTable], pos, *this);
+		slot->shard = whichShard;
+		slot->fd = tableFds[whichTable];
+		slot->pool = tablePool[whichTable];
+		slot->readPending = true;
+		handles.push_back (MyDB_PageHandle (slot));
+		frames.push_back (frame);
+	}
+
+	// read the pages in file order, with each run of pages that are next to each
+	// other in a file read by a single request
+	vector <size_t> order;
+	for (size_t i = 0; i < handles.size (); i++)
+		order.push_back (i);
+	sort (order.begin (), order.end (), [&] (size_t lhs, size_t rhs) {
+		MyDB_Page *l = handles[lhs].page, *r = handles[rhs].page;
+		return l->fd < r->fd || (l->fd == r->fd && l->pos < r->pos);
+	});
+	vector <MyDB_IORequest> reads;
+	for (size_t i : order) {
+		MyDB_Page *page = handles[i].page;
+		if (reads.size () == 0 || reads.back ().fd != page->fd || reads.back ().iov.size () >= IOV_MAX ||
+			(size_t) reads.back ().offset + reads.back ().iov.size () * pageSize != page->pos * pageSize) {
+			MyDB_IORequest read;
+			read.fd = page->fd;
+			read.offset = page->pos * pageSize;
+			reads.push_back (read);
+		}
+		struct iovec bytes;
+		bytes.iov_base = frameBytes (frames[i]);
+		bytes.iov_len = pageSize;
+		reads.back ().iov.push_back (bytes);
+	}
+	chrono :: steady_clock :: time_point start = chrono :: steady_clock :: now ();
+	if (reads.size () > 0)
+		io->readBatch (reads);
+	readLatency.record (microsSince (start));
+
+	// and buffer them, the least recently used first, so that the replacement policy
+	// ends up with them in about the order that they were in before
+	for (size_t i = handles.size (); i > 0; i--) {
+		MyDB_Page *page = handles[i - 1].page;
+		MyDB_BufferShard &shard = *shards[page->shard];
+		lock_guard <MyDB_Latch> guard (shard.latch);
+		page->readPending = false;
+		page->bytes = frameBytes (frames[i - 1]);
+		page->numBytes = pageSize;
+		page->lastUsed = ++shard.useTick;
+		makeEvictable (shard, page->self);
+		shard.ioDone.notify_all ();
+	}
+	numWarmed += handles.size ();
+	return handles.size ();
+}
+
+size_t MyDB_BufferManager :: getNumHits () {
+	size_t total = 0;
+	for (auto &shard : shards) {
+		lock_guard <MyDB_Latch> guard (shard->latch);
+		for (auto count : shard->hits)
+			total += count;
+	}
+	return total;
+}
+
+size_t MyDB_BufferManager :: getNumMisses () {
+	size_t total = 0;
+	for (auto &shard : shards) {
+		lock_guard <MyDB_Latch> guard (shard->latch);
+		for (auto count : shard->misses)
+			total += count;
+	}
+	return total;
+}
+
+size_t MyDB_BufferManager :: numPinnedNow () {
+
+	// everything that is not free and not held by a policy is pinned
+	size_t inUse = numPages - freeFrames.size ();
+	size_t evictable = numEvictable;
+	return (inUse > evictable) ? inUse - evictable : 0;
+}
+
+void MyDB_BufferManager :: notePinned () {
+
+	size_t pinned = numPinnedNow ();
+	size_t high = pinnedHighWater;
+	while (pinned > high && !pinnedHighWater.compare_exchange_weak (high, pinned));
+}
+
+MyDB_BufferStats MyDB_BufferManager :: getStats () {
+
+	MyDB_BufferStats returnVal;
+	returnVal.hits = 0;
+	returnVal.misses = 0;
+	returnVal.evictions = 0;
+	returnVal.writeBacks = 0;
+
+	// add up the shards
+	vector <size_t> hits, misses;
+	for (auto &shard : shards) {
+		lock_guard <MyDB_Latch> guard (shard->latch);
+		if (shard->hits.size () > hits.size ()) {
+			hits.resize (shard->hits.size (), 0);
+			misses.resize (shard->hits.size (), 0);
+		}
+		for (size_t i = 0; i < shard->hits.size (); i++) {
+			hits[i] += shard->hits[i];
+			misses[i] += shard->misses[i];
+		}
+		returnVal.evictions += shard->numEvictions;
+		returnVal.writeBacks += shard->numWriteBacks;
+	}
+
+	// and break the accesses down by table
+	{
+		lock_guard <MyDB_Latch> guard (fdLatch);
+		for (size_t i = 0; i < hits.size (); i++) {
+			returnVal.hits += hits[i];
+			returnVal.misses += misses[i];
+			if (hits[i] + misses[i] == 0)
+				continue;
+			MyDB_TableStats table;
+			table.name = (i < tableNames.size ()) ? tableNames[i] : "table " + to_string (i);
+			table.hits = hits[i];
+			table.misses = misses[i];
+			returnVal.tables.push_back (table);
+		}
+	}
+
+	{
+		lock_guard <MyDB_Latch> guard (tempLatch);
+		returnVal.tempAllocations = numTempAllocations;
+		returnVal.tempExtentsInUse = spill->getNumInUse ();
+		returnVal.tempExtentsReleased = spill->getNumReleased ();
+	}
+	{
+		lock_guard <MyDB_Latch> guard (reserveLatch);
+		returnVal.reservedFrames = numReserved;
+		returnVal.reservationsDenied = numDenied;
+	}
+	returnVal.warmStartPages = numWarmed;
+	for (auto &pool : pools) {
+		MyDB_PoolStats poolStats;
+		poolStats.name = pool->name;
+		poolStats.numPages = pool->numPages;
+		poolStats.maxPages = pool->maxPages;
+		poolStats.numHeld = pool->numHeld;
+		poolStats.evictions = pool->numEvictions;
+		returnVal.pools.push_back (poolStats);
+	}
+	returnVal.sharedFrames = (sharedPool == nullptr) ? 0 : sharedPool->getNumFrames ();
+	returnVal.sharedProcesses = (sharedPool == nullptr) ? 0 : sharedPool->getNumAttached ();
+	returnVal.pinnedHighWater = pinnedHighWater;
+	returnVal.numPages = numPages;
+	returnVal.readLatency = readLatency.getCounts ();
+	returnVal.writeLatency = writeLatency.getCounts ();
+	return returnVal;
 }
 
-MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn, string tempFileIn) {
+void MyDB_BufferManager :: resetStats () {
+
+	for (auto &shard : shards) {
+		lock_guard <MyDB_Latch> guard (shard->latch);
+		shard->hits.clear ();
+		shard->misses.clear ();
+		shard->numEvictions = 0;
+		shard->numWriteBacks = 0;
+	}
+	{
+		lock_guard <MyDB_Latch> guard (tempLatch);
+		numTempAllocations = 0;
+		spill->resetNumReleased ();
+	}
+	{
+		lock_guard <MyDB_Latch> guard (reserveLatch);
+		numDenied = 0;
+	}
+	numWarmed = 0;
+	for (auto &pool : pools)
+		pool->numEvictions = 0;
+	readLatency.reset ();
+	writeLatency.reset ();
+
+	// the high-water mark starts over from what is pinned now
+	pinnedHighWater = 0;
+	notePinned ();
+}
+
+MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn, string tempFileIn) : 
+	MyDB_BufferManager (pageSizeIn, numPagesIn, tempFileIn, MyDB_BufferOptions ()) {}
+
+MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn, string tempFileIn, 
+	MyDB_BufferOptions options) : freeFrames (numPagesIn) {
 
 	// remember the inputs
 	pageSize = pageSizeIn;
@@ -284,55 +1440,203 @@ MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn,
 	// this is the location where we write temp pages
 	tempFile = tempFileIn;
 
-	// start at time tick zero
-	lastTimeTick = 0;
+	numTempAllocations = 0;
 
-	// position in temp file
-	lastTempPos = 0;
+	// nothing is buffered or reserved yet
+	numReserved = 0;
+	numReservedPinned = 0;
+	numDenied = 0;
+	numEvictable = 0;
+	pinnedHighWater = 0;
+	numWarmed = 0;
 
 	// the number of pages
 	numPages = numPagesIn;
 
-	// create all of the RAM
-	for (size_t i = 0; i < numPages; i++) {
-		availableRam.push_back (malloc (pageSizeIn));
-	}	
-}
-
-MyDB_BufferManager :: ~MyDB_BufferManager () {
-	
-	//cout << "\n";
-	//cout << allPages.size () << "\n";
-	for (auto page : allPages) {
-
-		if (page.second->bytes != nullptr) {
+	// direct I/O has to move whole, aligned blocks
+	directIO = options.directIO;
+	if (directIO && pageSize % DIRECT_IO_ALIGN != 0) {
+		cout << "Direct I/O needs a page size that is a multiple of " << DIRECT_IO_ALIGN << "; using the OS cache.\n";
+		directIO = false;
+	}
 
-			// write it back if necessary
-			if (page.second->isDirty) {
-				lseek (fds[page.second->myTable], page.second->pos * pageSize, SEEK_SET);
-				write (fds[page.second->myTable], page.second->bytes, pageSize);
+	// set up the shards; a single-threaded buffer manager has one shard, and no latching
+	// (unless there is a read-ahead worker or a background writer)
+	bool latched = options.concurrent || options.readAhead > 0 || options.cleanTarget > 0;
+	size_t numShards = 1;
+	if (options.concurrent && options.numShards > 1)
+		numShards = options.numShards;
+
+	// set up the buffer pools; the default pool gets whatever the named pools do not
+	size_t numNamed = 0;
+	for (auto &pool : options.pools)
+		numNamed += pool.numPages;
+	if (numNamed > numPages) {
+		cout << "The buffer pools need " << numNamed << " pages, but there are only " << numPages << "!!\n";
+		exit (1);
+	}
+	pools.push_back (make_shared <MyDB_BufferPool> ("default", numPages - numNamed, numPages));
+	for (auto &pool : options.pools) {
+		size_t maxPages = (pool.maxPages == 0 || pool.maxPages > numPages) ? numPages : max (pool.maxPages, pool.numPages);
+		for (auto &other : pools) {
+			if (other->name == pool.name) {
+				cout << "There are two buffer pools named " << pool.name << "!!\n";
+				exit (1);
 			}
+		}
+		pools.push_back (make_shared <MyDB_BufferPool> (pool.name, pool.numPages, maxPages));
+	}
 
-			free (page.second->bytes);
-			page.second->bytes = nullptr;
+	// and see which pool each table (and the temp pages) goes in
+	auto poolNamed = [&] (string name) -> size_t {
+		for (size_t i = 0; i < pools.size (); i++) {
+			if (pools[i]->name == name)
+				return i;
 		}
-		//cout << "writing back " << page.second->myTable << " " << page.second->pos << "\n";
+		cout << "There is no buffer pool named " << name << "!!\n";
+		exit (1);
+	};
+	for (auto &assignment : options.tablePools)
+		namedTablePools[assignment.first] = poolNamed (assignment.second);
+	tempPool = (options.tempPool == "") ? 0 : poolNamed (options.tempPool);
+
+	for (size_t i = 0; i < numShards; i++) {
+		MyDB_BufferShardPtr shard = make_shared <MyDB_BufferShard> ();
+		shard->latch.setEnabled (latched);
+
+		// and its replacement policies, one per pool
+		for (auto &pool : pools) {
+			size_t shardPages = pool->maxPages / numShards;
+			if (shardPages == 0)
+				shardPages = 1;
+			if (options.replacement == ClockReplacement)
+				shard->policies.push_back (make_shared <MyDB_ClockPolicy> ());
+			else if (options.replacement == TwoQReplacement)
+				shard->policies.push_back (make_shared <MyDB_TwoQPolicy> (shardPages));
+			else if (options.replacement == LRUKReplacement)
+				shard->policies.push_back (make_shared <MyDB_LRUKPolicy> (shardPages, options.lruK));
+			else
+				shard->policies.push_back (make_shared <MyDB_LRUPolicy> (shardPages));
+		}
+
+		shards.push_back (shard);
+	}
+	fdLatch.setEnabled (latched);
+	tempLatch.setEnabled (latched);
+	reserveLatch.setEnabled (latched);
+
+	// set up the temp files
+	vector <string> tempPaths;
+	size_t numTempFiles = max (max (options.numTempFiles, options.tempDirs.size ()), (size_t) 1);
+	string tempName = tempFile.substr (tempFile.find_last_of ('/') == string :: npos ? 0 : tempFile.find_last_of ('/') + 1);
+	for (size_t i = 0; i < numTempFiles; i++) {
+		string path = tempFile;
+		if (options.tempDirs.size () > 0)
+			path = options.tempDirs[i % options.tempDirs.size ()] + "/" + tempName;
+		if (numTempFiles > 1)
+			path += "." + to_string (i);
+		tempPaths.push_back (path);
+	}
+	spill = make_shared <MyDB_SpillSpace> (tempPaths, pageSize, options.tempExtentPages, [this] (string path) {
+		return openFile (path, O_TRUNC | O_CREAT | O_RDWR);
+	});
+	tableNames.push_back ("(temp)");
+
+	// set up the I/O, falling back to pread/pwrite if there is no io_uring
+	if (options.io == IOUringIO) {
+		shared_ptr <MyDB_IOUring> ring = make_shared <MyDB_IOUring> (options.ioDepth);
+		if (ring->isOpen ())
+			io = ring;
+	}
+	if (io == nullptr)
+		io = make_shared <MyDB_PosixIO> ();
+
+	// attach to the shared buffer, if there is one
+	if (options.sharedBuffer != "")
+		sharedPool = make_shared <MyDB_SharedPool> (options.sharedBuffer, pageSize,
+			(options.sharedPages == 0) ? numPages : options.sharedPages, io, [this] (string path) {
+				return openFile (path, O_CREAT | O_RDWR);
+			});
+
+	// create all of the RAM in one go; it is mapped, rather than malloced, so that it
+	// is page aligned, and so that it can go on huge pages.  No swap is reserved for it,
+	// so a big buffer only takes memory as its frames are used, as it would if each
+	// frame were malloced when it was first needed
+	arenaSize = numPages * pageSize;
+	arena = (char *) MAP_FAILED;
+	if (options.hugePages) {
+		size_t hugeSize = (arenaSize + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+		arena = (char *) mmap (nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (arena != MAP_FAILED)
+			arenaSize = hugeSize;
+	}
+	if (arena == MAP_FAILED) {
+		arena = (char *) mmap (nullptr, arenaSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (arena == MAP_FAILED) {
+			cout << "Can't map " << arenaSize << " bytes for the buffer!!\n";
+			exit (1);
+		}
+		if (options.hugePages)
+			madvise (arena, arenaSize, MADV_HUGEPAGE);
 	}
+	for (size_t i = numPages; i > 0; i--) {
+		freeFrames.push (i - 1);
+	}	
+
+	// the warm-start manifest lists at most a buffer's worth of pages
+	warmStartFile = options.warmStartFile;
+	warmStartLimit = (options.warmStartPages == 0) ? numPages : options.warmStartPages;
 
-	// delete the rest of the RAM
-	for (auto ram : availableRam) {
-		free (ram);
+	// and start up the read-ahead and the background writer
+	if (options.readAhead > 0)
+		prefetcher = make_shared <MyDB_Prefetcher> (*this, options.readAhead);
+	cleanTarget = options.cleanTarget;
+	if (cleanTarget > 0)
+		flusher = make_shared <MyDB_PageFlusher> (*this);
+}
+
+MyDB_BufferManager :: ~MyDB_BufferManager () {
+
+	// stop the worker threads first, since they use everything else
+	prefetcher = nullptr;
+	flusher = nullptr;
+
+	// remember what was buffered, for the next time
+	if (warmStartFile != "")
+		checkpoint ();
+
+	// write back all of the dirty pages; the pages of the shared buffer that still have
+	// handles are unpinned there, and written back by whoever detaches last
+	vector <MyDB_PagePtr> toWrite;
+	for (auto &shard : shards) {
+		shard->allPages.forEach ([&] (MyDB_PagePtr &page) {
+			if (page->bytes != nullptr && isShared (page)) {
+				sharedPool->unpin (page->bytes, page->isDirty);
+				page->bytes = nullptr;
+				page->isDirty = false;
+			} else if (page->bytes != nullptr && page->isDirty) 
+				toWrite.push_back (page);
+		});
 	}
+	writePages (toWrite);
+	//cout << "wrote back " << toWrite.size () << " pages\n";
+
+	// detach from the shared buffer while we still have the files open
+	sharedPool = nullptr;
+
+	// delete the RAM
+	munmap (arena, arenaSize);
 
 	// finally, close the files
 	for (auto fd : fds) {
-		close (fd.second);
+		if (fd != -1)
+			close (fd);
 	}
 
-	unlink (tempFile.c_str ());
+	// and delete the temp files
+	spill = nullptr;
 }
 
 
 #endif
 
-
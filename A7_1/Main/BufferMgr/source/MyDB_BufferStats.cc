@@ -0,0 +1,75 @@
+
+#ifndef BUFFER_STATS_C
+#define BUFFER_STATS_C
+
+#include "MyDB_BufferStats.h"
+
+using namespace std;
+
+MyDB_LatencyHistogram :: MyDB_LatencyHistogram () {
+	reset ();
+}
+
+void MyDB_LatencyHistogram :: record (size_t micros) {
+	size_t bucket = 0;
+	while (micros >= 2 && bucket < NUM_LATENCY_BUCKETS - 1) {
+		micros >>= 1;
+		bucket++;
+	}
+	buckets[bucket].fetch_add (1, memory_order_relaxed);
+}
+
+void MyDB_LatencyHistogram :: reset () {
+	for (auto &b : buckets)
+		b = 0;
+}
+
+vector <size_t> MyDB_LatencyHistogram :: getCounts () {
+	vector <size_t> returnVal;
+	for (auto &b : buckets)
+		returnVal.push_back (b.load (memory_order_relaxed));
+	return returnVal;
+}
+
+// prints the non-empty buckets of a histogram, one per line
+static void printHistogram (std::ostream &os, const string &name, const vector <size_t> &counts) {
+
+	size_t total = 0;
+	for (auto c : counts)
+		total += c;
+	os << name << ": " << total << " calls\n";
+	for (size_t i = 0; i < counts.size (); i++) {
+		if (counts[i] == 0)
+			continue;
+		size_t low = (i == 0) ? 0 : ((size_t) 1 << i);
+		os << "    " << low << "us+: " << counts[i] << "\n";
+	}
+}
+
+std::ostream& operator<<(std::ostream& os, const MyDB_BufferStats &printMe) {
+
+	size_t total = printMe.hits + printMe.misses;
+	os << "buffer accesses: " << total << " (" << printMe.hits << " hits, " << printMe.misses << " misses";
+	if (total > 0)
+		os << ", " << (100.0 * printMe.hits / total) << "% hit rate";
+	os << ")\n";
+	for (auto &t : printMe.tables)
+		os << "    " << t.name << ": " << t.hits << " hits, " << t.misses << " misses\n";
+	os << "evictions: " << printMe.evictions << "\n";
+	os << "dirty write-backs: " << printMe.writeBacks << "\n";
+	os << "temp pages allocated: " << printMe.tempAllocations << "\n";
+	os << "temp extents: " << printMe.tempExtentsInUse << " in use, " << printMe.tempExtentsReleased << " released\n";
+	os << "pinned frames high-water mark: " << printMe.pinnedHighWater << " of " << printMe.numPages << "\n";
+	os << "frames reserved: " << printMe.reservedFrames << " (" << printMe.reservationsDenied << " reservations denied)\n";
+	os << "pages preloaded at warm start: " << printMe.warmStartPages << "\n";
+	for (auto &p : printMe.pools)
+		os << "pool " << p.name << ": holding " << p.numHeld << " frames (" << p.numPages << " guaranteed, up to " 
+			<< p.maxPages << "), " << p.evictions << " evictions\n";
+	if (printMe.sharedFrames > 0)
+		os << "shared buffer: " << printMe.sharedFrames << " frames, used by " << printMe.sharedProcesses << " processes\n";
+	printHistogram (os, "read latency", printMe.readLatency);
+	printHistogram (os, "write latency", printMe.writeLatency);
+	return os;
+}
+
+#endif
@@ -0,0 +1,67 @@
+
+#ifndef CLOCK_POLICY_C
+#define CLOCK_POLICY_C
+
+#include "MyDB_ClockPolicy.h"
+
+MyDB_ClockPolicy :: MyDB_ClockPolicy () {
+	hand = 0;
+	numCandidates = 0;
+}
+
+void MyDB_ClockPolicy :: insert (MyDB_PagePtr page) {
+
+	// find a slot for the page
+	size_t slot;
+	if (freeSlots.size () == 0) {
+		slot = ring.size ();
+		ring.push_back (nullptr);
+	} else {
+		slot = freeSlots.back ();
+		freeSlots.pop_back ();
+	}
+
+	ring[slot] = page;
+	page->policySlot = slot;
+	page->refBit = true;
+	numCandidates++;
+}
+
+void MyDB_ClockPolicy :: touch (MyDB_PagePtr page) {
+	page->refBit = true;
+}
+
+void MyDB_ClockPolicy :: remove (MyDB_PagePtr page) {
+	ring[page->policySlot] = nullptr;
+	freeSlots.push_back (page->policySlot);
+	numCandidates--;
+}
+
+MyDB_PagePtr MyDB_ClockPolicy :: victim () {
+
+	if (numCandidates == 0)
+		return nullptr;
+
+	// this takes at most two trips around the ring
+	while (true) {
+		if (hand >= ring.size ())
+			hand = 0;
+
+		MyDB_PagePtr page = ring[hand];
+		hand++;
+
+		if (page == nullptr)
+			continue;
+
+		// give him a second chance
+		if (page->refBit) {
+			page->refBit = false;
+			continue;
+		}
+
+		remove (page);
+		return page;
+	}
+}
+
+#endif
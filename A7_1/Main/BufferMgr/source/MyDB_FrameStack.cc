@@ -0,0 +1,42 @@
+
+#ifndef FRAME_STACK_C
+#define FRAME_STACK_C
+
+#include "MyDB_FrameStack.h"
+
+MyDB_FrameStack :: MyDB_FrameStack (size_t numFrames) : next (new atomic <uint32_t> [numFrames]) {
+	head = 0;
+	count = 0;
+	for (size_t i = 0; i < numFrames; i++)
+		next[i] = 0;
+}
+
+void MyDB_FrameStack :: push (size_t whichFrame) {
+	uint64_t oldHead = head.load ();
+	uint64_t newHead;
+	do {
+		next[whichFrame] = (uint32_t) oldHead;
+		newHead = (((oldHead >> 32) + 1) << 32) | (uint64_t) (whichFrame + 1);
+	} while (!head.compare_exchange_weak (oldHead, newHead));
+	count++;
+}
+
+bool MyDB_FrameStack :: pop (size_t &whichFrame) {
+	uint64_t oldHead = head.load ();
+	uint64_t newHead;
+	do {
+		uint32_t top = (uint32_t) oldHead;
+		if (top == 0)
+			return false;
+		newHead = (((oldHead >> 32) + 1) << 32) | (uint64_t) next[top - 1].load ();
+	} while (!head.compare_exchange_weak (oldHead, newHead));
+	whichFrame = (uint32_t) oldHead - 1;
+	count--;
+	return true;
+}
+
+size_t MyDB_FrameStack :: size () {
+	return count;
+}
+
+#endif
@@ -0,0 +1,217 @@
+
+#ifndef IO_URING_C
+#define IO_URING_C
+
+#include <errno.h>
+#include "MyDB_IOUring.h"
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std;
+
+MyDB_IOUring :: MyDB_IOUring (unsigned depth) {
+
+	sqRing = MAP_FAILED;
+	cqRing = MAP_FAILED;
+	sqes = (struct io_uring_sqe *) MAP_FAILED;
+
+	struct io_uring_params params;
+	memset (&params, 0, sizeof (params));
+	ringFd = syscall (__NR_io_uring_setup, depth, &params);
+	if (ringFd < 0) {
+		ringFd = -1;
+		return;
+	}
+
+	// map the two queues; newer kernels let them share one mapping
+	sqRingSize = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+	cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof (struct io_uring_cqe);
+	bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMap && cqRingSize > sqRingSize)
+		sqRingSize = cqRingSize;
+
+	sqRing = mmap (nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+	if (sqRing == MAP_FAILED) {
+		close (ringFd);
+		ringFd = -1;
+		return;
+	}
+
+	if (singleMap) {
+		cqRing = sqRing;
+	} else {
+		cqRing = mmap (nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+		if (cqRing == MAP_FAILED) {
+			munmap (sqRing, sqRingSize);
+			sqRing = MAP_FAILED;
+			close (ringFd);
+			ringFd = -1;
+			return;
+		}
+	}
+
+	sqesSize = params.sq_entries * sizeof (struct io_uring_sqe);
+	sqes = (struct io_uring_sqe *) mmap (nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		ringFd, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED) {
+		if (cqRing != sqRing)
+			munmap (cqRing, cqRingSize);
+		munmap (sqRing, sqRingSize);
+		sqRing = cqRing = MAP_FAILED;
+		close (ringFd);
+		ringFd = -1;
+		return;
+	}
+
+	// find the pieces of the queues
+	char *sq = (char *) sqRing;
+	sqHead = (unsigned *) (sq + params.sq_off.head);
+	sqTail = (unsigned *) (sq + params.sq_off.tail);
+	sqMask = (unsigned *) (sq + params.sq_off.ring_mask);
+	sqArray = (unsigned *) (sq + params.sq_off.array);
+	sqEntries = params.sq_entries;
+
+	char *cq = (char *) cqRing;
+	cqHead = (unsigned *) (cq + params.cq_off.head);
+	cqTail = (unsigned *) (cq + params.cq_off.tail);
+	cqMask = (unsigned *) (cq + params.cq_off.ring_mask);
+	cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+}
+
+MyDB_IOUring :: ~MyDB_IOUring () {
+	if (ringFd == -1)
+		return;
+	munmap (sqes, sqesSize);
+	if (cqRing != sqRing)
+		munmap (cqRing, cqRingSize);
+	munmap (sqRing, sqRingSize);
+	close (ringFd);
+}
+
+bool MyDB_IOUring :: isOpen () {
+	return ringFd != -1;
+}
+
+void MyDB_IOUring :: read (int fd, void *bytes, size_t len, off_t offset) {
+	pread (fd, bytes, len, offset);
+}
+
+void MyDB_IOUring :: write (int fd, void *bytes, size_t len, off_t offset) {
+	pwrite (fd, bytes, len, offset);
+}
+
+void MyDB_IOUring :: readBatch (vector <MyDB_IORequest> &requests) {
+	run (requests, IORING_OP_READV);
+}
+
+void MyDB_IOUring :: writeBatch (vector <MyDB_IORequest> &requests) {
+	run (requests, IORING_OP_WRITEV);
+}
+
+void MyDB_IOUring :: byHand (MyDB_IORequest &request, unsigned char opcode, size_t done) {
+
+	// skip over what is done already
+	vector <struct iovec> rest;
+	size_t skip = done;
+	for (struct iovec &v : request.iov) {
+		if (skip >= v.iov_len) {
+			skip -= v.iov_len;
+			continue;
+		}
+		rest.push_back ({(char *) v.iov_base + skip, v.iov_len - skip});
+		skip = 0;
+	}
+
+	// and keep going until the rest is done too, or a read gets to the end of the file
+	size_t at = 0;
+	while (at < rest.size ()) {
+		ssize_t res;
+		if (opcode == IORING_OP_READV)
+			res = preadv (request.fd, &rest[at], rest.size () - at, request.offset + done);
+		else
+			res = pwritev (request.fd, &rest[at], rest.size () - at, request.offset + done);
+		if (res < 0 && errno == EINTR)
+			continue;
+		if (res <= 0)
+			return;
+		done += res;
+		while (at < rest.size () && (size_t) res >= rest[at].iov_len) {
+			res -= rest[at].iov_len;
+			at++;
+		}
+		if (at < rest.size ()) {
+			rest[at].iov_base = (char *) rest[at].iov_base + res;
+			rest[at].iov_len -= res;
+		}
+	}
+}
+
+void MyDB_IOUring :: run (vector <MyDB_IORequest> &requests, unsigned char opcode) {
+
+	lock_guard <mutex> guard (latch);
+
+	// we are the only ones who touch the submission tail and the completion head
+	unsigned tail = *sqTail;
+	unsigned cqAt = *cqHead;
+	size_t next = 0;
+	size_t inFlight = 0;
+	while (next < requests.size () || inFlight > 0) {
+
+		// fill up the submission queue; we never have more than sqEntries requests in
+		// flight, so the completion queue (which is at least as big) cannot overflow
+		while (next < requests.size () && inFlight + (tail - __atomic_load_n (sqHead, __ATOMIC_ACQUIRE)) < sqEntries) {
+			unsigned index = tail & *sqMask;
+			struct io_uring_sqe *sqe = &sqes[index];
+			memset (sqe, 0, sizeof (*sqe));
+			sqe->opcode = opcode;
+			sqe->fd = requests[next].fd;
+			sqe->addr = (unsigned long) requests[next].iov.data ();
+			sqe->len = requests[next].iov.size ();
+			sqe->off = requests[next].offset;
+			sqe->user_data = next;
+			sqArray[index] = index;
+			tail++;
+			next++;
+		}
+		__atomic_store_n (sqTail, tail, __ATOMIC_RELEASE);
+
+		// hand the new ones to the kernel, and wait for at least one to complete
+		unsigned toSubmit = tail - __atomic_load_n (sqHead, __ATOMIC_ACQUIRE);
+		int res = syscall (__NR_io_uring_enter, ringFd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+		if (res > 0) {
+			inFlight += res;
+		} else if (res < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+
+			// the ring is broken; take back what the kernel did not take, and do that
+			// (and everything after it) by hand.  The ones in flight still complete
+			unsigned head = __atomic_load_n (sqHead, __ATOMIC_ACQUIRE);
+			for (unsigned i = head; i != tail; i++)
+				byHand (requests[sqes[sqArray[i & *sqMask]].user_data], opcode, 0);
+			for (; next < requests.size (); next++)
+				byHand (requests[next], opcode, 0);
+			tail = head;
+			__atomic_store_n (sqTail, tail, __ATOMIC_RELEASE);
+		}
+
+		// reap whatever has completed; if the ring could not do one, or only did part of
+		// it, the rest is done by hand
+		while (cqAt != __atomic_load_n (cqTail, __ATOMIC_ACQUIRE)) {
+			struct io_uring_cqe *cqe = &cqes[cqAt & *cqMask];
+			MyDB_IORequest &request = requests[cqe->user_data];
+			size_t len = 0;
+			for (struct iovec &v : request.iov)
+				len += v.iov_len;
+			if (cqe->res < 0)
+				byHand (request, opcode, 0);
+			else if ((size_t) cqe->res < len)
+				byHand (request, opcode, cqe->res);
+			cqAt++;
+			inFlight--;
+		}
+		__atomic_store_n (cqHead, cqAt, __ATOMIC_RELEASE);
+	}
+}
+
+#endif
@@ -0,0 +1,75 @@
+
+#ifndef LRU_K_POLICY_C
+#define LRU_K_POLICY_C
+
+#include "MyDB_LRUKPolicy.h"
+
+MyDB_LRUKPolicy :: MyDB_LRUKPolicy (size_t numPagesIn, size_t kIn) {
+	numPages = numPagesIn;
+	k = (kIn == 0) ? 1 : kIn;
+	lastTimeTick = 0;
+}
+
+void MyDB_LRUKPolicy :: reference (MyDB_PagePtr page) {
+
+	History &h = history[make_pair (page->tableId, page->pos)];
+	if (h.refs.size () == 0)
+		h.refs.resize (k, 0);
+	h.resident = true;
+
+	// if this page has the most recent reference, this one is correlated with it
+	if (h.refs[0] != lastTimeTick || lastTimeTick == 0) {
+		for (size_t i = k - 1; i > 0; i--)
+			h.refs[i] = h.refs[i - 1];
+		h.refs[0] = ++lastTimeTick;
+	}
+
+	page->timeTick = h.refs[0];
+	page->kthRef = h.refs[k - 1];
+}
+
+void MyDB_LRUKPolicy :: insert (MyDB_PagePtr page) {
+	reference (page);
+	candidates.insert (page);
+}
+
+void MyDB_LRUKPolicy :: touch (MyDB_PagePtr page) {
+
+	// nothing to do for a correlated reference
+	if (page->timeTick == lastTimeTick)
+		return;
+
+	candidates.erase (page);
+	reference (page);
+	candidates.insert (page);
+}
+
+void MyDB_LRUKPolicy :: remove (MyDB_PagePtr page) {
+	candidates.erase (page);
+}
+
+MyDB_PagePtr MyDB_LRUKPolicy :: victim () {
+
+	if (candidates.size () == 0)
+		return nullptr;
+
+	MyDB_PagePtr page = *(candidates.begin ());
+	candidates.erase (candidates.begin ());
+
+	// keep his history around for a while
+	PageKey key = make_pair (page->tableId, page->pos);
+	history[key].resident = false;
+	retired.push_back (key);
+	while (retired.size () > numPages) {
+
+		// only forget the history if the page did not come back in the meantime
+		auto old = history.find (retired.front ());
+		if (old != history.end () && !old->second.resident)
+			history.erase (old);
+		retired.pop_front ();
+	}
+
+	return page;
+}
+
+#endif
@@ -0,0 +1,44 @@
+
+#ifndef LRU_POLICY_C
+#define LRU_POLICY_C
+
+#include "MyDB_LRUPolicy.h"
+
+MyDB_LRUPolicy :: MyDB_LRUPolicy (size_t numPagesIn) {
+	numPages = numPagesIn;
+	lastTimeTick = 0;
+}
+
+void MyDB_LRUPolicy :: insert (MyDB_PagePtr page) {
+	page->timeTick = ++lastTimeTick;
+	lastUsed.insert (page);
+}
+
+void MyDB_LRUPolicy :: touch (MyDB_PagePtr page) {
+
+	// if this page was just accessed, get outta here; it is close enough to the
+	// MRU end that moving it is not worth re-balancing the tree
+	if (page->timeTick > lastTimeTick - (long) (numPages / 2))
+		return;
+
+	lastUsed.erase (page);
+	page->timeTick = ++lastTimeTick;
+	lastUsed.insert (page);
+}
+
+void MyDB_LRUPolicy :: remove (MyDB_PagePtr page) {
+	lastUsed.erase (page);
+}
+
+MyDB_PagePtr MyDB_LRUPolicy :: victim () {
+
+	if (lastUsed.size () == 0)
+		return nullptr;
+
+	// find the oldest page
+	MyDB_PagePtr page = *(lastUsed.begin ());
+	lastUsed.erase (lastUsed.begin ());
+	return page;
+}
+
+#endif
@@ -16,9 +16,8 @@
 #include "MyDB_Page.h"
 #include "MyDB_Table.h"
 
-void *MyDB_Page :: getBytes (MyDB_PagePtr me) {
-	parent.access (me);	
-	return bytes;
+void *MyDB_Page :: getBytes (MyDB_AccessStrategy *strategy) {
+	return parent.access (self, strategy);
 }
 
 void MyDB_Page :: wroteBytes () {
@@ -33,10 +32,20 @@ MyDB_Page :: MyDB_Page (MyDB_TablePtr myTableIn, size_t iin, MyDB_BufferManager
 	isDirty = false;	
 	refCount = 0;
 	timeTick = -1;
-}
-
-void MyDB_Page :: killpage (MyDB_PagePtr me) {
-	parent.killPage (me);
+	lastUsed = 0;
+	evictable = false;
+	refBit = false;
+	policySlot = 0;
+	kthRef = 0;
+	shard = 0;
+	fd = -1;
+	extent = 0;
+	pool = 0;
+	readAheadMark = false;
+	readPending = false;
+	writePending = false;
+	evictPending = false;
+	tableId = (myTable == nullptr) ? 0 : myTable->getId ();
 }
 
 MyDB_BufferManager &MyDB_Page :: getParent () {
@@ -0,0 +1,51 @@
+
+#ifndef PAGE_FLUSHER_C
+#define PAGE_FLUSHER_C
+
+#include <chrono>
+#include "MyDB_BufferManager.h"
+#include "MyDB_PageFlusher.h"
+
+// how long the worker sleeps between rounds, if no one wakes it up
+#define FLUSH_INTERVAL_MS 50
+
+MyDB_PageFlusher :: MyDB_PageFlusher (MyDB_BufferManager &parentIn) : parent (parentIn) {
+	woken = false;
+	done = false;
+	worker = thread (&MyDB_PageFlusher :: run, this);
+}
+
+MyDB_PageFlusher :: ~MyDB_PageFlusher () {
+	{
+		lock_guard <mutex> guard (latch);
+		done = true;
+	}
+	hasWork.notify_one ();
+	worker.join ();
+}
+
+void MyDB_PageFlusher :: wake () {
+	{
+		lock_guard <mutex> guard (latch);
+		woken = true;
+	}
+	hasWork.notify_one ();
+}
+
+void MyDB_PageFlusher :: run () {
+
+	while (true) {
+		{
+			unique_lock <mutex> guard (latch);
+			if (!woken && !done)
+				hasWork.wait_for (guard, chrono::milliseconds (FLUSH_INTERVAL_MS));
+			if (done)
+				return;
+			woken = false;
+		}
+
+		parent.flushDirtyPages ();
+	}
+}
+
+#endif
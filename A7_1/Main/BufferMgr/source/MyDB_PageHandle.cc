@@ -0,0 +1,20 @@
+
+#ifndef PAGE_HANDLE_C
+#define PAGE_HANDLE_C
+
+#include "MyDB_BufferManager.h"
+#include "MyDB_PageHandle.h"
+
+MyDB_PageHandle :: MyDB_PageHandle (const MyDB_PagePtr &useMe) {
+	page = useMe.get ();
+	if (page->refCount++ == 0)
+		page->self = useMe;
+}
+
+void MyDB_PageHandle :: releaseLast () {
+	MyDB_Page *releaseMe = page;
+	page = nullptr;
+	releaseMe->getParent ().releaseHandle (releaseMe);
+}
+
+#endif
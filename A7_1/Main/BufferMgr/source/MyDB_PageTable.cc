@@ -0,0 +1,115 @@
+
+#ifndef PAGE_TABLE_C
+#define PAGE_TABLE_C
+
+#include "MyDB_PageTable.h"
+
+using namespace std;
+
+MyDB_PageTable :: MyDB_PageTable () {
+	slots.resize (64);
+	for (auto &s : slots)
+		s.used = false;
+	mask = slots.size () - 1;
+	numUsed = 0;
+}
+
+MyDB_PagePtr MyDB_PageTable :: find (size_t tableId, size_t pos) {
+
+	for (size_t i = hash (tableId, pos); slots[i].used; i = (i + 1) & mask) {
+		if (slots[i].pos == pos && slots[i].tableId == tableId)
+			return slots[i].page;
+	}
+	return nullptr;
+}
+
+MyDB_PagePtr &MyDB_PageTable :: findOrInsert (size_t tableId, size_t pos) {
+
+	// keep the load factor under 1/2, so that probe sequences stay short
+	if ((numUsed + 1) * 2 > slots.size ())
+		grow ();
+
+	size_t i = hash (tableId, pos);
+	for (; slots[i].used; i = (i + 1) & mask) {
+		if (slots[i].pos == pos && slots[i].tableId == tableId)
+			return slots[i].page;
+	}
+
+	// not there, so claim the empty slot we stopped at
+	slots[i].used = true;
+	slots[i].tableId = tableId;
+	slots[i].pos = pos;
+	slots[i].page = nullptr;
+	numUsed++;
+	return slots[i].page;
+}
+
+bool MyDB_PageTable :: erase (size_t tableId, size_t pos) {
+
+	// find the guy
+	size_t i = hash (tableId, pos);
+	for (; slots[i].used; i = (i + 1) & mask) {
+		if (slots[i].pos == pos && slots[i].tableId == tableId)
+			break;
+	}
+
+	if (!slots[i].used)
+		return false;
+
+	// now we shift back any later entries in the same cluster that would no longer be
+	// reachable from their home slot; this way we never need tombstones
+	size_t hole = i;
+	for (size_t j = (i + 1) & mask; slots[j].used; j = (j + 1) & mask) {
+		size_t home = hash (slots[j].tableId, slots[j].pos);
+
+		// the entry at j can move into the hole iff its home is not in (hole, j]
+		bool canMove = (hole <= j) ? (home <= hole || home > j) : (home <= hole && home > j);
+		if (canMove) {
+			slots[hole].tableId = slots[j].tableId;
+			slots[hole].pos = slots[j].pos;
+			slots[hole].page = slots[j].page;
+			hole = j;
+		}
+	}
+
+	slots[hole].used = false;
+	slots[hole].page = nullptr;
+	numUsed--;
+	return true;
+}
+
+size_t MyDB_PageTable :: size () {
+	return numUsed;
+}
+
+void MyDB_PageTable :: forEach (function <void (MyDB_PagePtr &)> f) {
+	for (auto &s : slots) {
+		if (s.used)
+			f (s.page);
+	}
+}
+
+void MyDB_PageTable :: grow () {
+
+	vector <Slot> oldSlots;
+	oldSlots.swap (slots);
+
+	slots.resize (oldSlots.size () * 2);
+	for (auto &s : slots)
+		s.used = false;
+	mask = slots.size () - 1;
+
+	// and re-insert everyone
+	for (auto &s : oldSlots) {
+		if (!s.used)
+			continue;
+		size_t i = hash (s.tableId, s.pos);
+		for (; slots[i].used; i = (i + 1) & mask);
+		slots[i].used = true;
+		slots[i].tableId = s.tableId;
+		slots[i].pos = s.pos;
+		slots[i].page = s.page;
+	}
+}
+
+#endif
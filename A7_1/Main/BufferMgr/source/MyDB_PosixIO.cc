@@ -0,0 +1,26 @@
+
+#ifndef POSIX_IO_C
+#define POSIX_IO_C
+
+#include "MyDB_PosixIO.h"
+#include <unistd.h>
+
+void MyDB_PosixIO :: read (int fd, void *bytes, size_t len, off_t offset) {
+	pread (fd, bytes, len, offset);
+}
+
+void MyDB_PosixIO :: write (int fd, void *bytes, size_t len, off_t offset) {
+	pwrite (fd, bytes, len, offset);
+}
+
+void MyDB_PosixIO :: readBatch (vector <MyDB_IORequest> &requests) {
+	for (auto &request : requests)
+		preadv (request.fd, request.iov.data (), request.iov.size (), request.offset);
+}
+
+void MyDB_PosixIO :: writeBatch (vector <MyDB_IORequest> &requests) {
+	for (auto &request : requests)
+		pwritev (request.fd, request.iov.data (), request.iov.size (), request.offset);
+}
+
+#endif
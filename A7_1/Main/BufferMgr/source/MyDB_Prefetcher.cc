@@ -0,0 +1,123 @@
+
+#ifndef PREFETCHER_C
+#define PREFETCHER_C
+
+#include "MyDB_BufferManager.h"
+#include "MyDB_Prefetcher.h"
+
+// the most requests that can be waiting; if the worker falls further behind than this,
+// no new windows are asked for, since each waiting request ties up buffer frames
+#define MAX_PENDING 2
+
+MyDB_Prefetcher :: MyDB_Prefetcher (MyDB_BufferManager &parentIn, size_t windowIn) : parent (parentIn) {
+	windowSize = windowIn;
+	done = false;
+	worker = thread (&MyDB_Prefetcher :: run, this);
+}
+
+MyDB_Prefetcher :: ~MyDB_Prefetcher () {
+	{
+		lock_guard <mutex> guard (latch);
+		done = true;
+	}
+	hasWork.notify_one ();
+	worker.join ();
+
+	// the requests still waiting are dropped; their frames don't matter any more, since
+	// the buffer manager is going away
+	requests.clear ();
+}
+
+bool MyDB_Prefetcher :: window (MyDB_TablePtr table, TableState &state, size_t first, size_t &count) {
+
+	// don't tie up any more frames if the worker is behind
+	if (requests.size () >= MAX_PENDING)
+		return false;
+
+	// don't go past the end of the table
+	long last = table->lastPage ();
+	if (last < 0 || first > (size_t) last)
+		return false;
+
+	count = windowSize;
+	if (first + count > (size_t) last + 1)
+		count = (size_t) last + 1 - first;
+
+	state.prefetchedTo = first + count - 1;
+	return true;
+}
+
+bool MyDB_Prefetcher :: noteMiss (MyDB_PagePtr page, size_t &first, size_t &count) {
+
+	if (page->myTable == nullptr)
+		return false;
+
+	lock_guard <mutex> guard (latch);
+	if (page->tableId >= tables.size ())
+		tables.resize (page->tableId + 1);
+	TableState &state = tables[page->tableId];
+
+	// a miss on the page right after the last miss means that we are scanning; but
+	// if the page is in a window that was already asked for, the worker is just late
+	bool scanning = (page->pos == state.lastMiss + 1 && page->pos >= state.prefetchedTo);
+	state.lastMiss = page->pos;
+	if (!scanning)
+		return false;
+
+	first = page->pos + 1;
+	return window (page->myTable, state, first, count);
+}
+
+bool MyDB_Prefetcher :: noteMarkedHit (MyDB_PagePtr page, size_t &first, size_t &count) {
+
+	lock_guard <mutex> guard (latch);
+	if (page->tableId >= tables.size ())
+		tables.resize (page->tableId + 1);
+	TableState &state = tables[page->tableId];
+
+	// ask for the window after the last one
+	first = state.prefetchedTo + 1;
+	if (first <= page->pos)
+		first = page->pos + 1;
+	return window (page->myTable, state, first, count);
+}
+
+bool MyDB_Prefetcher :: submit (MyDB_ReadAheadRequest &request) {
+	{
+		lock_guard <mutex> guard (latch);
+		if (done || requests.size () >= MAX_PENDING)
+			return false;
+		requests.push_back (request);
+	}
+	hasWork.notify_one ();
+	return true;
+}
+
+size_t MyDB_Prefetcher :: reach () {
+
+	// the windows waiting, the ones that the worker is reading, and the one that
+	// the scan is in
+	return (2 * MAX_PENDING + 1) * windowSize;
+}
+
+void MyDB_Prefetcher :: run () {
+
+	while (true) {
+
+		// take all of the waiting requests, so that their reads can be in flight together
+		vector <MyDB_ReadAheadRequest> todo;
+		{
+			unique_lock <mutex> guard (latch);
+			while (!done && requests.size () == 0)
+				hasWork.wait (guard);
+			if (done)
+				return;
+			todo.assign (requests.begin (), requests.end ());
+			requests.clear ();
+		}
+
+		parent.finishReadAhead (todo);
+	}
+}
+
+#endif
@@ -0,0 +1,50 @@
+
+#ifndef RESERVATION_C
+#define RESERVATION_C
+
+#include "MyDB_BufferManager.h"
+#include "MyDB_Reservation.h"
+
+using namespace std;
+
+MyDB_Reservation :: MyDB_Reservation (MyDB_BufferManager &parentIn, size_t numFramesIn) : parent (parentIn) {
+	numFrames = numFramesIn;
+	numPinned = 0;
+}
+
+MyDB_Reservation :: ~MyDB_Reservation () {
+	parent.endReservation (*this);
+}
+
+size_t MyDB_Reservation :: getNumFrames () {
+	return numFrames;
+}
+
+size_t MyDB_Reservation :: getNumPinned () {
+	return numPinned;
+}
+
+size_t MyDB_Reservation :: getNumLeft () {
+	size_t frames = numFrames;
+	size_t pinned = numPinned;
+	return (pinned < frames) ? frames - pinned : 0;
+}
+
+bool MyDB_Reservation :: grow (size_t numMore) {
+	return parent.growReservation (*this, numMore);
+}
+
+bool MyDB_Reservation :: charge () {
+	size_t pinned = numPinned;
+	do {
+		if (pinned >= numFrames)
+			return false;
+	} while (!numPinned.compare_exchange_weak (pinned, pinned + 1));
+	return true;
+}
+
+void MyDB_Reservation :: uncharge () {
+	numPinned--;
+}
+
+#endif
@@ -0,0 +1,443 @@
+
+#ifndef SHARED_POOL_C
+#define SHARED_POOL_C
+
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include "MyDB_SharedPool.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// the frames start on a boundary this big, so that they can be used for direct I/O
+#define SHARED_ARENA_ALIGN 4096
+
+// the number of times (a millisecond apart) that a process waits for someone else to
+// finish setting up a pool before it gives up
+#define SHARED_SETUP_TRIES 5000
+
+// the states of a pool: being set up by the process that created it, in use, and
+// shut down by the last process to use it (which is about to remove it)
+#define POOL_SETTING_UP 0
+#define POOL_OPEN 1
+#define POOL_CLOSED 2
+
+struct MyDB_SharedPoolHeader {
+
+	// the state of the pool (see above); this is read before the latch can be trusted
+	atomic <int> state;
+
+	// how the segment is laid out
+	size_t pageSize;
+	size_t numFrames;
+	size_t numBuckets;
+	size_t segmentSize;
+	size_t arenaOffset;
+
+	// protects everything else, and is signalled when a page has been read or written
+	pthread_mutex_t latch;
+	pthread_cond_t ioDone;
+
+	// the number of processes attached, the number of files known, and where CLOCK is
+	size_t numAttached;
+	size_t numFiles;
+	size_t clockHand;
+};
+
+struct MyDB_SharedFile {
+	dev_t dev;
+	ino_t ino;
+	char path[MAX_SHARED_PATH];
+};
+
+struct MyDB_SharedFrame {
+
+	// the page in the frame (file is -1 if there is none), and the next frame on the
+	// page's hash chain
+	long file;
+	size_t pos;
+	long next;
+
+	// the number of pins (from all of the processes), whether the page has been written
+	// to, CLOCK's reference bit, and whether the page is being read or written
+	int pinCount;
+	bool dirty;
+	bool refBit;
+	bool ioPending;
+};
+
+// the size of a part of the segment, rounded up so that the next part is aligned
+static size_t roundUp (size_t size, size_t align) {
+	return (size + align - 1) / align * align;
+}
+
+MyDB_SharedPool :: MyDB_SharedPool (string nameIn, size_t pageSizeIn, size_t numFrames, MyDB_IOBackendPtr ioIn,
+	function <int (string)> openerIn) {
+
+	name = nameIn;
+	pageSize = pageSizeIn;
+	io = ioIn;
+	opener = openerIn;
+	if (numFrames == 0)
+		numFrames = 1;
+
+	while (true) {
+
+		// try to create the pool
+		int fd = shm_open (name.c_str (), O_CREAT | O_EXCL | O_RDWR, 0666);
+		if (fd != -1) {
+			size_t numBuckets = numFrames * 2;
+			size_t arenaOffset = roundUp (sizeof (MyDB_SharedPoolHeader) + MAX_SHARED_FILES * sizeof (MyDB_SharedFile) +
+				numBuckets * sizeof (long) + numFrames * sizeof (MyDB_SharedFrame), SHARED_ARENA_ALIGN);
+			segmentSize = arenaOffset + numFrames * pageSize;
+			if (ftruncate (fd, segmentSize) != 0) {
+				cout << "Can't size the shared buffer " << name << "!!\n";
+				exit (1);
+			}
+			segment = (char *) mmap (nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			close (fd);
+			if (segment == MAP_FAILED) {
+				cout << "Can't map the shared buffer " << name << "!!\n";
+				exit (1);
+			}
+
+			// set up the header, and then everything else
+			header = (MyDB_SharedPoolHeader *) segment;
+			header->pageSize = pageSize;
+			header->numFrames = numFrames;
+			header->numBuckets = numBuckets;
+			header->segmentSize = segmentSize;
+			header->arenaOffset = arenaOffset;
+			header->numAttached = 1;
+			header->numFiles = 0;
+			header->clockHand = 0;
+
+			pthread_mutexattr_t latchAttr;
+			pthread_mutexattr_init (&latchAttr);
+			pthread_mutexattr_setpshared (&latchAttr, PTHREAD_PROCESS_SHARED);
+			pthread_mutexattr_setrobust (&latchAttr, PTHREAD_MUTEX_ROBUST);
+			pthread_mutex_init (&header->latch, &latchAttr);
+			pthread_mutexattr_destroy (&latchAttr);
+			pthread_condattr_t condAttr;
+			pthread_condattr_init (&condAttr);
+			pthread_condattr_setpshared (&condAttr, PTHREAD_PROCESS_SHARED);
+			pthread_cond_init (&header->ioDone, &condAttr);
+			pthread_condattr_destroy (&condAttr);
+
+			files = (MyDB_SharedFile *) (segment + sizeof (MyDB_SharedPoolHeader));
+			buckets = (long *) (files + MAX_SHARED_FILES);
+			frames = (MyDB_SharedFrame *) (buckets + numBuckets);
+			arena = segment + arenaOffset;
+			for (size_t i = 0; i < numBuckets; i++)
+				buckets[i] = -1;
+			for (size_t i = 0; i < numFrames; i++) {
+				frames[i].file = -1;
+				frames[i].pos = 0;
+				frames[i].next = -1;
+				frames[i].pinCount = 0;
+				frames[i].dirty = false;
+				frames[i].refBit = false;
+				frames[i].ioPending = false;
+			}
+			header->state.store (POOL_OPEN);
+			return;
+		}
+		if (errno != EEXIST) {
+			cout << "Can't create the shared buffer " << name << "!!\n";
+			exit (1);
+		}
+
+		// someone else has it, so attach to it; it may be removed in the meantime
+		fd = shm_open (name.c_str (), O_RDWR, 0666);
+		if (fd == -1) {
+			if (errno == ENOENT)
+				continue;
+			cout << "Can't open the shared buffer " << name << "!!\n";
+			exit (1);
+		}
+
+		// wait for its creator to size it, and then map it
+		struct stat info;
+		int tries = 0;
+		while (fstat (fd, &info) == 0 && (size_t) info.st_size < sizeof (MyDB_SharedPoolHeader) && tries++ < SHARED_SETUP_TRIES)
+			usleep (1000);
+		if ((size_t) info.st_size < sizeof (MyDB_SharedPoolHeader)) {
+			cout << "The shared buffer " << name << " was never set up!!\n";
+			exit (1);
+		}
+		segmentSize = info.st_size;
+		segment = (char *) mmap (nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close (fd);
+		if (segment == MAP_FAILED) {
+			cout << "Can't map the shared buffer " << name << "!!\n";
+			exit (1);
+		}
+		header = (MyDB_SharedPoolHeader *) segment;
+		tries = 0;
+		while (header->state.load () == POOL_SETTING_UP && tries++ < SHARED_SETUP_TRIES)
+			usleep (1000);
+
+		// if the last process was shutting it down, start over
+		bool attached = false;
+		if (header->state.load () == POOL_OPEN) {
+			lock ();
+			if (header->state.load () == POOL_OPEN) {
+				header->numAttached++;
+				attached = true;
+			}
+			unlock ();
+		}
+		if (!attached) {
+			munmap (segment, segmentSize);
+			usleep (1000);
+			continue;
+		}
+
+		if (header->pageSize != pageSize) {
+			cout << "The shared buffer " << name << " has " << header->pageSize << " byte pages, not " << pageSize << "!!\n";
+			exit (1);
+		}
+		files = (MyDB_SharedFile *) (segment + sizeof (MyDB_SharedPoolHeader));
+		buckets = (long *) (files + MAX_SHARED_FILES);
+		frames = (MyDB_SharedFrame *) (buckets + header->numBuckets);
+		arena = segment + header->arenaOffset;
+		return;
+	}
+}
+
+MyDB_SharedPool :: ~MyDB_SharedPool () {
+
+	lock ();
+	bool last = (--header->numAttached == 0);
+	if (last) {
+		header->state.store (POOL_CLOSED);
+		writeBackAll ();
+	}
+	unlock ();
+	if (last)
+		shm_unlink (name.c_str ());
+	munmap (segment, segmentSize);
+	for (int fd : openedFds)
+		close (fd);
+}
+
+void MyDB_SharedPool :: lock () {
+	if (pthread_mutex_lock (&header->latch) == EOWNERDEAD)
+		pthread_mutex_consistent (&header->latch);
+}
+
+void MyDB_SharedPool :: unlock () {
+	pthread_mutex_unlock (&header->latch);
+}
+
+void MyDB_SharedPool :: waitForIO () {
+	if (pthread_cond_wait (&header->ioDone, &header->latch) == EOWNERDEAD)
+		pthread_mutex_consistent (&header->latch);
+}
+
+void MyDB_SharedPool :: addFile (int fd, string path) {
+
+	struct stat info;
+	if (fstat (fd, &info) != 0) {
+		cout << "Can't find the file " << path << " for the shared buffer!!\n";
+		exit (1);
+	}
+
+	lock ();
+
+	// see if some process already told the pool about the file; if not, add it
+	long file = -1;
+	for (size_t i = 0; i < header->numFiles; i++) {
+		if (files[i].dev == info.st_dev && files[i].ino == info.st_ino) {
+			file = i;
+			break;
+		}
+	}
+	if (file == -1) {
+		if (header->numFiles == MAX_SHARED_FILES || path.size () >= MAX_SHARED_PATH) {
+			unlock ();
+			cout << "Can't put the file " << path << " in the shared buffer!!\n";
+			exit (1);
+		}
+		file = header->numFiles++;
+		files[file].dev = info.st_dev;
+		files[file].ino = info.st_ino;
+		strcpy (files[file].path, path.c_str ());
+	}
+
+	if ((size_t) fd >= fileOfFd.size ())
+		fileOfFd.resize (fd + 1, -1);
+	fileOfFd[fd] = file;
+	if ((size_t) file >= fdOfFile.size ())
+		fdOfFile.resize (file + 1, -1);
+	fdOfFile[file] = fd;
+	unlock ();
+}
+
+int MyDB_SharedPool :: fdOf (long file) {
+	if ((size_t) file >= fdOfFile.size ())
+		fdOfFile.resize (file + 1, -1);
+	if (fdOfFile[file] == -1) {
+		fdOfFile[file] = opener (files[file].path);
+		if (fdOfFile[file] == -1) {
+			cout << "Can't open " << files[file].path << " to write back a page of the shared buffer!!\n";
+			exit (1);
+		}
+		openedFds.push_back (fdOfFile[file]);
+	}
+	return fdOfFile[file];
+}
+
+long MyDB_SharedPool :: find (long file, size_t pos) {
+	size_t h = ((pos * 0x9E3779B97F4A7C15ULL) ^ (file * 0xBF58476D1CE4E5B9ULL)) % header->numBuckets;
+	for (long frame = buckets[h]; frame != -1; frame = frames[frame].next) {
+		if (frames[frame].file == file && frames[frame].pos == pos)
+			return frame;
+	}
+	return -1;
+}
+
+void MyDB_SharedPool :: hashIn (long frame) {
+	MyDB_SharedFrame &addMe = frames[frame];
+	size_t h = ((addMe.pos * 0x9E3779B97F4A7C15ULL) ^ (addMe.file * 0xBF58476D1CE4E5B9ULL)) % header->numBuckets;
+	addMe.next = buckets[h];
+	buckets[h] = frame;
+}
+
+void MyDB_SharedPool :: hashOut (long frame) {
+	MyDB_SharedFrame &removeMe = frames[frame];
+	size_t h = ((removeMe.pos * 0x9E3779B97F4A7C15ULL) ^ (removeMe.file * 0xBF58476D1CE4E5B9ULL)) % header->numBuckets;
+	long *link = &buckets[h];
+	while (*link != frame)
+		link = &frames[*link].next;
+	*link = removeMe.next;
+	removeMe.next = -1;
+}
+
+long MyDB_SharedPool :: victim () {
+
+	// two times around is enough to clear every reference bit
+	for (size_t i = 0; i < 2 * header->numFrames; i++) {
+		long frame = header->clockHand;
+		header->clockHand = (header->clockHand + 1) % header->numFrames;
+		MyDB_SharedFrame &candidate = frames[frame];
+		if (candidate.pinCount > 0 || candidate.ioPending)
+			continue;
+		if (candidate.refBit) {
+			candidate.refBit = false;
+			continue;
+		}
+		return frame;
+	}
+	return -1;
+}
+
+void *MyDB_SharedPool :: pin (int fd, size_t pos, bool &hit) {
+
+	lock ();
+	if ((size_t) fd >= fileOfFd.size () || fileOfFd[fd] == -1) {
+		unlock ();
+		cout << "The shared buffer was never told about FD " << fd << "!!\n";
+		exit (1);
+	}
+	long file = fileOfFd[fd];
+
+	while (true) {
+
+		// if some process has the page, just pin it (once it is read in)
+		long frame = find (file, pos);
+		if (frame != -1) {
+			if (frames[frame].ioPending) {
+				waitForIO ();
+				continue;
+			}
+			frames[frame].pinCount++;
+			frames[frame].refBit = true;
+			unlock ();
+			hit = true;
+			return frameBytes (frame);
+		}
+
+		// otherwise, find a frame for it
+		frame = victim ();
+		if (frame == -1) {
+			unlock ();
+			return nullptr;
+		}
+
+		// a dirty page is written back first; anyone who wants it waits, and since
+		// things may have changed by the time that we are done, we start over
+		MyDB_SharedFrame &takeMe = frames[frame];
+		if (takeMe.dirty) {
+			takeMe.ioPending = true;
+			int writeFd = fdOf (takeMe.file);
+			unlock ();
+			io->write (writeFd, frameBytes (frame), pageSize, takeMe.pos * pageSize);
+			lock ();
+			takeMe.dirty = false;
+			takeMe.ioPending = false;
+			pthread_cond_broadcast (&header->ioDone);
+			continue;
+		}
+
+		// it is clean, so take it, and read the page in
+		if (takeMe.file != -1)
+			hashOut (frame);
+		takeMe.file = file;
+		takeMe.pos = pos;
+		takeMe.pinCount = 1;
+		takeMe.refBit = true;
+		takeMe.ioPending = true;
+		hashIn (frame);
+		unlock ();
+		io->read (fd, frameBytes (frame), pageSize, pos * pageSize);
+		lock ();
+		takeMe.ioPending = false;
+		pthread_cond_broadcast (&header->ioDone);
+		unlock ();
+		hit = false;
+		return frameBytes (frame);
+	}
+}
+
+void MyDB_SharedPool :: unpin (void *bytes, bool dirty) {
+	long frame = ((char *) bytes - arena) / pageSize;
+	lock ();
+	if (dirty)
+		frames[frame].dirty = true;
+	frames[frame].pinCount--;
+	unlock ();
+}
+
+bool MyDB_SharedPool :: holds (void *bytes) {
+	return (char *) bytes >= arena && (char *) bytes < arena + header->numFrames * pageSize;
+}
+
+void MyDB_SharedPool :: writeBackAll () {
+	for (size_t i = 0; i < header->numFrames; i++) {
+		if (frames[i].file != -1 && frames[i].dirty) {
+			io->write (fdOf (frames[i].file), frameBytes (i), pageSize, frames[i].pos * pageSize);
+			frames[i].dirty = false;
+		}
+	}
+}
+
+size_t MyDB_SharedPool :: getNumFrames () {
+	return header->numFrames;
+}
+
+size_t MyDB_SharedPool :: getNumAttached () {
+	lock ();
+	size_t returnVal = header->numAttached;
+	unlock ();
+	return returnVal;
+}
+
+#endif
@@ -0,0 +1,196 @@
+
+#ifndef SPILL_SPACE_C
+#define SPILL_SPACE_C
+
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include "MyDB_SpillSpace.h"
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+MyDB_SpillSpace :: MyDB_SpillSpace (vector <string> paths, size_t pageSizeIn, size_t extentPagesIn,
+	function <int (string)> opener) {
+
+	pageSize = pageSizeIn;
+	extentPages = (extentPagesIn == 0) ? 1 : extentPagesIn;
+	nextFile = 0;
+	numInUse = 0;
+	numReleased = 0;
+
+	for (auto &path : paths) {
+		MyDB_SpillFile file;
+		file.path = path;
+		file.fd = opener (path);
+		file.numExtents = 0;
+		file.canPreallocate = true;
+		file.canPunch = true;
+		if (file.fd == -1) {
+			cout << "Can't open temp file " << path << "!!\n";
+			exit (1);
+		}
+		files.push_back (file);
+	}
+}
+
+MyDB_SpillSpace :: ~MyDB_SpillSpace () {
+	for (auto &file : files) {
+		::close (file.fd);
+		unlink (file.path.c_str ());
+	}
+}
+
+size_t MyDB_SpillSpace :: newExtent () {
+
+	size_t whichFile = nextFile;
+	nextFile = (nextFile + 1) % files.size ();
+	MyDB_SpillFile &file = files[whichFile];
+	numInUse++;
+
+	// re-use a free extent of the file, if there is one; otherwise, grow the file
+	size_t extent;
+	if (file.freeExtents.size () > 0) {
+		extent = file.freeExtents.back ();
+		file.freeExtents.pop_back ();
+	} else {
+		MyDB_Extent newOne;
+		newOne.file = whichFile;
+		newOne.first = file.numExtents * extentPages;
+		newOne.live = 0;
+		newOne.open = false;
+		newOne.shared = false;
+		file.numExtents++;
+		extents.push_back (newOne);
+		extent = extents.size () - 1;
+	}
+
+	// the space is allocated up front (if the file system can), so that the extent is
+	// contiguous on the disk, and the file is grown to cover it.  If the file system
+	// cannot do this, it is not tried again, and the file is just grown
+	off_t start = extents[extent].first * pageSize;
+	off_t length = extentPages * pageSize;
+#ifdef __linux__
+	if (file.canPreallocate && fallocate (file.fd, 0, start, length) != 0) {
+		if (errno == EOPNOTSUPP || errno == ENOSYS)
+			file.canPreallocate = false;
+		else {
+			cout << "Can't preallocate space in temp file " << file.path << "!!\n";
+			exit (1);
+		}
+	}
+#else
+	file.canPreallocate = false;
+#endif
+	struct stat info;
+	if (!file.canPreallocate && fstat (file.fd, &info) == 0 && info.st_size < start + length &&
+			ftruncate (file.fd, start + length) != 0) {
+		cout << "Can't grow temp file " << file.path << "!!\n";
+		exit (1);
+	}
+	return extent;
+}
+
+void MyDB_SpillSpace :: releaseExtent (size_t extent) {
+
+	MyDB_Extent &releaseMe = extents[extent];
+	MyDB_SpillFile &file = files[releaseMe.file];
+
+	// give the disk space back; the file keeps its size, so the other extents stay put.
+	// Only the extents whose space was given back are counted as released; if the file
+	// system cannot punch holes, it is not tried again
+#ifdef FALLOC_FL_PUNCH_HOLE
+	if (file.canPunch) {
+		if (fallocate (file.fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, releaseMe.first * pageSize,
+				extentPages * pageSize) == 0)
+			numReleased++;
+		else if (errno == EOPNOTSUPP || errno == ENOSYS)
+			file.canPunch = false;
+	}
+#endif
+	releaseMe.shared = false;
+	releaseMe.freeSlots.clear ();
+	file.freeExtents.push_back (extent);
+	numInUse--;
+}
+
+void MyDB_SpillSpace :: allocate (MyDB_SpillCursor *cursor, MyDB_SpillSlot &slot) {
+
+	// a page that is not in a run first tries the slots that the others freed up
+	if (cursor == nullptr) {
+		while (sharedWithFree.size () > 0) {
+			MyDB_Extent &extent = extents[sharedWithFree.back ()];
+			if (!extent.shared || extent.freeSlots.size () == 0) {
+				sharedWithFree.pop_back ();
+				continue;
+			}
+			slot.extent = sharedWithFree.back ();
+			slot.pos = extent.first + extent.freeSlots.back ();
+			slot.fd = files[extent.file].fd;
+			extent.freeSlots.pop_back ();
+			extent.live++;
+			return;
+		}
+		cursor = &sharedCursor;
+	}
+
+	// go on to a new extent if the cursor's is full
+	if (!cursor->open || cursor->next == extentPages) {
+		close (*cursor);
+		cursor->extent = newExtent ();
+		cursor->next = 0;
+		cursor->open = true;
+		extents[cursor->extent].open = true;
+		extents[cursor->extent].shared = (cursor == &sharedCursor);
+	}
+
+	MyDB_Extent &extent = extents[cursor->extent];
+	slot.extent = cursor->extent;
+	slot.pos = extent.first + cursor->next++;
+	slot.fd = files[extent.file].fd;
+	extent.live++;
+}
+
+void MyDB_SpillSpace :: release (MyDB_SpillSlot &slot) {
+
+	MyDB_Extent &extent = extents[slot.extent];
+	extent.live--;
+	if (extent.shared) {
+		extent.freeSlots.push_back (slot.pos - extent.first);
+		if (extent.freeSlots.size () == 1)
+			sharedWithFree.push_back (slot.extent);
+	}
+
+	// the extent that ordinary temp pages are going into is also given back once it is
+	// empty, so that no space is held when there are no temp pages
+	if (extent.live == 0 && extent.shared && sharedCursor.open && sharedCursor.extent == slot.extent)
+		close (sharedCursor);
+	else if (extent.live == 0 && !extent.open)
+		releaseExtent (slot.extent);
+}
+
+void MyDB_SpillSpace :: close (MyDB_SpillCursor &cursor) {
+	if (!cursor.open)
+		return;
+	cursor.open = false;
+	MyDB_Extent &extent = extents[cursor.extent];
+	extent.open = false;
+	if (extent.live == 0)
+		releaseExtent (cursor.extent);
+}
+
+size_t MyDB_SpillSpace :: getNumInUse () {
+	return numInUse;
+}
+
+size_t MyDB_SpillSpace :: getNumReleased () {
+	return numReleased;
+}
+
+void MyDB_SpillSpace :: resetNumReleased () {
+	numReleased = 0;
+}
+
+#endif
@@ -0,0 +1,16 @@
+
+#ifndef TEMP_RUN_C
+#define TEMP_RUN_C
+
+#include "MyDB_BufferManager.h"
+#include "MyDB_TempRun.h"
+
+using namespace std;
+
+MyDB_TempRun :: MyDB_TempRun (MyDB_BufferManager &parentIn) : parent (parentIn) {}
+
+MyDB_TempRun :: ~MyDB_TempRun () {
+	parent.endTempRun (*this);
+}
+
+#endif
@@ -0,0 +1,85 @@
+
+#ifndef TWO_Q_POLICY_C
+#define TWO_Q_POLICY_C
+
+#include "MyDB_TwoQPolicy.h"
+
+MyDB_TwoQPolicy :: MyDB_TwoQPolicy (size_t numPages) {
+	kin = numPages / 4;
+	if (kin == 0)
+		kin = 1;
+	kout = numPages / 2;
+	if (kout == 0)
+		kout = 1;
+}
+
+void MyDB_TwoQPolicy :: insert (MyDB_PagePtr page) {
+
+	// if we remember this guy from A1out, then he is a re-used page
+	auto ghost = a1outIndex.find (make_pair (page->tableId, page->pos));
+	if (ghost != a1outIndex.end ()) {
+		a1out.erase (ghost->second);
+		a1outIndex.erase (ghost);
+		page->policySlot = Am;
+	}
+
+	// note that a page that was pinned and is now being unpinned goes back to the
+	// queue it came from, since policySlot is left alone when the page is removed
+	if (page->policySlot == Am) {
+		am.push_front (page);
+		page->policyPos = am.begin ();
+	} else {
+		page->policySlot = A1in;
+		a1in.push_front (page);
+		page->policyPos = a1in.begin ();
+	}
+}
+
+void MyDB_TwoQPolicy :: touch (MyDB_PagePtr page) {
+
+	// a hit in A1in does nothing; a hit in Am moves the page to the MRU end
+	if (page->policySlot == Am)
+		am.splice (am.begin (), am, page->policyPos);
+}
+
+void MyDB_TwoQPolicy :: remove (MyDB_PagePtr page) {
+	if (page->policySlot == Am)
+		am.erase (page->policyPos);
+	else
+		a1in.erase (page->policyPos);
+}
+
+MyDB_PagePtr MyDB_TwoQPolicy :: victim () {
+
+	MyDB_PagePtr page;
+
+	// take from A1in if it is over its target size (or if there is nothing else)
+	if (a1in.size () > 0 && (a1in.size () > kin || am.size () == 0)) {
+		page = a1in.back ();
+		a1in.pop_back ();
+
+		// and remember him
+		PageKey key = make_pair (page->tableId, page->pos);
+		if (a1outIndex.count (key) == 0) {
+			a1out.push_front (key);
+			a1outIndex[key] = a1out.begin ();
+			if (a1out.size () > kout) {
+				a1outIndex.erase (a1out.back ());
+				a1out.pop_back ();
+			}
+		}
+
+	} else if (am.size () > 0) {
+		page = am.back ();
+		am.pop_back ();
+
+	} else {
+		return nullptr;
+	}
+
+	// once evicted, the page has to earn its way back into Am
+	page->policySlot = A1in;
+	return page;
+}
+
+#endif
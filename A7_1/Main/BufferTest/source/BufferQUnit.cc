@@ -3,11 +3,17 @@
 #define CATALOG_UNIT_H
 
 #include "MyDB_BufferManager.h"
+#include "MyDB_IOUring.h"
 #include "MyDB_PageHandle.h"
 #include "MyDB_Table.h"
 #include "QUnit.h"
 #include <cstring>
+#include <fcntl.h>
 #include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
@@ -271,6 +277,850 @@ int main () {
 	}
 	cout << "COMPLETE" << endl << flush;
 	QUNIT_IS_TRUE(flag9);
+
+	// replacement policy hit rates on a mixed workload: a small set of hot "index" pages
+	// is probed at random, while a long sequential scan runs through the same buffer
+	cout << "TEST 10..." << flush;
+	{
+		MyDB_ReplacementType types[] = {LRUReplacement, ClockReplacement, TwoQReplacement, LRUKReplacement};
+		const char *names[] = {"LRU", "CLOCK", "2Q", "LRU-2"};
+		double hitRates[4];
+		for (int t = 0; t < 4; t++) {
+			MyDB_BufferOptions options;
+			options.replacement = types[t];
+			MyDB_BufferManager myMgr(64, 32, "tempDSFSD", options);
+			MyDB_TablePtr table1 = make_shared <MyDB_Table>("table1", "file1");
+			unsigned seed = 12345;
+			long scanPos = 0;
+			for (int i = 0; i < 20000; i++) {
+
+				// one index probe...
+				seed = seed * 1103515245 + 12345;
+				MyDB_PageHandle hot = myMgr.getPage(table1, (seed >> 16) % 16);
+				hot->getBytes();
+
+				// and two pages of the scan
+				for (int j = 0; j < 2; j++) {
+					MyDB_PageHandle scan = myMgr.getPage(table1, 16 + (scanPos++ % 4000));
+					scan->getBytes();
+				}
+			}
+			hitRates[t] = myMgr.getNumHits() / (double) (myMgr.getNumHits() + myMgr.getNumMisses());
+			cout << names[t] << " " << hitRates[t] << "..." << flush;
+		}
+
+		// the scan-resistant policies should keep the hot pages around
+		QUNIT_IS_TRUE(hitRates[2] > hitRates[0]);
+		QUNIT_IS_TRUE(hitRates[3] > hitRates[0]);
+	}
+	cout << "COMPLETE" << endl << flush;
+
+	// concurrent mode: several threads write and then read back their own pages, as well
+	// as temp pages, through a small sharded buffer; all of them fight over the frames
+	bool flag11 = true;
+	cout << "TEST 11..." << flush;
+	{
+		cout << "create manager..." << flush;
+		MyDB_BufferOptions options;
+		options.concurrent = true;
+		options.numShards = 4;
+		MyDB_BufferManager myMgr(64, 32, "tempDSFSD", options);
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("table1", "file1");
+		vector <bool> ok(4, true);
+		vector <thread> threads;
+		cout << "run threads..." << flush;
+		for (int t = 0; t < 4; t++) {
+			threads.push_back (thread ([&myMgr, &table1, &ok, t] () {
+				for (int round = 0; round < 3; round++) {
+					for (int i = 0; i < 200; i++) {
+						MyDB_PageHandle page = myMgr.getPinnedPage(table1, t * 200 + i);
+						char *bytes = (char *)page->getBytes();
+						if (round > 0 && bytes[0] != (char)('a' + (i + round - 1) % 26)) ok[t] = false;
+						memset(bytes, (char)('a' + (i + round) % 26), 64);
+						page->wroteBytes();
+
+						// and some churn through unpinned pages and temp pages
+						MyDB_PageHandle other = myMgr.getPage(table1, (t * 200 + i * 7) % 800);
+						other->getBytes();
+						MyDB_PageHandle temp = myMgr.getPinnedPage();
+						if (temp != nullptr) {
+							memset(temp->getBytes(), 'X', 64);
+							temp->wroteBytes();
+						}
+					}
+				}
+			}));
+		}
+		for (auto &th : threads)
+			th.join ();
+		for (int t = 0; t < 4; t++)
+			if (!ok[t]) flag11 = false;
+		if (flag11) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag11);
+
+	// read-ahead: a sequential scan of a table should find most of its pages already
+	// read in by the prefetcher, and they must have the right contents
+	bool flag12 = true;
+	size_t misses12 = 0;
+	cout << "TEST 12..." << flush;
+	{
+		cout << "write table..." << flush;
+		MyDB_TablePtr table3 = make_shared <MyDB_Table>("table3", "file3");
+		table3->setLastPage(399);
+		{
+			MyDB_BufferManager myMgr(4096, 16, "tempDSFSD");
+			for (int i = 0; i < 400; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table3, i);
+				memset(page->getBytes(), (char)('A' + i % 26), 4096);
+				page->wroteBytes();
+			}
+		}
+		cout << "scan table..." << flush;
+		MyDB_BufferOptions options;
+		options.readAhead = 16;
+		MyDB_BufferManager myMgr(4096, 64, "tempDSFSD", options);
+		for (int i = 0; i < 400; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table3, i);
+			char *bytes = (char *)page->getBytes();
+			if (bytes[0] != (char)('A' + i % 26) || bytes[4095] != (char)('A' + i % 26)) flag12 = false;
+		}
+		misses12 = myMgr.getNumMisses();
+		cout << misses12 << " misses..." << flush;
+		if (flag12) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag12);
+	QUNIT_IS_TRUE(misses12 < 400);
+
+	// background writer: a bulk load through a small buffer, with the writer cleaning
+	// pages behind the load, must leave every page on disk with the right contents
+	bool flag13 = true;
+	cout << "TEST 13..." << flush;
+	{
+		cout << "load table..." << flush;
+		MyDB_TablePtr table4 = make_shared <MyDB_Table>("table4", "file4");
+		{
+			MyDB_BufferOptions options;
+			options.cleanTarget = 8;
+			MyDB_BufferManager myMgr(4096, 16, "tempDSFSD", options);
+			for (int i = 0; i < 2000; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table4, i);
+				memset(page->getBytes(), (char)('a' + i % 26), 4096);
+				page->wroteBytes();
+				if (i % 100 == 0) 
+					usleep (1000);
+			}
+		}
+		cout << "check table..." << flush;
+		MyDB_BufferManager myMgr(4096, 16, "tempDSFSD");
+		for (int i = 0; i < 2000; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table4, i);
+			char *bytes = (char *)page->getBytes();
+			if (bytes[0] != (char)('a' + i % 26) || bytes[4095] != (char)('a' + i % 26)) flag13 = false;
+		}
+		if (flag13) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag13);
+
+	// I/O backends: the io_uring backend (with a small ring, so that a batch has to go
+	// through in several rounds) must read back what it wrote, and a buffer manager that
+	// uses it for the background writer and read-ahead must behave like the others
+	bool flag14 = true;
+	cout << "TEST 14..." << flush;
+	{
+		MyDB_IOUring ring(4);
+		if (ring.isOpen()) {
+			cout << "ring batch..." << flush;
+			int fd = open("file5", O_CREAT | O_RDWR | O_TRUNC, 0666);
+			vector <char> out(50 * 4096), in(50 * 4096);
+			for (int i = 0; i < 50; i++)
+				memset(&out[i * 4096], (char)('a' + i % 26), 4096);
+
+			// the first half a page to a request, then the second half two pages to a request
+			vector <MyDB_IORequest> requests;
+			for (int i = 0; i < 50; i++) {
+				if (i >= 25 && i % 2 == 0) {
+					requests.back().iov.push_back({&out[i * 4096], 4096});
+					continue;
+				}
+				MyDB_IORequest request;
+				request.fd = fd;
+				request.offset = i * 4096;
+				request.iov.push_back({&out[i * 4096], 4096});
+				requests.push_back(request);
+			}
+			ring.writeBatch(requests);
+
+			// and read the whole thing back with one big request, and 50 small ones
+			requests.clear();
+			MyDB_IORequest all;
+			all.fd = fd;
+			all.offset = 0;
+			for (int i = 0; i < 50; i++)
+				all.iov.push_back({&in[i * 4096], 4096});
+			requests.push_back(all);
+			ring.readBatch(requests);
+			if (in != out) flag14 = false;
+			memset(&in[0], 0, in.size());
+			requests.clear();
+			for (int i = 0; i < 50; i++) {
+				MyDB_IORequest request;
+				request.fd = fd;
+				request.offset = i * 4096;
+				request.iov.push_back({&in[i * 4096], 4096});
+				requests.push_back(request);
+			}
+			ring.readBatch(requests);
+			if (in != out) flag14 = false;
+			close(fd);
+		} else {
+			cout << "no io_uring here, so only pread/pwrite..." << flush;
+		}
+
+		cout << "load table..." << flush;
+		MyDB_TablePtr table5 = make_shared <MyDB_Table>("table5", "file5");
+		table5->setLastPage(999);
+		MyDB_BufferOptions options;
+		options.io = IOUringIO;
+		options.ioDepth = 8;
+		{
+			options.cleanTarget = 8;
+			MyDB_BufferManager myMgr(4096, 16, "tempDSFSD", options);
+			for (int i = 0; i < 1000; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table5, i);
+				memset(page->getBytes(), (char)('0' + i % 40), 4096);
+				page->wroteBytes();
+			}
+		}
+		cout << "scan table..." << flush;
+		options.cleanTarget = 0;
+		options.readAhead = 16;
+		MyDB_BufferManager myMgr(4096, 64, "tempDSFSD", options);
+		for (int i = 0; i < 1000; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table5, i);
+			char *bytes = (char *)page->getBytes();
+			if (bytes[0] != (char)('0' + i % 40) || bytes[4095] != (char)('0' + i % 40)) flag14 = false;
+		}
+		if (flag14) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag14);
+
+	// the buffer pool arena: with huge pages asked for, every frame must still be its
+	// own page-aligned chunk of RAM, and the data must survive being written out and
+	// read back in
+	bool flag15 = true;
+	cout << "TEST 15..." << flush;
+	{
+		MyDB_TablePtr table6 = make_shared <MyDB_Table>("table6", "file6");
+		MyDB_BufferOptions options;
+		options.hugePages = true;
+		{
+			MyDB_BufferManager myMgr(4096, 32, "tempDSFSD", options);
+			vector <MyDB_PageHandle> pinned;
+			vector <char *> seen;
+			for (int i = 0; i < 32; i++) {
+				pinned.push_back(myMgr.getPinnedPage(table6, i));
+				char *bytes = (char *)pinned.back()->getBytes();
+				if (((size_t)bytes) % 4096 != 0) flag15 = false;
+				for (auto other : seen)
+					if (other == bytes) flag15 = false;
+				seen.push_back(bytes);
+				memset(bytes, (char)('a' + i % 26), 4096);
+				pinned.back()->wroteBytes();
+			}
+			if (myMgr.getPinnedPage(table6, 32) != nullptr) flag15 = false;
+			pinned.clear();
+			for (int i = 32; i < 200; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table6, i);
+				memset(page->getBytes(), (char)('a' + i % 26), 4096);
+				page->wroteBytes();
+			}
+			for (int i = 0; i < 200; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table6, i);
+				char *bytes = (char *)page->getBytes();
+				if (bytes[0] != (char)('a' + i % 26) || bytes[4095] != (char)('a' + i % 26)) flag15 = false;
+			}
+		}
+		if (flag15) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag15);
+
+	// bulk-read rings: a big scan through a ring must leave a small hot set buffered,
+	// while the same scan through the buffer as usual pushes it out
+	bool flag16 = true;
+	size_t ringMisses = 0, plainMisses = 0;
+	cout << "TEST 16..." << flush;
+	{
+		MyDB_TablePtr table7 = make_shared <MyDB_Table>("table7", "file7");
+		MyDB_TablePtr table8 = make_shared <MyDB_Table>("table8", "file8");
+		table8->setLastPage(399);
+		{
+			MyDB_BufferManager myMgr(4096, 16, "tempDSFSD");
+			for (int i = 0; i < 400; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table8, i);
+				memset(page->getBytes(), (char)('a' + i % 26), 4096);
+				page->wroteBytes();
+			}
+		}
+		for (int useRing = 1; useRing >= 0; useRing--) {
+			MyDB_BufferManager myMgr(4096, 64, "tempDSFSD");
+			for (int i = 0; i < 16; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table7, i);
+				memset(page->getBytes(), (char)('A' + i % 26), 4096);
+				page->wroteBytes();
+			}
+
+			MyDB_AccessStrategyPtr ring = nullptr;
+			if (useRing) {
+				ring = myMgr.getBulkReadStrategy(table8);
+				if (ring == nullptr || ring->size() >= 64) flag16 = false;
+				if (myMgr.getBulkReadStrategy(table7) != nullptr) flag16 = false;
+			}
+			for (int i = 0; i < 400; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table8, i, ring);
+				char *bytes = (char *)page->getBytes();
+				if (bytes[0] != (char)('a' + i % 26) || bytes[4095] != (char)('a' + i % 26)) flag16 = false;
+			}
+
+			size_t before = myMgr.getNumMisses();
+			for (int i = 0; i < 16; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table7, i);
+				char *bytes = (char *)page->getBytes();
+				if (bytes[0] != (char)('A' + i % 26)) flag16 = false;
+			}
+			if (useRing) ringMisses = myMgr.getNumMisses() - before;
+			else plainMisses = myMgr.getNumMisses() - before;
+		}
+		cout << ringMisses << " vs " << plainMisses << " hot misses..." << flush;
+		if (flag16) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag16);
+	QUNIT_IS_TRUE(ringMisses == 0);
+	QUNIT_IS_TRUE(plainMisses == 16);
+
+	// stats: the counters must match what a simple workload is known to do, and a reset
+	// must zero them
+	bool flag17 = true;
+	cout << "TEST 17..." << flush;
+	{
+		MyDB_TablePtr table9 = make_shared <MyDB_Table>("table9", "file9");
+		MyDB_BufferManager myMgr(4096, 8, "tempDSFSD");
+
+		// 20 dirty pages through 8 frames: 20 misses, 12 evictions, all written back
+		for (int i = 0; i < 20; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table9, i);
+			memset(page->getBytes(), 'x', 4096);
+			page->wroteBytes();
+		}
+
+		// the last page again is a hit; then 3 pinned temp pages and 2 pinned table pages
+		{
+			MyDB_PageHandle page = myMgr.getPage(table9, 19);
+			page->getBytes();
+		}
+		vector <MyDB_PageHandle> pinned;
+		for (int i = 0; i < 3; i++)
+			pinned.push_back(myMgr.getPinnedPage());
+		for (int i = 0; i < 2; i++)
+			pinned.push_back(myMgr.getPinnedPage(table9, i));
+
+		MyDB_BufferStats stats = myMgr.getStats();
+		cout << endl << stats << flush;
+		size_t reads = 0;
+		for (auto c : stats.readLatency) reads += c;
+		if (stats.tables.size() != 1 || stats.tables[0].name != "table9") flag17 = false;
+		if (stats.hits != 1 || stats.misses != 22) flag17 = false;
+		if (stats.tables.size() == 1 && (stats.tables[0].hits != 1 || stats.tables[0].misses != 22)) flag17 = false;
+		if (stats.evictions < 12 || stats.writeBacks < 12 || stats.writeBacks > stats.evictions) flag17 = false;
+		if (stats.tempAllocations != 3) flag17 = false;
+		if (stats.pinnedHighWater != 5 || stats.numPages != 8) flag17 = false;
+		if (reads != 22) flag17 = false;
+
+		myMgr.resetStats();
+		stats = myMgr.getStats();
+		reads = 0;
+		for (auto c : stats.readLatency) reads += c;
+		if (stats.hits != 0 || stats.misses != 0 || stats.tables.size() != 0 || stats.evictions != 0) flag17 = false;
+		if (stats.writeBacks != 0 || stats.tempAllocations != 0 || reads != 0) flag17 = false;
+		if (stats.pinnedHighWater != 5) flag17 = false;
+		if (flag17) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag17);
+
+	// direct I/O: pages written through a direct-I/O manager (with evictions, and the
+	// background writer) must read back both with and without direct I/O; and asking for
+	// direct I/O with a page size that cannot be aligned must fall back to the OS cache
+	bool flag18 = true;
+	cout << "TEST 18..." << flush;
+	{
+		MyDB_TablePtr table10 = make_shared <MyDB_Table>("table10", "file10");
+		MyDB_BufferOptions options;
+		options.directIO = true;
+		{
+			MyDB_BufferManager myMgr(8192, 8, "tempDSFSD", options);
+			for (int i = 0; i < 40; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table10, i);
+				char *bytes = (char *) page->getBytes();
+				memset(bytes, 'a' + (i % 26), 8192);
+				page->wroteBytes();
+			}
+			for (int i = 0; i < 12; i++) {
+				MyDB_PageHandle temp = myMgr.getPage();
+				memset(temp->getBytes(), 'z', 8192);
+				temp->wroteBytes();
+			}
+		}
+		for (int direct = 0; direct < 2; direct++) {
+			options.directIO = (direct == 1);
+			MyDB_BufferManager myMgr(8192, 8, "tempDSFSD", options);
+			for (int i = 0; i < 40; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table10, i);
+				char *bytes = (char *) page->getBytes();
+				if (bytes[0] != 'a' + (i % 26) || bytes[8191] != 'a' + (i % 26))
+					flag18 = false;
+			}
+		}
+
+		// 1000-byte pages cannot be aligned
+		options.directIO = true;
+		{
+			MyDB_BufferManager myMgr(1000, 4, "tempDSFSD", options);
+			for (int i = 0; i < 10; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table10, i);
+				char *bytes = (char *) page->getBytes();
+				memset(bytes, '0' + i, 1000);
+				page->wroteBytes();
+			}
+			for (int i = 0; i < 10; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table10, i);
+				if (((char *) page->getBytes())[999] != '0' + i)
+					flag18 = false;
+			}
+		}
+		if (flag18) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag18);
+
+	// reservations: grants are limited to what is free of other grants and of ungranted
+	// pins (less the headroom), pins count against their grant, and ungranted pins do
+	// not take frames that were granted
+	bool flag19 = true;
+	cout << "TEST 19..." << flush;
+	{
+		MyDB_TablePtr table11 = make_shared <MyDB_Table>("table11", "file11");
+		MyDB_BufferManager myMgr(64, 32, "tempDSFSD");
+
+		// 32 frames, less 4 of headroom
+		if (myMgr.getNumReservable() != 28) flag19 = false;
+		if (myMgr.reserve(29) != nullptr) flag19 = false;
+		MyDB_ReservationPtr first = myMgr.reserve(10);
+		MyDB_ReservationPtr second = myMgr.reserve(18);
+		if (first == nullptr || second == nullptr) flag19 = false;
+		else {
+			if (myMgr.reserve(1) != nullptr) flag19 = false;
+
+			// ten pins fit in the first grant, and the eleventh does not
+			vector <MyDB_PageHandle> pinned;
+			for (int i = 0; i < 11; i++) {
+				MyDB_PageHandle page = myMgr.getPinnedPage(table11, i, first);
+				if ((page == nullptr) != (i == 10)) flag19 = false;
+				if (page != nullptr) pinned.push_back(page);
+			}
+
+			// a second pin of a page that is already counted is not counted again
+			MyDB_PageHandle again = myMgr.getPinnedPage(table11, 0, first);
+			if (again == nullptr || first->getNumPinned() != 10 || first->getNumLeft() != 0) flag19 = false;
+
+			// 10 frames are pinned and 18 more are granted, so 4 ungranted pins fit
+			vector <MyDB_PageHandle> ungranted;
+			for (int i = 0; i < 5; i++) {
+				MyDB_PageHandle page = myMgr.getPinnedPage();
+				if ((page == nullptr) != (i == 4)) flag19 = false;
+				if (page != nullptr) ungranted.push_back(page);
+			}
+
+			// unpinning gives the frame back to the grant
+			pinned.pop_back();
+			if (first->getNumPinned() != 9) flag19 = false;
+			if (myMgr.getPinnedPage(table11, 20, first) == nullptr) flag19 = false;
+
+			// nothing is left to grow into, until the second grant is given back
+			if (second->grow(1)) flag19 = false;
+			second = nullptr;
+			ungranted.clear();
+			if (!first->grow(5) || first->getNumFrames() != 15) flag19 = false;
+
+			MyDB_BufferStats stats = myMgr.getStats();
+			if (stats.reservedFrames != 15 || stats.reservationsDenied != 3) flag19 = false;
+		}
+		first = nullptr;
+		if (myMgr.getStats().reservedFrames != 0) flag19 = false;
+		if (flag19) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag19);
+
+	// spill space: a temp run fills an extent before going on to the next one, new
+	// extents go round-robin over the temp files (which are preallocated an extent at
+	// a time), ordinary temp pages re-use each other's slots, and the space of an
+	// extent is punched out once all of its pages are gone
+	bool flag20 = true;
+	cout << "TEST 20..." << flush;
+	{
+		MyDB_BufferOptions options;
+		options.tempDirs.push_back(".");
+		options.numTempFiles = 3;
+		options.tempExtentPages = 4;
+		MyDB_BufferManager myMgr(4096, 16, "spillTemp", options);
+		struct stat info[3];
+		const char *names[3] = {"./spillTemp.0", "./spillTemp.1", "./spillTemp.2"};
+
+		{
+			MyDB_TempRunPtr run = myMgr.startTempRun();
+			vector <MyDB_PageHandle> runPages;
+			for (int i = 0; i < 8; i++) {
+				runPages.push_back(myMgr.getPage(run));
+				memset(runPages.back()->getBytes(), 'r', 4096);
+				runPages.back()->wroteBytes();
+			}
+			for (int i = 0; i < 3; i++)
+				if (stat(names[i], &info[i]) != 0) flag20 = false;
+			if (info[0].st_size != 4 * 4096 || info[1].st_size != 4 * 4096 || info[2].st_size != 0) flag20 = false;
+			if (myMgr.getStats().tempExtentsInUse != 2) flag20 = false;
+
+			// three ordinary temp pages share the third file's first extent; freeing one
+			// and getting another re-uses its slot
+			vector <MyDB_PageHandle> loose;
+			for (int i = 0; i < 3; i++)
+				loose.push_back(myMgr.getPage());
+			loose.erase(loose.begin());
+			loose.push_back(myMgr.getPage());
+			if (stat(names[2], &info[2]) != 0 || info[2].st_size != 4 * 4096) flag20 = false;
+			if (myMgr.getStats().tempExtentsInUse != 3) flag20 = false;
+		}
+
+		// the run and its pages are gone, and so are the ordinary ones; the files keep
+		// their sizes, but not their space
+		MyDB_BufferStats stats = myMgr.getStats();
+		if (stats.tempExtentsInUse != 0 || stats.tempExtentsReleased != 3) flag20 = false;
+		for (int i = 0; i < 3; i++) {
+			struct stat after;
+			if (stat(names[i], &after) != 0 || after.st_size != 4 * 4096 || after.st_blocks != 0) flag20 = false;
+		}
+		if (flag20) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+
+	// and the temp files are deleted with the buffer manager
+	struct stat gone;
+	if (stat("./spillTemp.0", &gone) == 0) flag20 = false;
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag20);
+
+	// page handles: a copied or moved handle keeps the page pinned, and the page is
+	// unpinned (or, for a temp page, killed) only when the last handle to it is gone,
+	// even if handles are copied and dropped by several threads at once
+	bool flag21 = true;
+	cout << "TEST 21..." << flush;
+	{
+		MyDB_BufferOptions options;
+		options.concurrent = true;
+		MyDB_BufferManager myMgr(64, 4, "tempDSFSD", options);
+		MyDB_TablePtr table12 = make_shared <MyDB_Table> ("tempTable12", "file12");
+
+		vector <MyDB_PageHandle> pinned;
+		for (int i = 0; i < 4; i++) {
+			pinned.push_back(myMgr.getPinnedPage(table12, i));
+			memset(pinned.back()->getBytes(), 'a' + i, 64);
+			pinned.back()->wroteBytes();
+		}
+		MyDB_PageHandle copy = pinned[0];
+		MyDB_PageHandle moved = move(pinned[1]);
+		if (pinned[1] != nullptr || moved == nullptr) flag21 = false;
+		pinned.clear();
+
+		// pages 2 and 3 are unpinned now, but 0 and 1 are not
+		MyDB_PageHandle four = myMgr.getPinnedPage(table12, 4);
+		MyDB_PageHandle five = myMgr.getPinnedPage(table12, 5);
+		if (four == nullptr || five == nullptr) flag21 = false;
+		if (myMgr.getPinnedPage(table12, 6) != nullptr) flag21 = false;
+		if (((char *) copy->getBytes())[0] != 'a' || ((char *) moved->getBytes())[0] != 'b') flag21 = false;
+
+		// a temp page survives its first handle, and its slot goes when the last one does
+		copy = nullptr;
+		MyDB_PageHandle temp = myMgr.getPinnedPage();
+		if (temp == nullptr) flag21 = false;
+		else {
+			MyDB_PageHandle other;
+			other = temp;
+			temp = nullptr;
+			if (myMgr.getStats().tempExtentsInUse != 1) flag21 = false;
+			other = nullptr;
+			if (myMgr.getStats().tempExtentsInUse != 0) flag21 = false;
+		}
+
+		// several threads copy and drop handles to one page
+		vector <thread> threads;
+		for (int t = 0; t < 4; t++) {
+			threads.push_back(thread([&] () {
+				for (int i = 0; i < 100000; i++) {
+					MyDB_PageHandle mine = moved;
+					MyDB_PageHandle again = mine;
+					if (((char *) again->getBytes())[1] != 'b') flag21 = false;
+				}
+			}));
+		}
+		for (auto &t : threads)
+			t.join();
+		moved = nullptr;
+		four = nullptr;
+		five = nullptr;
+
+		// now nothing is pinned, and the pages that were written come back
+		for (int i = 0; i < 4; i++) {
+			MyDB_PageHandle page = myMgr.getPinnedPage(table12, 10 + i);
+			if (page == nullptr) flag21 = false;
+			else pinned.push_back(page);
+		}
+		pinned.clear();
+		for (int i = 0; i < 4; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table12, i);
+			if (((char *) page->getBytes())[63] != 'a' + i) flag21 = false;
+		}
+		if (flag21) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag21);
+
+	// warm start: a buffer manager that is shut down lists its most recently used pages,
+	// and the next one reads them back in, so that they are hits from the start
+	bool flag22 = true;
+	cout << "TEST 22..." << flush;
+	{
+		MyDB_BufferOptions options;
+		options.warmStartFile = "warmManifest";
+		MyDB_TablePtr table13 = make_shared <MyDB_Table> ("tempTable13", "file13");
+		{
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD", options);
+			for (int i = 0; i < 40; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table13, i);
+				memset(page->getBytes(), 'a' + i % 26, 64);
+				page->wroteBytes();
+			}
+
+			// pages 30 ... 39 and 0 ... 5 are the sixteen most recently used
+			for (int i = 0; i < 6; i++)
+				myMgr.getPage(table13, i)->getBytes();
+		}
+		{
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD", options);
+			if (myMgr.warmStart() != 16) flag22 = false;
+			if (myMgr.getStats().warmStartPages != 16) flag22 = false;
+			for (int i = 0; i < 6; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table13, i);
+				if (((char *) page->getBytes())[10] != 'a' + i) flag22 = false;
+			}
+			for (int i = 30; i < 40; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table13, i);
+				if (((char *) page->getBytes())[10] != 'a' + i % 26) flag22 = false;
+			}
+			if (myMgr.getNumHits() != 16 || myMgr.getNumMisses() != 0) flag22 = false;
+
+			// a page that is already buffered is not read again
+			if (myMgr.warmStart() != 0) flag22 = false;
+		}
+
+		// with no manifest, there is nothing to read
+		unlink("warmManifest");
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD", options);
+		if (myMgr.warmStart() != 0) flag22 = false;
+		if (flag22) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	unlink("warmManifest");
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag22);
+
+	// buffer pools: spilling temp pages cannot push the pages of a table that has its own
+	// pool out of the buffer; a pool borrows free frames up to its limit, and a pool that
+	// is short of its share takes its frames back from the pools that borrowed them
+	bool flag23 = true;
+	cout << "TEST 23..." << flush;
+	{
+		MyDB_BufferOptions options;
+		options.pools.push_back(MyDB_PoolOptions("index", 4, 6));
+		options.pools.push_back(MyDB_PoolOptions("temp", 4, 8));
+		options.tablePools["tempTable14"] = "index";
+		options.tempPool = "temp";
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD", options);
+		MyDB_TablePtr table14 = make_shared <MyDB_Table> ("tempTable14", "file14");
+		MyDB_TablePtr table15 = make_shared <MyDB_Table> ("tempTable15", "file15");
+		for (int i = 0; i < 4; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table14, i);
+			memset(page->getBytes(), 'a' + i, 64);
+			page->wroteBytes();
+		}
+
+		// the temp pages fill up the free frames that their pool may borrow, and then
+		// replace each other
+		vector <MyDB_PageHandle> temps;
+		for (int i = 0; i < 30; i++) {
+			temps.push_back(myMgr.getPage());
+			memset(temps.back()->getBytes(), 'A' + i % 26, 64);
+			temps.back()->wroteBytes();
+		}
+		MyDB_BufferStats stats = myMgr.getStats();
+		if (stats.pools.size() != 3 || stats.pools[2].numHeld != 8 || stats.pools[1].numHeld != 4) flag23 = false;
+
+		// a big scan of an ordinary table takes back the default pool's frames from the
+		// temp pages, but not from the index
+		for (int i = 0; i < 32; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table15, i);
+			memset(page->getBytes(), 'z', 64);
+			page->wroteBytes();
+		}
+		stats = myMgr.getStats();
+		if (stats.pools[0].numHeld != 8 || stats.pools[1].numHeld != 4 || stats.pools[2].numHeld != 4) flag23 = false;
+		myMgr.resetStats();
+		for (int i = 0; i < 4; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table14, i);
+			if (((char *) page->getBytes())[5] != 'a' + i) flag23 = false;
+		}
+		if (myMgr.getNumMisses() != 0) flag23 = false;
+		if (((char *) temps[0]->getBytes())[5] != 'A') flag23 = false;
+
+		// every pool is holding its share, so the index can only pin its own pages
+		vector <MyDB_PageHandle> pinned;
+		for (int i = 0; i < 4; i++)
+			pinned.push_back(myMgr.getPinnedPage(table14, i));
+		if (myMgr.getPinnedPage(table14, 4) != nullptr) flag23 = false;
+
+		// once the temp pages are gone, it can borrow their frames, up to its limit
+		temps.clear();
+		for (int i = 4; i < 6; i++) {
+			pinned.push_back(myMgr.getPinnedPage(table14, i));
+			if (pinned.back() == nullptr) flag23 = false;
+		}
+		if (myMgr.getPinnedPage(table14, 6) != nullptr) flag23 = false;
+		if (myMgr.getStats().pools[1].numHeld != 6) flag23 = false;
+
+		// but a page pinned through a reservation was promised its frame
+		MyDB_ReservationPtr grant = myMgr.reserve(1);
+		if (grant == nullptr || myMgr.getPinnedPage(table14, 6, grant) == nullptr) flag23 = false;
+		if (flag23) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag23);
+
+	// a shared buffer: four processes hammer on the same 64 pages through a 16 frame
+	// shared pool, each counting up its own slot in each page, so the pages are forever
+	// being written back and read in by one process while the others are using them.
+	// No count may be lost, and the last process to detach writes everything back
+	bool flag24 = true;
+	cout << "TEST 24..." << flush;
+	{
+		MyDB_TablePtr table16 = make_shared <MyDB_Table> ("tempTable16", "file16");
+		{
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+			for (int i = 0; i < 64; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table16, i);
+				memset(page->getBytes(), 0, 64);
+				page->wroteBytes();
+			}
+		}
+
+		MyDB_BufferOptions options;
+		options.sharedBuffer = "/mydbTest" + to_string(getpid());
+		options.sharedPages = 16;
+		const int numProcs = 4, numIters = 2000;
+		vector <vector <long>> expected(64, vector <long> (numProcs, 0));
+		for (int c = 0; c < numProcs; c++)
+			for (int iter = 0; iter < numIters; iter++)
+				expected[(iter * 7 + c) % 64][c]++;
+		{
+			MyDB_BufferManager myMgr(64, 4, "tempDSFSD", options);
+			vector <pid_t> children;
+			for (int c = 0; c < numProcs; c++) {
+				pid_t child = fork();
+				if (child == 0) {
+					bool ok = true;
+					{
+						MyDB_BufferManager childMgr(64, 4, "tempDSFSD" + to_string(c), options);
+						vector <long> counts(64, 0);
+						for (int iter = 0; iter < numIters; iter++) {
+							int i = (iter * 7 + c) % 64;
+							MyDB_PageHandle page = childMgr.getPage(table16, i);
+							long *slots = (long *) page->getBytes();
+							slots[c]++;
+							page->wroteBytes();
+							if (slots[c] != ++counts[i]) ok = false;
+						}
+					}
+					unlink(("tempDSFSD" + to_string(c)).c_str());
+					_exit(ok ? 0 : 1);
+				}
+				children.push_back(child);
+			}
+			for (pid_t child : children) {
+				int status;
+				if (waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) flag24 = false;
+			}
+			if (myMgr.getStats().sharedFrames != 16 || myMgr.getStats().sharedProcesses != 1) flag24 = false;
+			for (int i = 0; i < 64; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table16, i);
+				long *slots = (long *) page->getBytes();
+				for (int c = 0; c < numProcs; c++)
+					if (slots[c] != expected[i][c]) flag24 = false;
+			}
+		}
+
+		// the segment is gone, and the counts made it to the file
+		if (shm_open(options.sharedBuffer.c_str(), O_RDWR, 0666) != -1) flag24 = false;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		for (int i = 0; i < 64; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table16, i);
+			long *slots = (long *) page->getBytes();
+			for (int c = 0; c < numProcs; c++)
+				if (slots[c] != expected[i][c]) flag24 = false;
+		}
+		if (flag24) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag24);
 }
 
 #endif
@@ -41,7 +41,7 @@ public:
 	void putIntList (string key, vector <int> value);
 	void putDouble (string key, double value);
 	void putDoubleList (string key, vector <double> value);
-	void putLong (string key, vector <long> value);
+	void putLong (string key, long value);
 
 	// creates an instance of the catalog.  If the specified file does
 	// not exist, it is created.  Otherwise, the existing file is 
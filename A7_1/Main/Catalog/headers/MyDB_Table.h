@@ -44,6 +44,11 @@ public:
 	// get the storage location of the table
 	string &getStorageLoc ();
 
+	// get a small numeric id for this table; every table object with the same
+	// name gets the same id, so the id is stable for the life of the process.
+	// The id 0 is never handed out (the buffer manager uses it for temp pages)
+	size_t getId ();
+
 	// gete the schema for this table
 	MyDB_SchemaPtr getSchema ();
 
@@ -55,8 +60,9 @@ public:
 
 	// return the last page in the table; -1 if there has never been anything
 	// written to the table (the table has just been initialized and setLastPage
-	// has never been called)
-	int lastPage ();
+	// has never been called).  Page numbers are 64 bits, so a table can have more
+	// than 2^31 pages
+	long lastPage ();
 
 	// set the last page
 	void setLastPage (size_t lastPage);
@@ -75,8 +81,8 @@ public:
 	string &getFileType ();
 
 	// get/set the root location
-	void setRootLocation (int toMe);
-	int getRootLocation ();
+	void setRootLocation (long toMe);
+	long getRootLocation ();
 
         // get the distinct value count for an attribute
         size_t getDistinctValues (string forMe);
@@ -95,7 +101,7 @@ private:
 	vector <size_t> allCounts;
 
 	// the number of tuples
-	int count;
+	size_t count;
 
 	// the name of the sort att
 	string sortAtt;
@@ -104,7 +110,7 @@ private:
 	string fileType;
 	
 	// the last used page in the table
-	int last;
+	long last;
 
 	// the name of the table
 	string tableName;
@@ -116,7 +122,10 @@ private:
 	MyDB_SchemaPtr mySchema;
 
 	// location of the root node
-	int rootLocation;
+	long rootLocation;
+
+	// the numeric id of this table; 0 until getId () is first called
+	size_t id;
 };
 
 #endif
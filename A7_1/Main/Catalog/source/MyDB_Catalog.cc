@@ -33,6 +33,12 @@ void MyDB_Catalog :: putInt (string key, int value) {
 	myData [key] = convert.str ();
 }
 
+void MyDB_Catalog :: putLong (string key, long value) {
+	ostringstream convert;
+	convert << value;
+	myData [key] = convert.str ();
+}
+
 bool MyDB_Catalog :: getStringList (string key, vector <string> &returnVal) {
 
 	// verify the entry is in the map
@@ -75,6 +81,25 @@ bool MyDB_Catalog :: getInt (string key, int &value) {
 	return true;
 }
 
+bool MyDB_Catalog :: getLong (string key, long &value) {
+
+	// verify the entry is in the map
+	if (myData.count (key) == 0)
+		return false;
+
+	// it is, so convert it to a long
+	string :: size_type sz;
+	try {
+		value = std::stol (myData [key], &sz);
+
+	// exception means that we could not convert
+	} catch (...) {
+		return false;
+	}
+	
+	return true;
+}
+
 MyDB_Catalog :: MyDB_Catalog (string fNameIn) {
 
 	// remember the catalog name
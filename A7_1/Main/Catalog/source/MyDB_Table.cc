@@ -3,6 +3,8 @@
 #define TABLE_C
 
 #include "MyDB_Table.h"
+#include <mutex>
+#include <unordered_map>
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn) {
 	tableName = name;
@@ -11,6 +13,7 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn) {
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	id = 0;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn) {
@@ -21,6 +24,7 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	id = 0;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn, string fileTypeIn, string sortAttIn) {
@@ -31,6 +35,7 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = fileTypeIn;
 	sortAtt = sortAttIn;
 	rootLocation = -1;
+	id = 0;
 }
 
 MyDB_Table :: ~MyDB_Table () {}
@@ -63,11 +68,11 @@ size_t MyDB_Table :: getTupleCount () {
         return count;
 }
 
-void MyDB_Table :: setRootLocation (int toMe) {
+void MyDB_Table :: setRootLocation (long toMe) {
 	rootLocation = toMe;
 }
 
-int MyDB_Table :: getRootLocation () {
+long MyDB_Table :: getRootLocation () {
 	return rootLocation;
 }
 
@@ -83,6 +88,24 @@ string &MyDB_Table :: getStorageLoc () {
 	return storageLoc;
 }
 
+size_t MyDB_Table :: getId () {
+
+	// the id is cached after the first lookup
+	if (id != 0)
+		return id;
+
+	// all of the names that have been given an id so far
+	static unordered_map <string, size_t> allIds;
+	static mutex allIdsLatch;
+	lock_guard <mutex> guard (allIdsLatch);
+	auto res = allIds.find (tableName);
+	if (res == allIds.end ()) 
+		res = allIds.insert (make_pair (tableName, allIds.size () + 1)).first;
+
+	id = res->second;
+	return id;
+}
+
 map <string, MyDB_TablePtr> MyDB_Table :: getAllTables (MyDB_CatalogPtr fromMe) {
 
 	map <string, MyDB_TablePtr> returnVal;
@@ -102,20 +125,23 @@ map <string, MyDB_TablePtr> MyDB_Table :: getAllTables (MyDB_CatalogPtr fromMe)
 	return returnVal;
 }
 
-MyDB_Table :: MyDB_Table () {}
+MyDB_Table :: MyDB_Table () {
+	id = 0;
+}
 
-int MyDB_Table :: lastPage () {
+long MyDB_Table :: lastPage () {
 	return last;
 }
 
 void MyDB_Table :: setLastPage (size_t toMe) {
-	last = (int) toMe;	
+	last = (long) toMe;	
 }
 
 bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 	
 	// get the storage location
 	tableName = tableNameIn;
+	id = 0;
         if (!catalog->getString (tableName + ".fileName", storageLoc)) {
 		return false;
 	}
@@ -125,7 +151,7 @@ bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 	mySchema->fromCatalog (tableName, catalog);
 
 	// get the size
-        catalog->getInt (tableName + ".lastPage", last);
+        catalog->getLong (tableName + ".lastPage", last);
 
 	// get the type
 	catalog->getString (tableName + ".fileType", fileType);
@@ -134,7 +160,7 @@ bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 	catalog->getString (tableName + ".sortAtt", sortAtt);
 
 	// get the root
-	catalog->getInt (tableName + ".rootLocation", rootLocation);
+	catalog->getLong (tableName + ".rootLocation", rootLocation);
 
 	// get the number of distinct attribute vals
 	allCounts.clear ();
@@ -144,7 +170,9 @@ bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 		allCounts.push_back (stoull(a));
 
 	// get the number of tuples
-	catalog->getInt (tableName + ".numTuples", count);
+	long numTuples = 0;
+	catalog->getLong (tableName + ".numTuples", numTuples);
+	count = numTuples;
 
 	return true;
 }
@@ -174,7 +202,7 @@ void MyDB_Table :: putInCatalog (MyDB_CatalogPtr catalog) {
 	catalog->putString (tableName + ".fileType", fileType);
 
 	// and the root location
-	catalog->putInt (tableName + ".rootLocation", rootLocation);
+	catalog->putLong (tableName + ".rootLocation", rootLocation);
 
 	// remember the number of distinct attribute vals
 	vector <string> temp;
@@ -183,13 +211,13 @@ void MyDB_Table :: putInCatalog (MyDB_CatalogPtr catalog) {
 	catalog->putStringList (tableName + ".valCounts", temp);
 
 	// remember the number of tuples
-	catalog->putInt (tableName + ".numTuples", count);
+	catalog->putLong (tableName + ".numTuples", count);
 
 	// and the sort att
 	catalog->putString (tableName + ".sortAtt", sortAtt);
 
 	// remember the last page in the file
-        catalog->putInt (tableName + ".lastPage", last);
+        catalog->putLong (tableName + ".lastPage", last);
 
 	// and add the schema in 
 	mySchema->putInCatalog (tableName, catalog);	
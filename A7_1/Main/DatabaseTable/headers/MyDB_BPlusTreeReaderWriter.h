@@ -47,13 +47,13 @@ private:
 
 	// gets a list of pages that might have data for an iterator... any leaf page that can possibly
 	// have a value in the range [low, high], inclusive should be returned from this call
-	bool discoverPages (int whichPage, vector <MyDB_PageReaderWriter> &list,
+	bool discoverPages (long whichPage, vector <MyDB_PageReaderWriter> &list,
         	MyDB_AttValPtr low, MyDB_AttValPtr high);
 
 	// appends a record to the named page; if there is a split, then an MyDB_INRecordPtr is returned that
 	// points to the record holding the (key, ptr) pair pointing to the new page.  Note that the new page
 	// always holds the lower 1/2 of the records on the page; the upper 1/2 remains in the original page
-	MyDB_RecordPtr append (int whichPage, MyDB_RecordPtr appendMe);
+	MyDB_RecordPtr append (long whichPage, MyDB_RecordPtr appendMe);
 
 	// splits the given page (plus the record andMe) around the median.  A MyDB_INRecordPtr is returned that
 	// points to the record holding the (key, ptr) pair pointing to the new page.  Note that the new page
@@ -67,7 +67,7 @@ private:
 	MyDB_AttValPtr getKey (MyDB_RecordPtr fromMe);
 
 	// recurive helper for printing the file
-	void printTree (int whichPage, int depth);
+	void printTree (long whichPage, int depth);
 
 	// constructs an returns a comparator for the two records given... both must either be IN records for this particular
 	// tree, or they must be LN records for this tree, or a combination.  The resulting comparator returns true if and
@@ -75,7 +75,7 @@ private:
 	function <bool ()> buildComparator (MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 
 	// the location (page number) of the root in the tree
-	int rootLocation;
+	long rootLocation;
 
 	// the type of the attribute that we are ordering on
 	MyDB_AttTypePtr orderingAttType;
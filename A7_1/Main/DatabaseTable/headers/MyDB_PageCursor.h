@@ -0,0 +1,64 @@
+
+#ifndef PAGE_CURSOR_H
+#define PAGE_CURSOR_H
+
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableReaderWriter.h"
+
+using namespace std;
+
+// a cursor over the pages of a table.  It is a plain value (it is meant to live on the
+// stack, or inside of an iterator) that holds on to the page it is on, so moving it to
+// another page just swaps the page handle, and asking about the page it is already on
+// costs nothing; no page reader/writer is allocated along the way.  The page that the
+// cursor is on is not pinned, unless pin () is called
+class MyDB_PageCursor {
+
+public:
+
+	// a cursor over the pages of the table; it is not on any page yet
+	MyDB_PageCursor (MyDB_TableReaderWriter &parent);
+
+	// like the above, except that the pages are read in (if they are not buffered)
+	// through the given access strategy
+	MyDB_PageCursor (MyDB_TableReaderWriter &parent, MyDB_AccessStrategyPtr strategy);
+
+	// moves the cursor to the i^th page of the table (if it is not there already), and
+	// returns the page; this does not add pages to the table
+	MyDB_PageReaderWriter &moveTo (size_t i);
+
+	// moves the cursor to the last page of the table
+	MyDB_PageReaderWriter &moveToLast ();
+
+	// pins the page that the cursor is on (through the grant, if there is one) until the
+	// cursor moves off of it or unpin () is called; returns false if it cannot be pinned
+	bool pin ();
+	bool pin (MyDB_ReservationPtr grant);
+
+	// lets the buffer manager write the page out again if it needs the room
+	void unpin ();
+
+	// true if the cursor is on a page, and that page is pinned by the cursor
+	bool isPinned ();
+
+	// the page that the cursor is on, and its number (which is -1 if the cursor is not
+	// on a page)
+	MyDB_PageReaderWriter &operator * ();
+	MyDB_PageReaderWriter *operator -> ();
+	long getPageNum ();
+
+	// gets the type of the page the cursor is on
+	MyDB_PageType getType ();
+
+private:
+
+	MyDB_TableReaderWriter &parent;
+	MyDB_AccessStrategyPtr strategy;
+
+	// the page, which has a null handle until the cursor is moved to a page
+	MyDB_PageReaderWriter current;
+	long pageNum;
+	bool pinned;
+};
+
+#endif
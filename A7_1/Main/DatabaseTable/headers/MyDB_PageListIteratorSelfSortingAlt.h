@@ -20,6 +20,10 @@ public:
 		myIter->getCurrent (intoMe);
 	}
 
+        void getCurrentView (MyDB_RecordPtr intoMe) override {
+		myIter->getCurrentView (intoMe);
+	}
+
         // after a call to advance (), a call to getCurrentPointer () will get the address
         // of the record.  At a later time, it is then possible to reconstitute the record
         // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
@@ -34,7 +38,7 @@ public:
         bool advance () override {
 		while (true) {
 			if (myIter->advance ()) {
-				myIter->getCurrent (myRec);
+				myIter->getCurrentView (myRec);
 				if (!lowComparator () && !highComparator ()) {
 					return true;
 				}
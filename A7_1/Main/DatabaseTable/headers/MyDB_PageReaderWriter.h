@@ -28,10 +28,17 @@ class MyDB_PageReaderWriter {
 public:
 
 	// constructor for a page in the same file as the parent
-	MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, int whichPage);
+	MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, long whichPage);
+
+	// constructor for a page in the same file as the parent, which is read in (if it
+	// is not buffered) through the given access strategy
+	MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, long whichPage, MyDB_AccessStrategyPtr strategy);
 
 	// constructor for a page that can be pinned, if desired
-	MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWriter &parent, int whichPage);
+	MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWriter &parent, long whichPage);
+
+	// constructor for a page that is pinned, and counts against the given grant
+	MyDB_PageReaderWriter (MyDB_ReservationPtr grant, MyDB_TableReaderWriter &parent, long whichPage);
 
 	// constructor for an anonymous page
 	MyDB_PageReaderWriter (MyDB_BufferManager &parent);
@@ -39,6 +46,12 @@ public:
 	// constructor for an anonymous page that can be pinned, if desired
 	MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager &parent);
 
+	// constructor for an anonymous pinned page that counts against the given grant
+	MyDB_PageReaderWriter (MyDB_ReservationPtr grant, MyDB_BufferManager &parent);
+
+	// constructor for an anonymous page that is the next page of the given temp run
+	MyDB_PageReaderWriter (MyDB_BufferManager &parent, MyDB_TempRunPtr run);
+
 	// empties out the contents of this page, so that it has no records in it
 	// the type of the page is set to MyDB_PageType :: RegularPage
 	void clear ();	
@@ -88,6 +101,11 @@ public:
 
 private:
 
+	friend class MyDB_PageCursor;
+
+	// constructor for a page that we already have a handle to
+	MyDB_PageReaderWriter (MyDB_PageHandle myPage, size_t pageSize);
+
 	// this is the page that we are messing with
 	MyDB_PageHandle myPage;	
 	
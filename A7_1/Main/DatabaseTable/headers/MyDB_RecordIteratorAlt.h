@@ -20,6 +20,14 @@ public:
 	// load the current record into the parameter
 	virtual void getCurrent (MyDB_RecordPtr intoMe) = 0;
 
+	// like getCurrent (), but the record is loaded with MyDB_Record.fromView (), so that
+	// only the attributes that are used are read from the page; the record can only be
+	// used until the page might be swapped out (that is, until the buffer is used for
+	// something else).  An iterator that cannot do this just calls getCurrent ()
+	virtual void getCurrentView (MyDB_RecordPtr intoMe) {
+		getCurrent (intoMe);
+	}
+
         // after a call to advance (), a call to getCurrentPointer () will get the address
         // of the record.  At a later time, it is then possible to reconstitute the record
         // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
@@ -31,6 +39,18 @@ public:
 	// be called until after getCurrent () has been called
 	virtual bool advance () = 0;
 
+	// instead of advance (): puts where the next (up to) maxRecs records are into recs,
+	// and returns how many there were, or zero if there are no more.  The records are
+	// all on one page, which stays put until getBatch () is called again; the last of
+	// them is then the current record.  An iterator that cannot do this gives one
+	// record at a time
+	virtual int getBatch (void **recs, int maxRecs) {
+		if (maxRecs == 0 || !advance ())
+			return 0;
+		recs[0] = getCurrentPointer ();
+		return 1;
+	}
+
 	// destructor and contructor
 	MyDB_RecordIteratorAlt () {};
 	virtual ~MyDB_RecordIteratorAlt () {};
@@ -24,6 +24,7 @@
 
 // create a smart pointer for the catalog
 using namespace std;
+class MyDB_PageCursor;
 class MyDB_PageReaderWriter;
 class MyDB_TableReaderWriter;
 typedef shared_ptr <MyDB_TableReaderWriter> MyDB_TableReaderWriterPtr;
@@ -46,14 +47,27 @@ public:
 	// by iterateIntoMe
 	MyDB_RecordIteratorPtr getIterator (MyDB_RecordPtr iterateIntoMe);
 
+	// like the above, except that the pages are read through the given access
+	// strategy (see getBulkReadStrategy)
+	MyDB_RecordIteratorPtr getIterator (MyDB_RecordPtr iterateIntoMe, MyDB_AccessStrategyPtr strategy);
+
         // gets an instance of an alternate iterator over the table... this is an
         // iterator that has the alternate getCurrent ()/advance () interface
         MyDB_RecordIteratorAltPtr getIteratorAlt ();
 
+	// like the above, except that the pages are read through the given access
+	// strategy (see getBulkReadStrategy)
+	MyDB_RecordIteratorAltPtr getIteratorAlt (MyDB_AccessStrategyPtr strategy);
+
+	// gets the access strategy that a one-time scan over the whole table should use,
+	// so that if the table is big, the scan does not push everything else out of the
+	// buffer; this is a nullptr if the table is small
+	MyDB_AccessStrategyPtr getBulkReadStrategy ();
+
 	// gets an instance of an alternate iterator over the page; this iterator
 	// works on a range of pages in the file, and iterates from lowPage through
 	// highPage inclusive
-	MyDB_RecordIteratorAltPtr getIteratorAlt (int lowPage, int highPage);
+	MyDB_RecordIteratorAltPtr getIteratorAlt (long lowPage, long highPage);
 
 	// load a text file into this table... this returns a pair where the first
 	// entry is a list of (approximate) distinct value counts for each of the
@@ -64,17 +78,27 @@ public:
 	// dump the contents of this table into a text file
 	void writeIntoTextFile (string toMe);
 
-	// access the i^th page in this file
+	// access the i^th page in this file; the page that is returned is only good
+	// until the next call to this (or to last ()).  Code that goes through the pages
+	// one at a time should use a MyDB_PageCursor instead
 	MyDB_PageReaderWriter &operator [] (size_t i);
 
+	// access the i^th page in this file, reading it in (if it is not buffered)
+	// through the given access strategy
+	MyDB_PageReaderWriter getPage (size_t i, MyDB_AccessStrategyPtr strategy);
+
 	// access the i^th page in this file... getting a pinned version of the page
 	MyDB_PageReaderWriter getPinned (size_t i);
 
+	// like the above, except that the pinned page counts against the given grant;
+	// the grant must not be used up
+	MyDB_PageReaderWriter getPinned (size_t i, MyDB_ReservationPtr grant);
+
 	// access the last page in the file
 	MyDB_PageReaderWriter &last ();
 
 	// get the number of pages in the file
-	int getNumPages ();
+	long getNumPages ();
 
 	// get access to the buffer manager	
 	MyDB_BufferManagerPtr getBufferMgr ();
@@ -88,11 +112,15 @@ public:
 private:
 
 	friend class MyDB_PageReaderWriter;
+	friend class MyDB_PageCursor;
 	friend class MyDB_BPlusTreeReaderWriter;
 	MyDB_TablePtr forMe;
 	MyDB_BufferManagerPtr myBuffer;
-	shared_ptr <MyDB_PageReaderWriter> arrayAccessBuffer;
-	shared_ptr <MyDB_PageReaderWriter> lastPage;
+
+	// the page returned by operator [] and last (), and the page being appended to;
+	// these are made once, and then just moved from page to page
+	shared_ptr <MyDB_PageCursor> arrayAccessBuffer;
+	shared_ptr <MyDB_PageCursor> lastPage;
 	
 };
 
@@ -13,6 +13,7 @@
 #ifndef TABLE_REC_ITER_H
 #define TABLE_REC_ITER_H
 
+#include "MyDB_PageCursor.h"
 #include "MyDB_RecordIterator.h"
 #include "MyDB_Record.h"
 #include "MyDB_TableReaderWriter.h"
@@ -37,18 +38,21 @@ public:
 
 	// destructor and contructor
 	MyDB_TableRecIterator (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
-        	MyDB_RecordPtr myRecIn);
+        	MyDB_RecordPtr myRecIn, MyDB_AccessStrategyPtr strategy);
 	~MyDB_TableRecIterator ();
 
 private:
 
 	MyDB_RecordIteratorPtr myIter;
-	int curPage;
+	long curPage;
 	
-	MyDB_TableReaderWriter &myParent;
 	MyDB_TablePtr myTable;
         MyDB_RecordPtr myRec;
 
+	// this is on the page being iterated over (its pages are read through the access
+	// strategy, if there is one)
+	MyDB_PageCursor cursor;
+
 };
 
 #endif
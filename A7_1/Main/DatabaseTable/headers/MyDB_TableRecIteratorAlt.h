@@ -13,6 +13,7 @@
 #ifndef TABLE_REC_ITER_ALT_H
 #define TABLE_REC_ITER_ALT_H
 
+#include "MyDB_PageCursor.h"
 #include "MyDB_RecordIteratorAlt.h"
 #include "MyDB_Record.h"
 #include "MyDB_TableReaderWriter.h"
@@ -25,6 +26,8 @@ public:
         // load the current record into the parameter
         void getCurrent (MyDB_RecordPtr intoMe) override;
 
+        void getCurrentView (MyDB_RecordPtr intoMe) override;
+
         // after a call to advance (), a call to getCurrentPointer () will get the address
         // of the record.  At a later time, it is then possible to reconstitute the record
         // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
@@ -36,18 +39,23 @@ public:
         // be called until after getCurrent () has been called
         bool advance () override;
 
+        int getBatch (void **recs, int maxRecs) override;
+
 	// destructor and contructor
-	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn);
+	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, MyDB_AccessStrategyPtr strategy);
 	~MyDB_TableRecIteratorAlt ();
-	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, int lowPage, int highPage);
+	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, long lowPage, long highPage);
 
 private:
 
 	MyDB_RecordIteratorAltPtr myIter;
-	int curPage;
-	int highPage;	
-	MyDB_TableReaderWriter &myParent;
+	long curPage;
+	long highPage;
 	MyDB_TablePtr myTable;
+
+	// this is on the page being iterated over (its pages are read through the access
+	// strategy, if there is one); it pins the page once a batch is taken from it
+	MyDB_PageCursor cursor;
 };
 
 #endif
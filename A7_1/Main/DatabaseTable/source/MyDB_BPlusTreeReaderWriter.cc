@@ -75,7 +75,7 @@ MyDB_RecordIteratorAltPtr MyDB_BPlusTreeReaderWriter :: getRangeIteratorAlt (MyD
 }
 
 
-bool MyDB_BPlusTreeReaderWriter :: discoverPages (int whichPage, vector <MyDB_PageReaderWriter> &list,
+bool MyDB_BPlusTreeReaderWriter :: discoverPages (long whichPage, vector <MyDB_PageReaderWriter> &list,
 	MyDB_AttValPtr low, MyDB_AttValPtr high) {
 
 	// figure out the page to search
@@ -169,7 +169,7 @@ void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 		if (res != nullptr) {
 
 			// add another page to the file
-			int newRootLoc = getTable ()->lastPage () + 1;
+			long newRootLoc = getTable ()->lastPage () + 1;
 			getTable ()->setLastPage (newRootLoc);
 			MyDB_PageReaderWriter newRoot = (*this)[newRootLoc];
 			newRoot.clear ();
@@ -193,7 +193,7 @@ void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: split (MyDB_PageReaderWriter splitMe, MyDB_RecordPtr andMe) {
 	
 	// get a new page for the lower one half
-	int newPageLoc = getTable ()->lastPage () + 1;
+	long newPageLoc = getTable ()->lastPage () + 1;
 	getTable ()->setLastPage (newPageLoc);
 	MyDB_PageReaderWriter newPage = (*this)[newPageLoc];
 
@@ -277,7 +277,7 @@ MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: split (MyDB_PageReaderWriter splitM
 
 }
 
-MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: append (int whichPage, MyDB_RecordPtr appendMe) {
+MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: append (long whichPage, MyDB_RecordPtr appendMe) {
 
 	// figure out the page to add to
 	MyDB_PageReaderWriter pageToAddTo = (*this)[whichPage];
@@ -340,7 +340,7 @@ void MyDB_BPlusTreeReaderWriter :: printTree () {
 	printTree (rootLocation, 0);
 }
 
-void MyDB_BPlusTreeReaderWriter :: printTree (int whichPage, int depth) {
+void MyDB_BPlusTreeReaderWriter :: printTree (long whichPage, int depth) {
 
 	MyDB_PageReaderWriter pageToPrint = (*this)[whichPage];
 
@@ -387,38 +387,23 @@ MyDB_AttValPtr MyDB_BPlusTreeReaderWriter :: getKey (MyDB_RecordPtr fromMe) {
 
 function <bool ()>  MyDB_BPlusTreeReaderWriter :: buildComparator (MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
 
-	MyDB_AttValPtr lhAtt, rhAtt;
-
-	// in this case, the LHS is an IN record
-	if (lhs->getSchema () == nullptr) {
-		lhAtt = lhs->getAtt (0);	
-
-	// here, it is a regular data record
-	} else {
-		lhAtt = lhs->getAtt (whichAttIsOrdering);
-	}
-
-	// in this case, the LHS is an IN record
-	if (rhs->getSchema () == nullptr) {
-		rhAtt = rhs->getAtt (0);	
-
-	// here, it is a regular data record
-	} else {
-		rhAtt = rhs->getAtt (whichAttIsOrdering);
-	}
+	// the key of an IN record is its first attribute; a regular data record has it
+	// wherever the ordering attribute is.  The values are looked up each time, rather
+	// than once up front, so that a record that is loaded with fromView () reads its key
+	int lhAtt = (lhs->getSchema () == nullptr) ? 0 : whichAttIsOrdering;
+	int rhAtt = (rhs->getSchema () == nullptr) ? 0 : whichAttIsOrdering;
 	
 	// now, build the comparison lambda and return
 	if (orderingAttType->promotableToInt ()) {
-		return [lhAtt, rhAtt] {return lhAtt->toInt () < rhAtt->toInt ();};
+		return [lhs, lhAtt, rhs, rhAtt] {return lhs->getValue (lhAtt).toInt () < rhs->getValue (rhAtt).toInt ();};
 	} else if (orderingAttType->promotableToDouble ()) {
-		return [lhAtt, rhAtt] {return lhAtt->toDouble () < rhAtt->toDouble ();};
+		return [lhs, lhAtt, rhs, rhAtt] {return lhs->getValue (lhAtt).toDouble () < rhs->getValue (rhAtt).toDouble ();};
 	} else if (orderingAttType->promotableToString ()) {
-		return [lhAtt, rhAtt] {return lhAtt->toString () < rhAtt->toString ();};
+		return [lhs, lhAtt, rhs, rhAtt] {return strcmp (lhs->getValue (lhAtt).getChars (), rhs->getValue (rhAtt).getChars ()) < 0;};
 	} else {
 		cout << "This is bad... cannot do anything with the >.\n";
 		exit (1);
 	}
 }
 
-
 #endif
@@ -0,0 +1,80 @@
+
+#ifndef PAGE_CURSOR_C
+#define PAGE_CURSOR_C
+
+#include "MyDB_PageCursor.h"
+
+MyDB_PageCursor :: MyDB_PageCursor (MyDB_TableReaderWriter &parentIn) :
+	MyDB_PageCursor (parentIn, nullptr) {}
+
+MyDB_PageCursor :: MyDB_PageCursor (MyDB_TableReaderWriter &parentIn, MyDB_AccessStrategyPtr strategyIn) :
+	parent (parentIn), strategy (strategyIn), current (MyDB_PageHandle (), parentIn.myBuffer->getPageSize ()) {
+	pageNum = -1;
+	pinned = false;
+}
+
+MyDB_PageReaderWriter &MyDB_PageCursor :: moveTo (size_t i) {
+	if (pageNum == (long) i)
+		return current;
+
+	// the new handle replaces the old one, which lets go of the old page
+	current.myPage = parent.myBuffer->getPage (parent.forMe, i, strategy);
+	pageNum = i;
+	pinned = false;
+	return current;
+}
+
+MyDB_PageReaderWriter &MyDB_PageCursor :: moveToLast () {
+	return moveTo (parent.forMe->lastPage ());
+}
+
+bool MyDB_PageCursor :: pin () {
+	return pin (nullptr);
+}
+
+bool MyDB_PageCursor :: pin (MyDB_ReservationPtr grant) {
+	if (pageNum == -1)
+		return false;
+	if (pinned)
+		return true;
+
+	MyDB_PageHandle pinnedPage = parent.myBuffer->getPinnedPage (parent.forMe, pageNum, grant);
+	if (pinnedPage == nullptr)
+		return false;
+	current.myPage = move (pinnedPage);
+	pinned = true;
+	return true;
+}
+
+void MyDB_PageCursor :: unpin () {
+	if (!pinned)
+		return;
+
+	// once the pinned handle is gone (if it is the last one), the page can be written
+	// out; then we get an ordinary handle to it
+	current.myPage = nullptr;
+	current.myPage = parent.myBuffer->getPage (parent.forMe, pageNum, strategy);
+	pinned = false;
+}
+
+bool MyDB_PageCursor :: isPinned () {
+	return pinned;
+}
+
+MyDB_PageReaderWriter &MyDB_PageCursor :: operator * () {
+	return current;
+}
+
+MyDB_PageReaderWriter *MyDB_PageCursor :: operator -> () {
+	return &current;
+}
+
+long MyDB_PageCursor :: getPageNum () {
+	return pageNum;
+}
+
+MyDB_PageType MyDB_PageCursor :: getType () {
+	return current.getType ();
+}
+
+#endif
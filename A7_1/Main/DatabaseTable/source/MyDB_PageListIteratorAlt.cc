@@ -20,6 +20,10 @@ void MyDB_PageListIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
 	myIter->getCurrent (intoMe);
 }
 
+void MyDB_PageListIteratorAlt :: getCurrentView (MyDB_RecordPtr intoMe) {
+	myIter->getCurrentView (intoMe);
+}
+
 bool MyDB_PageListIteratorAlt :: advance () {
 
 	if (myIter->advance ())
@@ -24,14 +24,22 @@
 #define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
 #define NUM_BYTES_LEFT (pageSize - NUM_BYTES_USED)
 
-MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, int whichPage) {
+MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, long whichPage) {
 
 	// get the actual page
 	myPage = parent.getBufferMgr ()->getPage (parent.getTable (), whichPage);
 	pageSize = parent.getBufferMgr ()->getPageSize ();
 }
 
-MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWriter &parent, int whichPage) {
+MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, long whichPage, 
+	MyDB_AccessStrategyPtr strategy) {
+
+	// get the actual page
+	myPage = parent.getBufferMgr ()->getPage (parent.getTable (), whichPage, strategy);
+	pageSize = parent.getBufferMgr ()->getPageSize ();
+}
+
+MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWriter &parent, long whichPage) {
 
 	// get the actual page
 	if (pinned) {
@@ -42,6 +50,18 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWri
 	pageSize = parent.getBufferMgr ()->getPageSize ();
 }
 
+MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_ReservationPtr grant, MyDB_TableReaderWriter &parent, long whichPage) {
+
+	// get the actual page
+	myPage = parent.getBufferMgr ()->getPinnedPage (parent.getTable (), whichPage, grant);
+	pageSize = parent.getBufferMgr ()->getPageSize ();
+}
+
+MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_PageHandle myPageIn, size_t pageSizeIn) {
+	myPage = move (myPageIn);
+	pageSize = pageSizeIn;
+}
+
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_BufferManager &parent) {
 	myPage = parent.getPage ();	
 	pageSize = parent.getPageSize ();
@@ -59,6 +79,18 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager
 	clear ();
 }
 
+MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_ReservationPtr grant, MyDB_BufferManager &parent) {
+	myPage = parent.getPinnedPage (grant);
+	pageSize = parent.getPageSize ();
+	clear ();
+}
+
+MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_BufferManager &parent, MyDB_TempRunPtr run) {
+	myPage = parent.getPage (run);
+	pageSize = parent.getPageSize ();
+	clear ();
+}
+
 void MyDB_PageReaderWriter :: clear () {
 	NUM_BYTES_USED = 2 * sizeof (size_t);
 	PAGE_TYPE = MyDB_PageType :: RegularPage;
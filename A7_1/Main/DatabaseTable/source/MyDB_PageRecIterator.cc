@@ -34,7 +34,7 @@ bool MyDB_PageRecIterator :: hasNext () {
 
 MyDB_PageRecIterator :: MyDB_PageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn) {
 	bytesConsumed = sizeof (size_t) * 2;
-	myPage = myPageIn;
+	myPage = move (myPageIn);
 	myRec = myRecIn;
 }
 
@@ -24,6 +24,12 @@ void MyDB_PageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
 	nextRecSize = ((char *) nextPos) - ((char *) pos);	
 }
 
+void MyDB_PageRecIteratorAlt :: getCurrentView (MyDB_RecordPtr intoMe) {
+	void *pos = bytesConsumed + (char *) myPage->getBytes ();
+ 	void *nextPos = intoMe->fromView (pos);
+	nextRecSize = ((char *) nextPos) - ((char *) pos);	
+}
+
 void *MyDB_PageRecIteratorAlt :: getCurrentPointer () {
 	return bytesConsumed + (char *) myPage->getBytes ();
 }
@@ -38,9 +44,28 @@ bool MyDB_PageRecIteratorAlt :: advance () {
 	return bytesConsumed != NUM_BYTES_USED;
 }
 
+int MyDB_PageRecIteratorAlt :: getBatch (void **recs, int maxRecs) {
+	if (nextRecSize == -1) {
+		cout << "You can't call getBatch without calling getCurrent!!\n";
+		exit (1);
+	}
+
+	// every record starts with its size, so the records can just be walked over
+	char *bytes = (char *) myPage->getBytes ();
+	size_t pos = bytesConsumed + nextRecSize;
+	int numRecs = 0;
+	while (numRecs < maxRecs && pos != NUM_BYTES_USED) {
+		recs[numRecs++] = bytes + pos;
+		bytesConsumed = pos;
+		nextRecSize = *((short *) (bytes + pos));
+		pos += nextRecSize;
+	}
+	return numRecs;
+}
+
 MyDB_PageRecIteratorAlt :: MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn) {
 	bytesConsumed = sizeof (size_t) * 2;
-	myPage = myPageIn;
+	myPage = move (myPageIn);
 	nextRecSize = 0;
 }
 
@@ -16,6 +16,7 @@
 #include <fstream>
 #include <limits>
 #include <queue>
+#include "MyDB_PageCursor.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
@@ -29,13 +30,14 @@ using namespace std;
 MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TablePtr forMeIn, MyDB_BufferManagerPtr myBufferIn) {
 	forMe = forMeIn;
 	myBuffer = myBufferIn;
+	arrayAccessBuffer = make_shared <MyDB_PageCursor> (*this);
+	lastPage = make_shared <MyDB_PageCursor> (*this);
 
 	if (forMe->lastPage () == -1) {
 		forMe->setLastPage (0);
-		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-		lastPage->clear ();
+		lastPage->moveToLast ().clear ();
 	} else {
-		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());	
+		lastPage->moveToLast ();
 	}
 }
 
@@ -47,7 +49,7 @@ MyDB_TablePtr MyDB_TableReaderWriter :: getTable () {
 	return forMe;
 }
 
-int MyDB_TableReaderWriter :: getNumPages () {
+long MyDB_TableReaderWriter :: getNumPages () {
 	return forMe->lastPage () + 1;
 }
 
@@ -55,18 +57,28 @@ MyDB_PageReaderWriter MyDB_TableReaderWriter :: getPinned (size_t i) {
 	return MyDB_PageReaderWriter (true, *this, i);
 }
 
+MyDB_PageReaderWriter MyDB_TableReaderWriter :: getPinned (size_t i, MyDB_ReservationPtr grant) {
+	return MyDB_PageReaderWriter (grant, *this, i);
+}
+
+MyDB_PageReaderWriter MyDB_TableReaderWriter :: getPage (size_t i, MyDB_AccessStrategyPtr strategy) {
+	return MyDB_PageReaderWriter (*this, i, strategy);
+}
+
+MyDB_AccessStrategyPtr MyDB_TableReaderWriter :: getBulkReadStrategy () {
+	return myBuffer->getBulkReadStrategy (forMe);
+}
+
 MyDB_PageReaderWriter &MyDB_TableReaderWriter :: operator [] (size_t i) {
 	
 	// see if we are going off of the end of the file... if so, then clear those pages
-	while (i > forMe->lastPage ()) {
+	while ((long) i > forMe->lastPage ()) {
 		forMe->setLastPage (forMe->lastPage () + 1);
-		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-		lastPage->clear ();	
+		lastPage->moveToLast ().clear ();	
 	}
 
 	// now get the page
-	arrayAccessBuffer = make_shared <MyDB_PageReaderWriter> (*this, i);
-	return *arrayAccessBuffer;
+	return arrayAccessBuffer->moveTo (i);
 }
 
 MyDB_RecordPtr MyDB_TableReaderWriter :: getEmptyRecord () {
@@ -76,20 +88,18 @@ MyDB_RecordPtr MyDB_TableReaderWriter :: getEmptyRecord () {
 }
 
 MyDB_PageReaderWriter &MyDB_TableReaderWriter :: last () {
-	arrayAccessBuffer = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-	return *arrayAccessBuffer;
+	return arrayAccessBuffer->moveToLast ();
 }
 
 void MyDB_TableReaderWriter :: append (MyDB_RecordPtr appendMe) {
 
 	// try to append the record on the current page...
-	if (!lastPage->append (appendMe)) {
+	if (!(*lastPage)->append (appendMe)) {
 
 		// if we cannot, then get a new last page and append
 		forMe->setLastPage (forMe->lastPage () + 1);
-		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-		lastPage->clear ();
-		lastPage->append (appendMe);
+		lastPage->moveToLast ().clear ();
+		(*lastPage)->append (appendMe);
 	}
 }
 
@@ -97,8 +107,7 @@ pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (stri
 
 	// empty out the database file
 	forMe->setLastPage (0);
-	lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-	lastPage->clear ();
+	lastPage->moveToLast ().clear ();
 
 	// try to open the file
 	string line;
@@ -162,14 +171,22 @@ pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (stri
 }
 
 MyDB_RecordIteratorPtr MyDB_TableReaderWriter :: getIterator (MyDB_RecordPtr iterateIntoMe) {
-	return make_shared <MyDB_TableRecIterator> (*this, forMe, iterateIntoMe);
+	return make_shared <MyDB_TableRecIterator> (*this, forMe, iterateIntoMe, nullptr);
+}
+
+MyDB_RecordIteratorPtr MyDB_TableReaderWriter :: getIterator (MyDB_RecordPtr iterateIntoMe, MyDB_AccessStrategyPtr strategy) {
+	return make_shared <MyDB_TableRecIterator> (*this, forMe, iterateIntoMe, strategy);
 }
 
 MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt () {
-	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe);
+	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, nullptr);
+}
+
+MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (MyDB_AccessStrategyPtr strategy) {
+	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, strategy);
 }
 
-MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (int lowPage, int highPage) {
+MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (long lowPage, long highPage) {
 	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, lowPage, highPage);
 }
 
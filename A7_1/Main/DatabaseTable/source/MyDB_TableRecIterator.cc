@@ -25,23 +25,23 @@ void *MyDB_TableRecIterator :: getCurrentPointer () {
 }
 
 bool MyDB_TableRecIterator :: hasNext () {
-	if (myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->hasNext ())
+	if (cursor.getType () == MyDB_PageType :: RegularPage && myIter->hasNext ())
 		return true;
 
 	if (curPage == myTable->lastPage ())
 		return false;
 
 	curPage++;
-	myIter = myParent[curPage].getIterator (myRec);
+	myIter = cursor.moveTo (curPage).getIterator (myRec);
 	return hasNext ();
 }
 
 MyDB_TableRecIterator :: MyDB_TableRecIterator (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
-	MyDB_RecordPtr myRecIn) : myParent (myParent) {
+	MyDB_RecordPtr myRecIn, MyDB_AccessStrategyPtr strategyIn) : cursor (myParent, strategyIn) {
 	myTable = myTableIn;
 	myRec = myRecIn;
 	curPage = 0;
-	myIter = myParent[curPage].getIterator (myRec);		
+	myIter = cursor.moveTo (curPage).getIterator (myRec);		
 }
 
 MyDB_TableRecIterator :: ~MyDB_TableRecIterator () {}
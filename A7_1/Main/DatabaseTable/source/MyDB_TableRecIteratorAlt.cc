@@ -13,6 +13,7 @@
 #ifndef TABLE_REC_ITER_ALT_C
 #define TABLE_REC_ITER_ALT_C
 
+#include <climits>
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableRecIteratorAlt.h"
 
@@ -20,38 +21,67 @@ void MyDB_TableRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
 	myIter->getCurrent (intoMe);
 }
 
+void MyDB_TableRecIteratorAlt :: getCurrentView (MyDB_RecordPtr intoMe) {
+	myIter->getCurrentView (intoMe);
+}
+
 void *MyDB_TableRecIteratorAlt :: getCurrentPointer () {
 	return myIter->getCurrentPointer ();
 }
 
 bool MyDB_TableRecIteratorAlt :: advance () {
 
-	if (myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->advance ())
+	if (cursor.getType () == MyDB_PageType :: RegularPage && myIter->advance ())
 		return true;
 
 	if (curPage == myTable->lastPage () || curPage == highPage)
 		return false;
 
 	curPage++;
-	myIter = myParent[curPage].getIteratorAlt ();
+	myIter = cursor.moveTo (curPage).getIteratorAlt ();
 	return advance ();
 }
 
+int MyDB_TableRecIteratorAlt :: getBatch (void **recs, int maxRecs) {
+
+	// a batch never goes past the end of a page, since only one page is pinned.  The
+	// records are handed back where they are on the page, so the page is pinned until
+	// the cursor moves on to the next one (if it cannot be, the records come one at a
+	// time, as they would from advance ())
+	while (true) {
+		if (cursor.getType () == MyDB_PageType :: RegularPage) {
+			int numRecs = myIter->getBatch (recs, cursor.pin () ? maxRecs : 1);
+			if (numRecs > 0)
+				return numRecs;
+		}
+
+		if (curPage == myTable->lastPage () || curPage == highPage)
+			return 0;
+
+		curPage++;
+		myIter = cursor.moveTo (curPage).getIteratorAlt ();
+	}
+}
+
 MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
-	int lowPage, int highPageIn) :
-	myParent (myParent) {
+	long lowPage, long highPageIn) :
+	cursor (myParent) {
 	myTable = myTableIn;
 	curPage = lowPage;
 	highPage = highPageIn;
-	myIter = myParent[curPage].getIteratorAlt ();		
+
+	// operator [] adds the page to the table, if it is past the end
+	myParent[curPage];
+	myIter = cursor.moveTo (curPage).getIteratorAlt ();		
 }
 
-MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn) :
-	myParent (myParent) {
+MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
+	MyDB_AccessStrategyPtr strategyIn) :
+	cursor (myParent, strategyIn) {
 	myTable = myTableIn;
 	curPage = 0;
-	highPage = 1999999999;
-	myIter = myParent[curPage].getIteratorAlt ();		
+	highPage = LONG_MAX;
+	myIter = cursor.moveTo (curPage).getIteratorAlt ();		
 }
 
 MyDB_TableRecIteratorAlt :: ~MyDB_TableRecIteratorAlt () {}
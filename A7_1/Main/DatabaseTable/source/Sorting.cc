@@ -14,14 +14,14 @@
 using namespace std;
 
 void appendRecord (MyDB_PageReaderWriter &curPage, vector <MyDB_PageReaderWriter> &returnVal, 
-	MyDB_RecordPtr appendMe, MyDB_BufferManagerPtr parent) {
+	MyDB_RecordPtr appendMe, MyDB_BufferManagerPtr parent, MyDB_TempRunPtr run) {
 
 	// try to append to the current page
 	if (!curPage.append (appendMe)) {
 
 		// if we cannot, then add a new one to the output vector
 		returnVal.push_back (curPage);
-		MyDB_PageReaderWriter temp (*parent);
+		MyDB_PageReaderWriter temp (*parent, run);
 		temp.append (appendMe);
 		curPage = temp;
 	}
@@ -30,20 +30,22 @@ void appendRecord (MyDB_PageReaderWriter &curPage, vector <MyDB_PageReaderWriter
 vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter, 
 	MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
 	
+	// the merged run is read back in order, so its pages go next to each other on disk
+	MyDB_TempRunPtr run = parent->startTempRun ();
 	vector <MyDB_PageReaderWriter> returnVal;
-	MyDB_PageReaderWriter curPage (*parent);
+	MyDB_PageReaderWriter curPage (*parent, run);
 	bool lhsLoaded = false, rhsLoaded = false;
 
 	// if one of the runs is empty, get outta here
 	if (!leftIter->advance ()) {
 		while (rightIter->advance ()) {
 			rightIter->getCurrent (rhs);
-			appendRecord (curPage, returnVal, rhs, parent);
+			appendRecord (curPage, returnVal, rhs, parent, run);
 		}
 	} else if (!rightIter->advance ()) {
 		do {
 			leftIter->getCurrent (lhs);
-			appendRecord (curPage, returnVal, lhs, parent);
+			appendRecord (curPage, returnVal, lhs, parent, run);
 		} while (leftIter->advance ());
 	} else {
 		while (true) {
@@ -63,28 +65,28 @@ vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB
 	
 			// see if the lhs is less
 			if (comparator ()) {
-				appendRecord (curPage, returnVal, lhs, parent);
+				appendRecord (curPage, returnVal, lhs, parent, run);
 				lhsLoaded = false;
 
 				// deal with the case where we have to append all of the right records to the output
 				if (!leftIter->advance ()) {
-					appendRecord (curPage, returnVal, rhs, parent);
+					appendRecord (curPage, returnVal, rhs, parent, run);
 					while (rightIter->advance ()) {
 						rightIter->getCurrent (rhs);
-						appendRecord (curPage, returnVal, rhs, parent);
+						appendRecord (curPage, returnVal, rhs, parent, run);
 					}
 					break;
 				}
 			} else {
-				appendRecord (curPage, returnVal, rhs, parent);
+				appendRecord (curPage, returnVal, rhs, parent, run);
 				rhsLoaded = false;
 
 				// deal with the ase where we have to append all of the right records to the output
 				if (!rightIter->advance ()) {
-					appendRecord (curPage, returnVal, lhs, parent);
+					appendRecord (curPage, returnVal, lhs, parent, run);
 					while (leftIter->advance ()) {
 						leftIter->getCurrent (lhs);
-						appendRecord (curPage, returnVal, lhs, parent);
+						appendRecord (curPage, returnVal, lhs, parent, run);
 					}
 					break;
 				}
@@ -123,18 +125,21 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 	// this is the list of all of the iterators, with one for each run
 	vector <MyDB_RecordIteratorAltPtr> runIters;
 	
-	// process the file 
+	// process the file; each page of it is only read once, so a big file is read
+	// through a ring of frames, rather than pushing the runs out of the buffer
+	MyDB_AccessStrategyPtr strategy = sortMe.getBulkReadStrategy ();
 	MyDB_PageReaderWriter tempPage (true, *sortMe.getBufferMgr ());
-	for (int i = 0; i < sortMe.getNumPages (); i++) {
+	for (long i = 0; i < sortMe.getNumPages (); i++) {
 		
-		if (sortMe[i].getType () == MyDB_PageType :: RegularPage) {
+		MyDB_PageReaderWriter inPage = sortMe.getPage (i, strategy);
+		if (inPage.getType () == MyDB_PageType :: RegularPage) {
 
 			if (skipPred) {
 				vector <MyDB_PageReaderWriter> run;
-				run.push_back (*(sortMe[i].sort (comparator, lhs, rhs)));	
+				run.push_back (*(inPage.sort (comparator, lhs, rhs)));	
 				pagesToSort.push_back (run);
 			} else {
-				MyDB_RecordIteratorAltPtr temp = sortMe[i].getIteratorAlt ();
+				MyDB_RecordIteratorAltPtr temp = inPage.getIteratorAlt ();
 				while (temp->advance ()) {
 					temp->getCurrent (lhs);
 
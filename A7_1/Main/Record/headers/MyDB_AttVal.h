@@ -1,8 +1,8 @@
-
 #ifndef ATT_VAL_H
 #define ATT_VAL_H
 
 #include <memory>
+#include "MyDB_Value.h"
 #include <string>
 #include <cstring>
 
@@ -12,72 +12,72 @@ using namespace std;
 class MyDB_AttVal;
 typedef shared_ptr <MyDB_AttVal> MyDB_AttValPtr;
 
+// a handle to an attribute value.  The value itself is a MyDB_Value, which is either
+// one of the slots of a record (so that all of a record's values are in one array) or,
+// for a value that is not in a record, one that the handle has itself.  The accessors
+// just switch on the value's type, so none of them is a virtual call
 class MyDB_AttVal {
 
-private:
+public:
 
-	// this is a pointer into a buffer
-	void *myData;
+	inline int toInt () {
+		return myValue->toInt ();
+	}
 
-	// this tells us whether we are using the buffer
-	bool usingBuffer;
+	inline double toDouble () {
+		return myValue->toDouble ();
+	}
 
-public:
+	inline bool toBool () {
+		return myValue->toBool ();
+	}
 
-	virtual int toInt () = 0;
-	virtual void fromInt (int fromMe) = 0;
-	virtual double toDouble () = 0;
-	virtual string toString () = 0;
-	virtual bool toBool () = 0;
-	virtual void set (MyDB_AttValPtr toMe) = 0;
-	virtual size_t hash () = 0;
-	virtual MyDB_AttValPtr getCopy () = 0;
-	virtual void fromString (string &fromMe) = 0;
-	virtual void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) = 0;
-	virtual ~MyDB_AttVal ();
+	inline string toString () {
+		return myValue->toString ();
+	}
 
-	// this gets a pointer to our data... useful because we can avoid deserializing the record
-	inline void *getDataPointer () {
-		return myData;
+	inline void fromInt (int fromMe) {
+		myValue->fromInt (fromMe);
 	}
 
-	inline void extendBuffer (char *&buffer, size_t &allocatedSize, size_t &totSize, int extraSpaceNeeded) {
-		if (totSize + extraSpaceNeeded > allocatedSize) {
-			size_t newSize = (totSize + extraSpaceNeeded) * 2;
-			char *newBuff = new char[newSize];
-			memcpy (newBuff, buffer, allocatedSize);
-			delete [] buffer;
-			buffer = newBuff;
-			allocatedSize = newSize;
-		}
+	inline void fromString (string &fromMe) {
+		myValue->fromString (fromMe);
 	}
 
-	inline void setBuffered (char *where) {
-		myData = where;
-		usingBuffer = true;
+	// sets this value from the given one, converting it to this value's type
+	inline void set (const MyDB_AttValPtr &toMe) {
+		myValue->set (*toMe->myValue);
 	}
 
-	inline void setNotBuffered () {
-		myData = nullptr;
-		usingBuffer = false;
+	inline size_t hash () {
+		return myValue->hash ();
 	}
 
-	MyDB_AttVal () {
-		setNotBuffered ();	
+	inline void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) {
+		myValue->serialize (buffer, allocatedSize, totSize);
 	}
 
-	inline char *fromBinary (char *fromHere) {
+	// a new handle, with its own copy of the value
+	MyDB_AttValPtr getCopy ();
 
-		// this is the length
-		int myLen = *((short *) fromHere);
+	// the value that the handle is for
+	inline MyDB_Value &getValue () {
+		return *myValue;
+	}
 
-		// remember our data
-		setBuffered (fromHere + sizeof (short));
+	// makes the handle use the given value (a slot of a record) from now on; the slot
+	// takes on the handle's type and its current value
+	void bindTo (MyDB_Value *where);
 
-		// and return a pointer to the next guy
-		return fromHere + myLen; 
-	}
+	virtual ~MyDB_AttVal ();
+
+protected:
+
+	MyDB_AttVal (MyDB_ValueType type);
 
+	// the value, and the one that is used if the handle is not bound to a record's slot
+	MyDB_Value *myValue;
+	MyDB_Value ownValue;
 };
 
 class MyDB_IntAttVal;
@@ -87,23 +87,38 @@ class MyDB_IntAttVal : public MyDB_AttVal {
 
 public:
 
-	int toInt () override;
-	double toDouble () override;
-	string toString () override;
-	void fromInt (int fromMe) override;
-	bool toBool () override;
-	void fromString (string &fromMe) override;
-	void set (MyDB_AttValPtr toMe) override;
-	size_t hash () override;
-	MyDB_AttValPtr getCopy () override;
-	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
-	void set (int val);
+	using MyDB_AttVal :: set;
+
+	inline void set (int val) {
+		myValue->intVal = val;
+	}
+
 	MyDB_IntAttVal ();
 	~MyDB_IntAttVal ();
+};
+
+class MyDB_LongAttVal;
+typedef shared_ptr <MyDB_LongAttVal> MyDB_LongAttValPtr;
+
+// a 64-bit integer; this is not an attribute type that a table can have, but it is
+// what a B+-Tree uses to point at its pages (see MyDB_INRecord), since a big table
+// can have more than 2^31 of them
+class MyDB_LongAttVal : public MyDB_AttVal {
+
+public:
+
+	using MyDB_AttVal :: set;
 
-private:
+	inline long toLong () {
+		return myValue->longVal;
+	}
+
+	inline void set (long val) {
+		myValue->longVal = val;
+	}
 
-	int value;
+	MyDB_LongAttVal ();
+	~MyDB_LongAttVal ();
 };
 
 class MyDB_DoubleAttVal;
@@ -113,23 +128,14 @@ class MyDB_DoubleAttVal : public MyDB_AttVal {
 
 public:
 
-	int toInt () override;
-	double toDouble () override;
-	string toString () override;
-	bool toBool () override;
-	void fromInt (int fromMe) override;
-	MyDB_AttValPtr getCopy () override;
-	size_t hash () override;
-	void set (MyDB_AttValPtr toMe) override;
-	void fromString (string &fromMe) override;
-	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
-	void set (double val);
-	MyDB_DoubleAttVal ();
-	~MyDB_DoubleAttVal ();
+	using MyDB_AttVal :: set;
 
-private:
+	inline void set (double val) {
+		myValue->doubleVal = val;
+	}
 
-	double value;
+	MyDB_DoubleAttVal ();
+	~MyDB_DoubleAttVal ();
 };
 
 class MyDB_StringAttVal;
@@ -139,23 +145,14 @@ class MyDB_StringAttVal : public MyDB_AttVal {
 
 public:
 
-	int toInt () override;
-	double toDouble () override;
-	string toString () override;
-	bool toBool () override;
-	void fromString (string &fromMe) override;
-	MyDB_AttValPtr getCopy () override;
-	size_t hash () override;
-	void set (MyDB_AttValPtr toMe) override;
-	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
-	void fromInt (int fromMe) override;
-	void set (string val);
-	MyDB_StringAttVal ();
-	~MyDB_StringAttVal ();
+	using MyDB_AttVal :: set;
 
-private:
+	inline void set (const string &val) {
+		myValue->setChars (val.c_str (), val.size ());
+	}
 
-	string value;
+	MyDB_StringAttVal ();
+	~MyDB_StringAttVal ();
 };
 
 class MyDB_BoolAttVal;
@@ -165,23 +162,14 @@ class MyDB_BoolAttVal : public MyDB_AttVal {
 
 public:
 
-	int toInt () override;
-	double toDouble () override;
-	string toString () override;
-	bool toBool () override;
-	void fromString (string &fromMe) override;
-	void set (MyDB_AttValPtr toMe) override;
-	MyDB_AttValPtr getCopy () override;
-	size_t hash () override;
-	void fromInt (int fromMe) override;
-	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
-	void set (bool val);
-	MyDB_BoolAttVal ();
-	~MyDB_BoolAttVal ();
+	using MyDB_AttVal :: set;
 
-private:
+	inline void set (bool val) {
+		myValue->boolVal = val;
+	}
 
-	bool value;
+	MyDB_BoolAttVal ();
+	~MyDB_BoolAttVal ();
 };
 
 
@@ -0,0 +1,89 @@
+
+#ifndef CONJUNCTION_H
+#define CONJUNCTION_H
+
+#include "MyDB_ExprProgram.h"
+#include "MyDB_Record.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// one run of a conjunction in this many is a sample, where every conjunct is run (on
+// the record, or on the whole batch) and timed
+#define CONJUNCTION_SAMPLE_EVERY 16
+
+// and after this many samples, the conjuncts are put in a new order
+#define CONJUNCTION_REORDER_AFTER 8
+
+// create a smart pointer for conjunctions
+class MyDB_Conjunction;
+typedef shared_ptr <MyDB_Conjunction> MyDB_ConjunctionPtr;
+
+// a predicate that is a conjunction (such as the nested && that the CNF of a query is
+// built into), where each conjunct is compiled on its own, and the conjuncts are run
+// one after another until one of them says no.  The order that they are run in is
+// learned as the scan goes: at first, the ones with the fewest instructions go first,
+// and after that, the samples say how long each one takes per record and how many of
+// the records it lets through, and they are sorted by the expected cost of running
+// them, cost / (1 - pass rate), so that cheap ones that throw out a lot come first.
+// The counts are halved each time the conjuncts are sorted, so the order follows the
+// data if it changes.  A conjunct that can trap (one with an integer divide, which
+// may be guarded by the ones before it, as in id <> 0 AND 10 / id > 1) is never moved,
+// and the others are only moved around between those; a sample only runs it over the
+// records that the ones before it let through
+class MyDB_Conjunction {
+
+public:
+
+	// compiles the predicate over the given record
+	MyDB_Conjunction (MyDB_RecordPtr rec, string predicate);
+
+	// runs the predicate over the record, as it is now
+	bool run ();
+
+	// like MyDB_ExprProgram.select: runs the predicate over the first numRecs of recs,
+	// which take the place of source, and puts where the ones for which it is true are
+	// into selected, returning how many of those there are
+	int select (MyDB_Record *source, void **recs, int numRecs, int *selected);
+
+	// the conjuncts, in the order that they are run now
+	vector <string> getOrder ();
+
+private:
+
+	// one conjunct: its text, its program, whether that can trap, and, from the samples,
+	// how many records it has been run on, how many it let through, and how long it
+	// took (in nanoseconds)
+	struct Conjunct {
+		string text;
+		MyDB_ExprProgramPtr prog;
+		bool canTrap;
+		double seen;
+		double passed;
+		double nanos;
+	};
+
+	// like select, but only runs the first howMany conjuncts
+	int selectFirst (MyDB_Record *source, void **recs, int numRecs, int *selected, size_t howMany);
+
+	// runs every conjunct over a batch, for the counts
+	void sampleBatch (MyDB_Record *source, void **recs, int numRecs, int *scratch);
+
+	// sorts the conjuncts, leaving the ones that can trap where they are
+	void sortBetweenTraps (function <bool (const Conjunct &, const Conjunct &)> lessThan);
+
+	// notes that a sample was taken, and puts the conjuncts in a new order if it is time
+	void sampled ();
+
+	// the conjuncts, in the order that they are run
+	vector <Conjunct> conjuncts;
+
+	// runs since the last sample, and samples since the last new order
+	int sinceSample;
+	int numSamples;
+};
+
+#endif
@@ -0,0 +1,301 @@
+
+#ifndef EXPR_PROGRAM_H
+#define EXPR_PROGRAM_H
+
+#include "MyDB_AttType.h"
+#include "MyDB_AttVal.h"
+#include "MyDB_NativeCode.h"
+#include "MyDB_RecordView.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+class MyDB_Record;
+
+// the number of records that a program works on at once, when it runs over a batch
+#define EXPR_BATCH_SIZE 1024
+
+// once a program has been run over this many records, it is compiled to machine code
+// (if native code is on; see MyDB_NativeCode)
+#define EXPR_NATIVE_AFTER 100000
+
+// create a smart pointer for programs
+class MyDB_ExprProgram;
+typedef shared_ptr <MyDB_ExprProgram> MyDB_ExprProgramPtr;
+
+// the instructions of a program; each one works on registers of one type, which is
+// the last part of its name (Int, Double, String, or Bool)
+enum MyDB_ExprOp : unsigned char {
+
+	// reads an attribute of a record into a register
+	LoadInt, LoadDouble, LoadString, LoadBool,
+
+	// converts a register to another type
+	IntToDouble, IntToString, DoubleToString, BoolToString,
+
+	// arithmetic; adding strings puts them together
+	AddInt, AddDouble, AddString, SubInt, SubDouble, MulInt, MulDouble, DivInt, DivDouble,
+	NegInt, NegDouble,
+
+	// comparisons, which all give a bool
+	GtInt, GtDouble, GtString, LtInt, LtDouble, LtString, EqInt, EqDouble, EqString, EqBool,
+	NeqInt, NeqDouble, NeqString, NeqBool,
+
+	// logic
+	AndBool, OrBool, NotBool,
+
+	// skips the next rhs instructions if register lhs is false / true; these write no
+	// register, and come before the right side of an && or ||
+	JumpIfFalse, JumpIfTrue
+};
+
+// one instruction: the register it writes, and the ones that it reads (for a load, lhs
+// is which of the program's inputs is read; for a jump, rhs is how far it goes)
+struct MyDB_ExprInstruction {
+	MyDB_ExprOp op;
+	int dest;
+	int lhs;
+	int rhs;
+};
+
+// a register holds a raw int, double, or bool, or a string as a pointer to its
+// characters (in the record that it was read from, in a constant, or in memory of the
+// register's own) and its length
+struct MyDB_ExprRegister {
+	union {
+		int intVal;
+		double doubleVal;
+		bool boolVal;
+		struct {
+			const char *chars;
+			unsigned len;
+		} str;
+	};
+};
+
+// a computation over one or more records, compiled into a list of instructions over
+// registers whose types are all worked out when it is compiled.  Every instruction
+// writes a register of its own, and a constant is just a register that is set up
+// when it is compiled, so running the program is one pass down the instructions, with
+// no calls through function objects and nothing allocated (except when strings are
+// built).  MyDB_Record parses the computation and calls the methods below to build
+// the program, and compileComputation wraps it up as a func.
+//
+// The program is cleaned up as it is built: an instruction that only reads constants
+// is run right away (so its answer is a constant), an instruction that is already
+// there (say, the same comparison twice, or an attribute that is read twice) is not
+// added again, and the right side of an && or || is jumped over when the left side
+// decides the answer.  A program can also have several results (see addResult), which
+// share whatever they have in common
+class MyDB_ExprProgram {
+
+public:
+
+	MyDB_ExprProgram ();
+
+	// these add to the program, returning the register that has the result, and its
+	// type; a computation that makes no sense for the types is an error
+	pair <int, MyDB_AttTypePtr> load (MyDB_Record *source, int whichAtt, MyDB_AttTypePtr type);
+	pair <int, MyDB_AttTypePtr> intConstant (int val);
+	pair <int, MyDB_AttTypePtr> doubleConstant (double val);
+	pair <int, MyDB_AttTypePtr> boolConstant (bool val);
+	pair <int, MyDB_AttTypePtr> stringConstant (string val);
+	pair <int, MyDB_AttTypePtr> plus (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs);
+	pair <int, MyDB_AttTypePtr> minus (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs);
+	pair <int, MyDB_AttTypePtr> times (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs);
+	pair <int, MyDB_AttTypePtr> divide (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs);
+	pair <int, MyDB_AttTypePtr> gt (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs);
+	pair <int, MyDB_AttTypePtr> lt (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs);
+	pair <int, MyDB_AttTypePtr> eq (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs);
+	pair <int, MyDB_AttTypePtr> neq (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs);
+	pair <int, MyDB_AttTypePtr> unaryMinus (pair <int, MyDB_AttTypePtr> lhs);
+	pair <int, MyDB_AttTypePtr> nott (pair <int, MyDB_AttTypePtr> lhs);
+
+	// for && and ||, rhsStart is size () from before rhs was added; the instructions
+	// from there on are skipped when lhs decides the answer
+	pair <int, MyDB_AttTypePtr> andd (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs, size_t rhsStart);
+	pair <int, MyDB_AttTypePtr> orr (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs, size_t rhsStart);
+
+	// says which register has an answer, after everything for it is added; returns
+	// which result of the program it is (the first one is 0)
+	int addResult (pair <int, MyDB_AttTypePtr> result);
+
+	// if all that the program does is read one attribute, returns true, and says which
+	bool isJustLoad (MyDB_Record *&source, int &whichAtt);
+
+	// runs the program; the (first) answer comes back in an attribute value that
+	// belongs to the program, and that is overwritten the next time that it runs
+	MyDB_AttValPtr run ();
+
+	// one of the answers from the last time that the program was run
+	MyDB_AttValPtr getResult (int whichResult);
+
+	// runs a program whose (first) answer is a bool, and returns it
+	bool runBool ();
+
+	// the number of instructions
+	size_t size ();
+
+	// true if running the program can trap (it has an integer divide, which may be by zero)
+	bool canTrap ();
+
+	// runs the program over a batch of records at once.  recs has where the records are
+	// (usually, on a page), and the program is run over recs[which[0]], recs[which[1]],
+	// ... recs[which[numRecs - 1]] (or over the first numRecs of them, if which is null),
+	// each one taking the place of source; any other record that the program reads is
+	// the same for every one of them.  Each instruction is a loop over the whole batch,
+	// on columns of raw values, so the compiler can vectorize it; both sides of an &&
+	// or || are worked out, but an integer divide on the right side is only done for
+	// the records where the left side does not decide the answer (as run () would).
+	// Attributes of source are read straight from the records, so they have to stay
+	// put until the answers have been gotten with getBatchResult
+	void runBatch (MyDB_Record *source, void **recs, int *which, int numRecs);
+
+	// runs a program whose (first) answer is a bool over the first numRecs of recs (as above),
+	// and puts where the ones for which it is true are in recs into selected; returns
+	// how many of those there are
+	int select (MyDB_Record *source, void **recs, int numRecs, int *selected);
+
+	// like select, but only runs over the numSelected records in selected (the positions
+	// in recs of the ones that are still in), and keeps the ones for which it is true;
+	// returns how many of those there are
+	int refine (MyDB_Record *source, void **recs, int *selected, int numSelected);
+
+	// an answer for the given record of the last batch (the given position in which);
+	// like run (), it comes back in an attribute value that belongs to the program
+	MyDB_AttValPtr getBatchResult (int whichRec, int whichResult = 0);
+
+	// compiles the program to machine code now, rather than waiting until it has been
+	// run EXPR_NATIVE_AFTER times.  The code does everything but the loads (which are
+	// still done here, since they go through the records), both for run () and for a
+	// batch (where all of the instructions are done in one loop over the records).
+	// Returns false if the program cannot be compiled (native code is off, there is no
+	// compiler, or the program builds strings), in which case it is just interpreted
+	bool compileNative ();
+
+	// true if the program is running as machine code
+	bool isNative ();
+
+private:
+
+	// adds an instruction that writes a new register of the given type, unless it can
+	// be worked out now, or is already there; returns the register with the answer
+	int emit (MyDB_ExprOp op, int lhs, int rhs, MyDB_ValueType type);
+
+	// adds a new register of the given type, that no instruction writes
+	int newRegister (MyDB_ValueType type);
+
+	// the register with the given constant (its type, and its bytes), which is a new
+	// one if there is no such register already
+	int constantRegister (MyDB_ValueType type, string bytes);
+	string constantBytes (int reg);
+
+	// does the work of andd and orr
+	int shortCircuit (MyDB_ExprOp op, int lhs, int rhs, size_t rhsStart);
+
+	// stops anything from sharing the registers written from the given instruction on
+	void forget (size_t fromInstruction);
+
+	// points the string registers at their characters
+	void pointStrings ();
+
+	// makes sure that the register is a double / a string, converting it if not
+	int asDouble (pair <int, MyDB_AttTypePtr> &val);
+	int asString (pair <int, MyDB_AttTypePtr> &val);
+
+	// runs the instructions, and runs one instruction (other than a load or a jump)
+	void execute ();
+	void step (MyDB_ExprInstruction &ins);
+
+	// sets up the columns for runBatch, the first time that it is called
+	void setUpBatch ();
+
+	// does a load instruction, when the program is not run over a batch
+	void doLoad (MyDB_ExprInstruction &ins);
+
+	// counts runs of the program, compiling it once it has been run enough
+	inline void countRuns (size_t numRecs) {
+		numRuns += numRecs;
+		if (numRuns >= EXPR_NATIVE_AFTER && !triedNative && MyDB_NativeCode :: isEnabled ())
+			compileNative ();
+	}
+
+	// the C++ source of the machine code version of the program (empty if there cannot
+	// be one), and the source for a register in it
+	string nativeSource ();
+	string nativeRegister (int reg, bool inBatch, vector <bool> &computed);
+
+	// the column of values that a register has when the program runs over a batch
+	inline int *intColumn (int reg) {
+		return (int *) &batchMemory[reg * EXPR_BATCH_SIZE * 2];
+	}
+
+	inline double *doubleColumn (int reg) {
+		return (double *) &batchMemory[reg * EXPR_BATCH_SIZE * 2];
+	}
+
+	inline unsigned char *boolColumn (int reg) {
+		return (unsigned char *) &batchMemory[reg * EXPR_BATCH_SIZE * 2];
+	}
+
+	inline MyDB_ExprRegister *stringColumn (int reg) {
+		return (MyDB_ExprRegister *) &batchMemory[reg * EXPR_BATCH_SIZE * 2];
+	}
+
+	// which records of the batch the instructions inside the given number of nested
+	// && and || right sides are for
+	inline unsigned char *liveColumn (size_t depth) {
+		return &batchLive[depth * EXPR_BATCH_SIZE];
+	}
+
+	// the instructions, the registers and their types, and the records that are read
+	vector <MyDB_ExprInstruction> code;
+	vector <MyDB_ExprRegister> regs;
+	vector <MyDB_ValueType> types;
+	vector <pair <MyDB_Record *, int>> inputs;
+
+	// the characters of each string register that is a constant or is built when the
+	// program runs
+	vector <string> strings;
+
+	// while the program is built: which registers are constants, the constants, and
+	// the register written by each instruction (the operation and the registers that
+	// it reads) that can be shared
+	vector <bool> isConstant;
+	map <pair <MyDB_ValueType, string>, int> constants;
+	map <tuple <int, int, int>, int> sameAs;
+
+	// the registers with the answers, and where they are put for run ()
+	vector <int> results;
+	vector <MyDB_AttValPtr> resultVals;
+
+	// for runBatch: the columns (room for EXPR_BATCH_SIZE strings per register), the
+	// strings that are built, the records in the batch, and a view for reading them
+	vector <double> batchMemory;
+	vector <vector <string>> batchStrings;
+	vector <char *> batchRecs;
+	MyDB_Record *viewOf;
+	MyDB_RecordView batchView;
+	vector <void *> batchColumns;
+
+	// if the program has an integer divide: a column for each && and || right side,
+	// saying which records of the batch it is for (see runBatch)
+	bool batchDivides;
+	vector <unsigned char> batchLive;
+
+	// for compileNative: the compiled code and its functions, the loads (which are
+	// still done here), and how many records the program has been run over
+	MyDB_NativeCodePtr native;
+	void (*nativeRun) (MyDB_ExprRegister *regs);
+	void (*nativeBatch) (void **columns, int numRecs);
+	vector <MyDB_ExprInstruction> nativeLoads;
+	size_t numRuns;
+	bool triedNative;
+};
+
+#endif
@@ -14,28 +14,37 @@ class MyDB_INRecord : public MyDB_Record  {
 public:
 
 	MyDB_INRecord (MyDB_AttValPtr myAtt) : MyDB_Record (nullptr) {
+		ptr = make_shared <MyDB_LongAttVal> ();
 		values.push_back (myAtt);
-		values.push_back (make_shared <MyDB_IntAttVal> ());	
+		values.push_back (ptr);	
+		valuesChanged ();
 		bufferOld = true;
 	}
 
-	int getPtr () {
-		return values[1]->toInt ();
+	// the page that the record points to
+	long getPtr () {
+		return ptr->toLong ();
 	}
 
-	void setPtr (int fromMe) {
-		values[1]->fromInt (fromMe);
+	void setPtr (long fromMe) {
+		ptr->set (fromMe);
 		bufferOld = true;
 	}
 
 	void setKey (MyDB_AttValPtr toMe) {
 		values[0] = toMe;
+		valuesChanged ();
 		bufferOld = true;
 	}
 
 	MyDB_AttValPtr getKey () {
 		return values[0];
 	}
+
+private:
+
+	// this is values[1]
+	MyDB_LongAttValPtr ptr;
 };
 
 #endif
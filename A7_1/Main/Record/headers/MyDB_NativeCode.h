@@ -0,0 +1,53 @@
+
+#ifndef NATIVE_CODE_H
+#define NATIVE_CODE_H
+
+#include <memory>
+#include <string>
+
+using namespace std;
+
+// create a smart pointer for native code
+class MyDB_NativeCode;
+typedef shared_ptr <MyDB_NativeCode> MyDB_NativeCodePtr;
+
+// a shared library that is compiled from C++ source while the database is running,
+// with the system's compiler (the one in $CXX, or c++), and then loaded.  Libraries
+// are kept in a cache directory, named by a hash of their source (and the compiler
+// command), with the source kept next to each one and checked before it is loaded, so
+// the same code (say, the predicate of a query that is run again and again) is only
+// compiled once, even across runs.  This is off until enable () is called; anything that uses it has
+// to be able to go on without it, since there may be no compiler
+class MyDB_NativeCode {
+
+public:
+
+	// turns native code on, with the libraries cached in the given directory (which is
+	// made if it is not there), or off.  The directory has to belong to this user and be
+	// mode 0700; if it is not, native code is left off and false is returned
+	static bool enable (string cacheDir);
+	static void disable ();
+	static bool isEnabled ();
+
+	// compiles the source (or finds it in the cache) and loads it; returns null if
+	// that cannot be done, for whatever reason
+	static MyDB_NativeCodePtr load (string source);
+
+	// finds a function in the library (it should be declared extern "C"), or null
+	void *getSymbol (string name);
+
+	// unloads the library
+	~MyDB_NativeCode ();
+
+private:
+
+	MyDB_NativeCode (void *handle);
+
+	// the loaded library
+	void *handle;
+
+	// where the libraries go; empty if native code is off
+	static string cacheDir;
+};
+
+#endif
@@ -4,7 +4,10 @@
 
 #include <functional>
 #include "MyDB_AttVal.h"
+#include "MyDB_ExprProgram.h"
+#include "MyDB_RecordView.h"
 #include "MyDB_Schema.h"
+#include "MyDB_Value.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -62,6 +65,14 @@ public:
 	// 	
 	void *fromBinary (void *startPos);
 
+	// like fromBinary, except that nothing is copied or read until it is used: each
+	// attribute is read straight from startPos the first time that it is asked for
+	// (through getAtt, getValue, or a computation over the record), so a computation
+	// that uses only a few attributes of a wide record does not pay for the rest.  The
+	// record stays where it is, so the page that it is on must not go anywhere (or be
+	// changed) until the record is loaded with something else
+	void *fromView (void *startPos);
+
 	// parse the contents of this record from the given string
 	void fromString (string fromMe);
 
@@ -98,8 +109,19 @@ public:
 	// the entire file, computing the function after each new record is loaded, without
 	// recompiling the function.
 	//
+	// the computation is compiled into a MyDB_ExprProgram, which the function runs
+	//
 	func compileComputation (string fromMe);
 
+	// like compileComputation, but gives the program itself, which can also be run
+	// over a batch of records at once (see MyDB_ExprProgram.runBatch)
+	MyDB_ExprProgramPtr compileProgram (string fromMe);
+
+	// compiles a group of computations into one program, with a result for each (see
+	// MyDB_ExprProgram.addResult), so that whatever they have in common is only worked
+	// out once
+	MyDB_ExprProgramPtr compileProgram (vector <string> fromUs);
+
 	// builds a function that returns true if lhs < rhs; the comparison is done by running whatever computation is 
 	// encoded by the string "computation" on both lhs and rhs, and then compariing the results obtained using this
 	// computation over both.  If the result from lhs is < the result from rhs, then the function returned from
@@ -112,8 +134,22 @@ public:
 	// access the schema
 	MyDB_SchemaPtr &getSchema ();
 
+	// a view that can look at serialized records like this one (see fromView)
+	inline MyDB_RecordView &getView () {
+		return view;
+	}
+
 	// access a particular attribute
-	MyDB_AttValPtr &getAtt (int whichAtt);
+	inline MyDB_AttValPtr &getAtt (int whichAtt) {
+		sources[whichAtt].first->loadAtt (sources[whichAtt].second);
+		return values[whichAtt];
+	}
+
+	// access a particular attribute's value directly, rather than through its handle
+	inline MyDB_Value &getValue (int whichAtt) {
+		sources[whichAtt].first->loadAtt (sources[whichAtt].second);
+		return *atts[whichAtt];
+	}
 
 private:
 
@@ -126,30 +162,37 @@ private:
 	// the amount of data in the record buffer
 	size_t recSize;
 
-	// helper function for the compilation
-	pair <func, MyDB_AttTypePtr> compileHelper (char * &vals);
+	// the record is serialized into this buffer and then the two are swapped, since the
+	// long strings that were read in point into the old one
+	char *spare;
+	size_t spareSize;
+
+	// helper function for the compilation; adds the computation to the program, and
+	// returns the register with its result
+	pair <int, MyDB_AttTypePtr> compileHelper (char * &vals, MyDB_ExprProgram &prog);
 
 	// helper function for the compilation
 	char *findsymbol (char val, char *input);
 	
-	// these functions are all used to build up computations over the record
-	pair <func, MyDB_AttTypePtr> fromData (string attName);
-	pair <func, MyDB_AttTypePtr> plus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> minus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> times (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> divide (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> gt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> lt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> eq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> neq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> andd (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> orr (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> unaryMinus (pair <func, MyDB_AttTypePtr> lhs);
-	pair <func, MyDB_AttTypePtr> nott (pair <func, MyDB_AttTypePtr> lhs);
+	// adds a read of the attribute to the program
+	pair <int, MyDB_AttTypePtr> fromData (string attName, MyDB_ExprProgram &prog);
 
 	// write the current attribute values into the buffer
 	void writeAttsToBuffer ();
 
+	// run whenever the handles in values change, to find their values again
+	void valuesChanged ();
+
+	// if the record was loaded with fromView, reads in the given attribute (unless it
+	// was read already); and reads in all of them
+	inline void loadAtt (int whichAtt) {
+		if (viewed && loadedAt[whichAtt] != generation) {
+			atts[whichAtt]->fromBinary (view.getAtt (whichAtt));
+			loadedAt[whichAtt] = generation;
+		}
+	}
+	void loadAllAtts ();
+
 	// true when the set of attributes don't match the attribute buffer
 	bool bufferOld;
 
@@ -157,8 +200,25 @@ private:
 	friend class MyDB_INRecord;
 
 	MyDB_SchemaPtr mySchema;
+
+	// the handles to the attributes, and the values that the handles are for.  A record
+	// with a schema keeps its own values, one after another, in slots; the handles of
+	// a record that is built from two others (or of an internal B+-Tree record) are for
+	// values that are elsewhere.  Either way, atts has where each of the values is
 	vector <MyDB_AttValPtr> values;	
-	vector <MyDB_AttValPtr> scratch;
+	vector <MyDB_Value> slots;
+	vector <MyDB_Value *> atts;
+
+	// the record (and which of its attributes) that each value comes from; this is the
+	// record itself, unless this one was built from two others
+	vector <pair <MyDB_Record *, int>> sources;
+
+	// for fromView: the record's bytes, whether the record was loaded that way, and
+	// which attributes have been read in (those whose entry is the current generation)
+	MyDB_RecordView view;
+	bool viewed;
+	unsigned generation;
+	vector <unsigned> loadedAt;
 
 };
 
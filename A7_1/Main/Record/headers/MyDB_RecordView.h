@@ -0,0 +1,70 @@
+
+#ifndef RECORD_VIEW_H
+#define RECORD_VIEW_H
+
+#include "MyDB_Value.h"
+#include <vector>
+
+using namespace std;
+
+// a view of one serialized record, wherever it is (usually, on a page), that finds the
+// bytes of any one attribute without reading the others.  Every attribute is a short
+// giving its length and then its data; up to the first string, the attributes have
+// the same size in every record, so where they start is worked out once, from the
+// types.  The ones after that are found by walking the lengths, but only as far as
+// the attribute that is asked for, and only once per record
+class MyDB_RecordView {
+
+public:
+
+	// a view of records whose attributes have the given types
+	MyDB_RecordView (const vector <MyDB_ValueType> &types) {
+		offsets.resize (types.size () + 1);
+		offsets[0] = sizeof (short);
+		numFixed = 1;
+		for (size_t i = 0; i < types.size () && types[i] != StringValue; i++) {
+			MyDB_Value sizer (types[i]);
+			offsets[i + 1] = offsets[i] + sizer.getBinarySize ();
+			numFixed++;
+		}
+		base = nullptr;
+		numKnown = numFixed;
+	}
+
+	MyDB_RecordView () : MyDB_RecordView (vector <MyDB_ValueType> ()) {}
+
+	// looks at the record at the given location
+	inline void setPointer (void *record) {
+		base = (char *) record;
+		numKnown = numFixed;
+	}
+
+	// the record, and the number of bytes in it
+	inline char *getPointer () {
+		return base;
+	}
+
+	inline size_t getSize () {
+		return *((short *) base);
+	}
+
+	// where the given attribute (its length, and then its data) is in the record
+	inline char *getAtt (size_t whichAtt) {
+		while (numKnown <= whichAtt) {
+			offsets[numKnown] = offsets[numKnown - 1] + *((short *) (base + offsets[numKnown - 1]));
+			numKnown++;
+		}
+		return base + offsets[whichAtt];
+	}
+
+private:
+
+	// the record, and where each of its attributes starts; the first numFixed offsets
+	// are the same for every record, and the first numKnown are known for this one
+	char *base;
+	vector <size_t> offsets;
+	size_t numFixed;
+	size_t numKnown;
+};
+
+#endif
@@ -0,0 +1,225 @@
+
+#ifndef VALUE_H
+#define VALUE_H
+
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+// the longest string that is kept inside of a value itself
+#define VALUE_INLINE_CHARS 15
+
+// the types that a value can have
+enum MyDB_ValueType : char {IntValue, LongValue, DoubleValue, StringValue, BoolValue};
+
+// where the characters of a string value are: in the value itself, in the serialized
+// record that the value was read from, or in memory that the value owns
+enum MyDB_StringHome : char {InlineChars, BorrowedChars, OwnedChars};
+
+// one attribute value: a fixed-size tagged union, so that the values of a record can
+// all sit next to each other in one array (see MyDB_Record), and reading one is just a
+// switch on its type rather than a virtual call through a pointer.  A string of up to
+// VALUE_INLINE_CHARS characters is kept in the value; a longer one that was read from
+// a record points at its characters in the record's buffer (which stay put until the
+// record reads another one), and any other long string is copied into memory that the
+// value owns.  Copying a value always copies its characters, so the copy owns them
+struct MyDB_Value {
+
+	union {
+		int intVal;
+		long longVal;
+		double doubleVal;
+		bool boolVal;
+		char chars[VALUE_INLINE_CHARS + 1];
+		struct {
+			const char *ptr;
+			size_t capacity;
+		} str;
+	};
+
+	// the length of a string value, the value's type, and where a string's characters are
+	unsigned len;
+	MyDB_ValueType type;
+	MyDB_StringHome home;
+
+	MyDB_Value (MyDB_ValueType typeIn = IntValue) {
+		longVal = 0;
+		len = 0;
+		type = typeIn;
+		home = InlineChars;
+	}
+
+	MyDB_Value (const MyDB_Value &copyMe) {
+		type = copyMe.type;
+		home = InlineChars;
+		len = 0;
+		longVal = copyMe.longVal;
+		if (type == StringValue)
+			setChars (copyMe.getChars (), copyMe.len);
+	}
+
+	MyDB_Value &operator = (const MyDB_Value &copyMe) {
+		if (this == &copyMe)
+			return *this;
+		if (copyMe.type == StringValue) {
+			type = StringValue;
+			setChars (copyMe.getChars (), copyMe.len);
+		} else {
+			freeChars ();
+			type = copyMe.type;
+			longVal = copyMe.longVal;
+		}
+		return *this;
+	}
+
+	~MyDB_Value () {
+		freeChars ();
+	}
+
+	// the characters of a string value, which always end in a null
+	inline const char *getChars () const {
+		return (home == InlineChars) ? chars : str.ptr;
+	}
+
+	// copies the given characters into the value
+	inline void setChars (const char *from, size_t fromLen) {
+
+		// we can reuse our own memory, if it is big enough
+		if (home == OwnedChars && fromLen < str.capacity) {
+			memmove ((char *) str.ptr, from, fromLen);
+			((char *) str.ptr)[fromLen] = 0;
+			len = fromLen;
+			return;
+		}
+
+		// the old memory is freed last, since the characters may be in it
+		char *old = (home == OwnedChars) ? (char *) str.ptr : nullptr;
+		if (fromLen <= VALUE_INLINE_CHARS) {
+			memmove (chars, from, fromLen);
+			chars[fromLen] = 0;
+			home = InlineChars;
+		} else {
+			char *mine = new char[fromLen + 1];
+			memcpy (mine, from, fromLen);
+			mine[fromLen] = 0;
+			str.ptr = mine;
+			str.capacity = fromLen + 1;
+			home = OwnedChars;
+		}
+		len = fromLen;
+		delete [] old;
+	}
+
+	// points the value at the given characters (which end in a null, and which have to
+	// stay put for as long as the value is using them); short strings are just copied
+	inline void borrowChars (const char *from, size_t fromLen) {
+		if (fromLen <= VALUE_INLINE_CHARS) {
+			setChars (from, fromLen);
+			return;
+		}
+		freeChars ();
+		str.ptr = from;
+		home = BorrowedChars;
+		len = fromLen;
+	}
+
+	inline void freeChars () {
+		if (home == OwnedChars)
+			delete [] str.ptr;
+		home = InlineChars;
+	}
+
+	// the value as each of the types; a conversion that makes no sense is an error
+	inline int toInt () const {
+		if (type == IntValue)
+			return intVal;
+		if (type == LongValue)
+			return (int) longVal;
+		if (type == DoubleValue)
+			return (int) doubleVal;
+		cantConvert ("int");
+		return 0;
+	}
+
+	inline long toLong () const {
+		if (type == LongValue)
+			return longVal;
+		if (type == IntValue)
+			return intVal;
+		if (type == DoubleValue)
+			return (long) doubleVal;
+		cantConvert ("long");
+		return 0;
+	}
+
+	inline double toDouble () const {
+		if (type == DoubleValue)
+			return doubleVal;
+		if (type == IntValue)
+			return intVal;
+		if (type == LongValue)
+			return longVal;
+		cantConvert ("double");
+		return 0;
+	}
+
+	inline bool toBool () const {
+		if (type == BoolValue)
+			return boolVal;
+		cantConvert ("bool");
+		return false;
+	}
+
+	string toString () const;
+
+	// sets the value from a string / from an int, converting to the value's type
+	void fromString (const string &fromMe);
+	void fromInt (int fromMe);
+
+	// sets the value from another value, converting it to this value's type
+	void set (const MyDB_Value &fromMe);
+
+	size_t hash () const;
+
+	// reads the value from its serialized form (a short giving the length, including the
+	// short, and then the data), returning where the next value starts; and appends the
+	// serialized value to the buffer, growing it if need be
+	inline char *fromBinary (char *fromHere) {
+		short myLen = *((short *) fromHere);
+		char *data = fromHere + sizeof (short);
+		if (type == IntValue)
+			intVal = *((int *) data);
+		else if (type == DoubleValue)
+			doubleVal = *((double *) data);
+		else if (type == StringValue)
+			borrowChars (data, myLen - sizeof (short) - 1);
+		else if (type == LongValue)
+			longVal = *((long *) data);
+		else
+			boolVal = (*data == 1);
+		return fromHere + myLen;
+	}
+
+	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) const;
+
+	// the number of bytes that the value takes up when it is serialized
+	inline size_t getBinarySize () const {
+		if (type == IntValue)
+			return sizeof (short) + sizeof (int);
+		if (type == DoubleValue)
+			return sizeof (short) + sizeof (double);
+		if (type == StringValue)
+			return sizeof (short) + len + 1;
+		if (type == LongValue)
+			return sizeof (short) + sizeof (long);
+		return sizeof (short) + sizeof (char);
+	}
+
+private:
+
+	// kills the program, since the value cannot be had as the given type
+	void cantConvert (const char *toType) const;
+};
+
+#endif
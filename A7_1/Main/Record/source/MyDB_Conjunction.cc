@@ -0,0 +1,191 @@
+
+#ifndef CONJUNCTION_C
+#define CONJUNCTION_C
+
+#include <algorithm>
+#include <chrono>
+#include "MyDB_Conjunction.h"
+
+using namespace std;
+
+// breaks a predicate into its conjuncts, going down through any && that it starts with;
+// whatever is in square brackets (a string constant, say) is skipped over
+static void splitConjuncts (string pred, vector <string> &into) {
+
+	size_t start = pred.find_first_not_of (" \t\n");
+	if (start == string :: npos || pred.compare (start, 2, "&&") != 0) {
+		into.push_back (pred);
+		return;
+	}
+
+	// find the comma between the two sides, and the paren that closes the &&
+	size_t open = pred.find ('(', start);
+	size_t comma = string :: npos;
+	int depth = 0;
+	bool inBrackets = false;
+	for (size_t i = open; i < pred.size (); i++) {
+		if (inBrackets) {
+			inBrackets = (pred[i] != ']');
+		} else if (pred[i] == '[') {
+			inBrackets = true;
+		} else if (pred[i] == '(') {
+			depth++;
+		} else if (pred[i] == ',' && depth == 1 && comma == string :: npos) {
+			comma = i;
+		} else if (pred[i] == ')' && --depth == 0) {
+			if (comma == string :: npos)
+				break;
+			splitConjuncts (pred.substr (open + 1, comma - open - 1), into);
+			splitConjuncts (pred.substr (comma + 1, i - comma - 1), into);
+			return;
+		}
+	}
+
+	// not something that we understand, so it is left whole
+	into.push_back (pred);
+}
+
+// how long it has been since the given time, in nanoseconds
+static inline double nanosSince (chrono :: steady_clock :: time_point start) {
+	return chrono :: duration_cast <chrono :: nanoseconds> (chrono :: steady_clock :: now () - start).count ();
+}
+
+MyDB_Conjunction :: MyDB_Conjunction (MyDB_RecordPtr rec, string predicate) {
+
+	vector <string> texts;
+	splitConjuncts (predicate, texts);
+	for (string &text : texts) {
+		MyDB_ExprProgramPtr prog = rec->compileProgram (text);
+		conjuncts.push_back ({text, prog, prog->canTrap (), 0, 0, 0});
+	}
+
+	// until there are samples, the ones with the fewest instructions go first
+	sortBetweenTraps ([] (const Conjunct &lhs, const Conjunct &rhs) {
+		return lhs.prog->size () < rhs.prog->size ();
+	});
+
+	sinceSample = 0;
+	numSamples = 0;
+}
+
+bool MyDB_Conjunction :: run () {
+
+	// most of the time, the conjuncts are run until one says no
+	if (++sinceSample < CONJUNCTION_SAMPLE_EVERY) {
+		for (Conjunct &c : conjuncts) {
+			if (!c.prog->runBool ())
+				return false;
+		}
+		return true;
+	}
+
+	// but a sample runs all of them, and times each one (except for one that can trap,
+	// which is only run if the ones before it said yes)
+	sinceSample = 0;
+	bool accepted = true;
+	for (Conjunct &c : conjuncts) {
+		if (c.canTrap && !accepted)
+			continue;
+		auto start = chrono :: steady_clock :: now ();
+		bool passed = c.prog->runBool ();
+		c.nanos += nanosSince (start);
+		c.seen++;
+		c.passed += passed;
+		accepted = accepted && passed;
+	}
+	sampled ();
+	return accepted;
+}
+
+int MyDB_Conjunction :: select (MyDB_Record *source, void **recs, int numRecs, int *selected) {
+
+	if (++sinceSample >= CONJUNCTION_SAMPLE_EVERY) {
+		sinceSample = 0;
+		sampleBatch (source, recs, numRecs, selected);
+	}
+
+	return selectFirst (source, recs, numRecs, selected, conjuncts.size ());
+}
+
+int MyDB_Conjunction :: selectFirst (MyDB_Record *source, void **recs, int numRecs, int *selected, size_t howMany) {
+
+	if (howMany == 0) {
+		for (int i = 0; i < numRecs; i++)
+			selected[i] = i;
+		return numRecs;
+	}
+
+	// the first conjunct is run over everything, and each one after that is only run
+	// over what the ones before it let through
+	int numSelected = conjuncts[0].prog->select (source, recs, numRecs, selected);
+	for (size_t i = 1; i < howMany && numSelected > 0; i++)
+		numSelected = conjuncts[i].prog->refine (source, recs, selected, numSelected);
+	return numSelected;
+}
+
+void MyDB_Conjunction :: sampleBatch (MyDB_Record *source, void **recs, int numRecs, int *scratch) {
+	for (size_t i = 0; i < conjuncts.size (); i++) {
+
+		// one that can trap is only run over the records that the ones before it let
+		// through (which are found first, and are not timed)
+		Conjunct &c = conjuncts[i];
+		int numIn = c.canTrap ? selectFirst (source, recs, numRecs, scratch, i) : numRecs;
+		auto start = chrono :: steady_clock :: now ();
+		if (c.canTrap)
+			c.passed += (numIn == 0) ? 0 : c.prog->refine (source, recs, scratch, numIn);
+		else
+			c.passed += c.prog->select (source, recs, numRecs, scratch);
+		c.nanos += nanosSince (start);
+		c.seen += numIn;
+	}
+	sampled ();
+}
+
+void MyDB_Conjunction :: sampled () {
+
+	if (++numSamples < CONJUNCTION_REORDER_AFTER)
+		return;
+	numSamples = 0;
+
+	// the expected cost of a conjunct, per record that it throws out
+	auto rank = [] (const Conjunct &c) {
+		if (c.seen == 0)
+			return 0.0;
+		double perRecord = c.nanos / c.seen;
+		double thrownOut = 1.0 - c.passed / c.seen;
+		return thrownOut <= 0 ? perRecord * 1e9 : perRecord / thrownOut;
+	};
+	sortBetweenTraps ([&] (const Conjunct &lhs, const Conjunct &rhs) {
+		return rank (lhs) < rank (rhs);
+	});
+
+	// so that newer samples count for more
+	for (Conjunct &c : conjuncts) {
+		c.seen /= 2;
+		c.passed /= 2;
+		c.nanos /= 2;
+	}
+}
+
+void MyDB_Conjunction :: sortBetweenTraps (function <bool (const Conjunct &, const Conjunct &)> lessThan) {
+
+	// one that can trap stays where it is, so the ones that were before it in the
+	// predicate (which may be what keeps it from trapping) are still run first
+	auto start = conjuncts.begin ();
+	for (auto next = conjuncts.begin (); next != conjuncts.end (); next++) {
+		if (next->canTrap) {
+			stable_sort (start, next, lessThan);
+			start = next + 1;
+		}
+	}
+	stable_sort (start, conjuncts.end (), lessThan);
+}
+
+vector <string> MyDB_Conjunction :: getOrder () {
+	vector <string> order;
+	for (Conjunct &c : conjuncts)
+		order.push_back (c.text);
+	return order;
+}
+
+#endif
@@ -0,0 +1,1033 @@
+
+#ifndef EXPR_PROGRAM_C
+#define EXPR_PROGRAM_C
+
+#include <algorithm>
+#include "MyDB_ExprProgram.h"
+#include "MyDB_Record.h"
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+using namespace std;
+
+// compares two string registers (like strcmp)
+static inline int compareChars (const MyDB_ExprRegister &lhs, const MyDB_ExprRegister &rhs) {
+	int res = memcmp (lhs.str.chars, rhs.str.chars, lhs.str.len < rhs.str.len ? lhs.str.len : rhs.str.len);
+	if (res != 0)
+		return res;
+	return (lhs.str.len < rhs.str.len) ? -1 : (lhs.str.len > rhs.str.len);
+}
+
+// points a string register at a string that was built when the program ran
+static inline void setString (MyDB_ExprRegister &reg, const string &val) {
+	reg.str.chars = val.c_str ();
+	reg.str.len = val.size ();
+}
+
+// the loops that run one instruction over a batch
+template <class Out, class In, class Op>
+static inline void batchLoop (Out *dest, In *lhs, In *rhs, int numRecs, Op op) {
+	for (int i = 0; i < numRecs; i++)
+		dest[i] = op (lhs[i], rhs[i]);
+}
+
+template <class Out, class In, class Op>
+static inline void batchLoop (Out *dest, In *lhs, int numRecs, Op op) {
+	for (int i = 0; i < numRecs; i++)
+		dest[i] = op (lhs[i]);
+}
+
+MyDB_ExprProgram :: MyDB_ExprProgram () {
+	viewOf = nullptr;
+	nativeRun = nullptr;
+	nativeBatch = nullptr;
+	numRuns = 0;
+	triedNative = false;
+}
+
+int MyDB_ExprProgram :: newRegister (MyDB_ValueType type) {
+	// every register starts out as a valid value of its type (even one that is only
+	// written on the skipped side of an && or ||, which is then read, but ignored)
+	MyDB_ExprRegister reg;
+	reg.str.chars = nullptr;
+	reg.str.len = 0;
+	if (type == StringValue)
+		reg.str.chars = "";
+	regs.push_back (reg);
+	types.push_back (type);
+	strings.push_back ("");
+	isConstant.push_back (true);
+	return regs.size () - 1;
+}
+
+int MyDB_ExprProgram :: emit (MyDB_ExprOp op, int lhs, int rhs, MyDB_ValueType type) {
+
+	// if the same instruction has been emitted, its register is used again; operators
+	// for which the order does not matter look up their registers in order, so that
+	// (say) a + b and b + a are only worked out once
+	bool commutes = (op == AddInt || op == AddDouble || op == MulInt || op == MulDouble ||
+		(op >= EqInt && op <= NeqBool) || op == AndBool || op == OrBool);
+	tuple <int, int, int> key (op, commutes ? min (lhs, rhs) : lhs, commutes ? max (lhs, rhs) : rhs);
+	auto found = sameAs.find (key);
+	if (found != sameAs.end ())
+		return found->second;
+
+	int dest = newRegister (type);
+	MyDB_ExprInstruction ins = {op, dest, lhs, rhs};
+
+	// if everything that the instruction reads is a constant, it is run right now, and
+	// what it gives is a constant too; an integer divide by zero is left to fail when
+	// it runs (if it ever does, since it may be on the skipped side of an && or ||)
+	bool unary = (op == IntToDouble || op == IntToString || op == DoubleToString ||
+		op == BoolToString || op == NegInt || op == NegDouble || op == NotBool);
+	if (op > LoadBool && isConstant[lhs] && (unary || isConstant[rhs]) && !(op == DivInt && regs[rhs].intVal == 0)) {
+		pointStrings ();
+		step (ins);
+		auto same = constants.find (make_pair (type, constantBytes (dest)));
+		if (same == constants.end ()) {
+			constants[make_pair (type, constantBytes (dest))] = dest;
+		} else {
+			regs.pop_back ();
+			types.pop_back ();
+			strings.pop_back ();
+			isConstant.pop_back ();
+			dest = same->second;
+		}
+	} else {
+		isConstant[dest] = false;
+		code.push_back (ins);
+	}
+
+	sameAs[key] = dest;
+	return dest;
+}
+
+int MyDB_ExprProgram :: constantRegister (MyDB_ValueType type, string bytes) {
+	auto same = constants.find (make_pair (type, bytes));
+	if (same != constants.end ())
+		return same->second;
+	return constants[make_pair (type, bytes)] = newRegister (type);
+}
+
+string MyDB_ExprProgram :: constantBytes (int reg) {
+	if (types[reg] == IntValue)
+		return string ((char *) &regs[reg].intVal, sizeof (int));
+	else if (types[reg] == DoubleValue)
+		return string ((char *) &regs[reg].doubleVal, sizeof (double));
+	else if (types[reg] == BoolValue)
+		return regs[reg].boolVal ? "1" : "0";
+	else
+		return strings[reg];
+}
+
+void MyDB_ExprProgram :: forget (size_t fromInstruction) {
+
+	vector <bool> forgotten (regs.size (), false);
+	for (size_t i = fromInstruction; i < code.size (); i++)
+		if (code[i].dest >= 0)
+			forgotten[code[i].dest] = true;
+
+	for (auto i = sameAs.begin (); i != sameAs.end ();) {
+		if (forgotten[i->second])
+			i = sameAs.erase (i);
+		else
+			i++;
+	}
+}
+
+int MyDB_ExprProgram :: shortCircuit (MyDB_ExprOp op, int lhs, int rhs, size_t rhsStart) {
+
+	// the value of lhs that is the answer, whatever rhs is: false for &&, true for ||
+	bool decides = (op == OrBool);
+
+	// if lhs is a constant, either it is the answer (and rhs is not needed at all), or
+	// rhs is; likewise, a constant rhs that does not decide anything leaves just lhs
+	if (isConstant[lhs]) {
+		if (regs[lhs].boolVal != decides)
+			return rhs;
+		forget (rhsStart);
+		code.resize (rhsStart);
+		return lhs;
+	}
+	if ((isConstant[rhs] && regs[rhs].boolVal != decides) || lhs == rhs)
+		return lhs;
+
+	// otherwise, rhs's instructions are jumped over when lhs decides the answer (the
+	// && or || still comes out right, since it only looks at lhs then); what they work
+	// out may not be there, so nothing after this can share it
+	int numSkipped = code.size () - rhsStart;
+	if (numSkipped > 0) {
+		forget (rhsStart);
+		MyDB_ExprInstruction jump = {op == AndBool ? JumpIfFalse : JumpIfTrue, -1, lhs, numSkipped};
+		code.insert (code.begin () + rhsStart, jump);
+	}
+	return emit (op, lhs, rhs, BoolValue);
+}
+
+int MyDB_ExprProgram :: asDouble (pair <int, MyDB_AttTypePtr> &val) {
+	if (types[val.first] == IntValue)
+		return emit (IntToDouble, val.first, 0, DoubleValue);
+	return val.first;
+}
+
+int MyDB_ExprProgram :: asString (pair <int, MyDB_AttTypePtr> &val) {
+	if (types[val.first] == IntValue)
+		return emit (IntToString, val.first, 0, StringValue);
+	if (types[val.first] == DoubleValue)
+		return emit (DoubleToString, val.first, 0, StringValue);
+	if (types[val.first] == BoolValue)
+		return emit (BoolToString, val.first, 0, StringValue);
+	return val.first;
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: load (MyDB_Record *source, int whichAtt, MyDB_AttTypePtr type) {
+
+	// an attribute that is read twice is only loaded once
+	int which = find (inputs.begin (), inputs.end (), make_pair (source, whichAtt)) - inputs.begin ();
+	if (which == (int) inputs.size ())
+		inputs.push_back (make_pair (source, whichAtt));
+	if (type->isBool ())
+		return make_pair (emit (LoadBool, which, 0, BoolValue), type);
+	else if (type->promotableToInt ())
+		return make_pair (emit (LoadInt, which, 0, IntValue), type);
+	else if (type->promotableToDouble ())
+		return make_pair (emit (LoadDouble, which, 0, DoubleValue), type);
+	else
+		return make_pair (emit (LoadString, which, 0, StringValue), type);
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: intConstant (int val) {
+	int reg = constantRegister (IntValue, string ((char *) &val, sizeof (int)));
+	regs[reg].intVal = val;
+	return make_pair (reg, make_shared <MyDB_IntAttType> ());
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: doubleConstant (double val) {
+	int reg = constantRegister (DoubleValue, string ((char *) &val, sizeof (double)));
+	regs[reg].doubleVal = val;
+	return make_pair (reg, make_shared <MyDB_DoubleAttType> ());
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: boolConstant (bool val) {
+	int reg = constantRegister (BoolValue, val ? "1" : "0");
+	regs[reg].boolVal = val;
+	return make_pair (reg, make_shared <MyDB_BoolAttType> ());
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: stringConstant (string val) {
+
+	// the register is pointed at its characters in addResult, once they stop moving
+	int reg = constantRegister (StringValue, val);
+	strings[reg] = val;
+	return make_pair (reg, make_shared <MyDB_StringAttType> ());
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: plus (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs) {
+
+	// if both sides can be cast upwards to be ints, then do so
+	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
+		return make_pair (emit (AddInt, lhs.first, rhs.first, IntValue), make_shared <MyDB_IntAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be doubles, then do so
+	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
+		int l = asDouble (lhs), r = asDouble (rhs);
+		return make_pair (emit (AddDouble, l, r, DoubleValue), make_shared <MyDB_DoubleAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be strings, then do so
+	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
+		int l = asString (lhs), r = asString (rhs);
+		return make_pair (emit (AddString, l, r, StringValue), make_shared <MyDB_StringAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do anything with the plus.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: minus (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs) {
+
+	// if both sides can be cast upwards to be ints, then do so
+	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
+		return make_pair (emit (SubInt, lhs.first, rhs.first, IntValue), make_shared <MyDB_IntAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be doubles, then do so
+	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
+		int l = asDouble (lhs), r = asDouble (rhs);
+		return make_pair (emit (SubDouble, l, r, DoubleValue), make_shared <MyDB_DoubleAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do anything with the minus.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: times (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs) {
+
+	// if both sides can be cast upwards to be ints, then do so
+	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
+		return make_pair (emit (MulInt, lhs.first, rhs.first, IntValue), make_shared <MyDB_IntAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be doubles, then do so
+	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
+		int l = asDouble (lhs), r = asDouble (rhs);
+		return make_pair (emit (MulDouble, l, r, DoubleValue), make_shared <MyDB_DoubleAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do anything with the times.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: divide (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs) {
+
+	// if both sides can be cast upwards to be ints, then do so
+	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
+		return make_pair (emit (DivInt, lhs.first, rhs.first, IntValue), make_shared <MyDB_IntAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be doubles, then do so
+	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
+		int l = asDouble (lhs), r = asDouble (rhs);
+		return make_pair (emit (DivDouble, l, r, DoubleValue), make_shared <MyDB_DoubleAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do anything with the divide.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: unaryMinus (pair <int, MyDB_AttTypePtr> lhs) {
+
+	if (lhs.second->promotableToInt ()) {
+		return make_pair (emit (NegInt, lhs.first, 0, IntValue), make_shared <MyDB_IntAttType> ());
+
+	} else if (lhs.second->promotableToDouble ()) {
+		return make_pair (emit (NegDouble, lhs.first, 0, DoubleValue), make_shared <MyDB_DoubleAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do anything with the unary minus.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: gt (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs) {
+
+	// if both sides can be cast upwards to be ints, then do so
+	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
+		return make_pair (emit (GtInt, lhs.first, rhs.first, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be doubles, then do so
+	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
+		int l = asDouble (lhs), r = asDouble (rhs);
+		return make_pair (emit (GtDouble, l, r, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be strings, then do so
+	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
+		int l = asString (lhs), r = asString (rhs);
+		return make_pair (emit (GtString, l, r, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do anything with the >.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: lt (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs) {
+
+	// if both sides can be cast upwards to be ints, then do so
+	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
+		return make_pair (emit (LtInt, lhs.first, rhs.first, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be doubles, then do so
+	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
+		int l = asDouble (lhs), r = asDouble (rhs);
+		return make_pair (emit (LtDouble, l, r, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be strings, then do so
+	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
+		int l = asString (lhs), r = asString (rhs);
+		return make_pair (emit (LtString, l, r, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do anything with the <.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: eq (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs) {
+
+	// if both sides can be cast upwards to be ints, then do so
+	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
+		return make_pair (emit (EqInt, lhs.first, rhs.first, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be doubles, then do so
+	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
+		int l = asDouble (lhs), r = asDouble (rhs);
+		return make_pair (emit (EqDouble, l, r, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	} else if (lhs.second->isBool () && rhs.second->isBool ()) {
+		return make_pair (emit (EqBool, lhs.first, rhs.first, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be strings, then do so
+	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
+		int l = asString (lhs), r = asString (rhs);
+		return make_pair (emit (EqString, l, r, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do anything with the ==.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: neq (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs) {
+
+	// if both sides can be cast upwards to be ints, then do so
+	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
+		return make_pair (emit (NeqInt, lhs.first, rhs.first, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	} else if (lhs.second->isBool () && rhs.second->isBool ()) {
+		return make_pair (emit (NeqBool, lhs.first, rhs.first, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be doubles, then do so
+	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
+		int l = asDouble (lhs), r = asDouble (rhs);
+		return make_pair (emit (NeqDouble, l, r, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	// otherwise, if both sides can be cast upwards to be strings, then do so
+	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
+		int l = asString (lhs), r = asString (rhs);
+		return make_pair (emit (NeqString, l, r, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do anything with the !=.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: orr (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs, size_t rhsStart) {
+
+	if (lhs.second->isBool () && rhs.second->isBool ()) {
+		return make_pair (shortCircuit (OrBool, lhs.first, rhs.first, rhsStart), make_shared <MyDB_BoolAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do or on non booleans.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: andd (pair <int, MyDB_AttTypePtr> lhs, pair <int, MyDB_AttTypePtr> rhs, size_t rhsStart) {
+
+	if (lhs.second->isBool () && rhs.second->isBool ()) {
+		return make_pair (shortCircuit (AndBool, lhs.first, rhs.first, rhsStart), make_shared <MyDB_BoolAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do and on non booleans.\n";
+		exit (1);
+	}
+}
+
+pair <int, MyDB_AttTypePtr> MyDB_ExprProgram :: nott (pair <int, MyDB_AttTypePtr> lhs) {
+
+	if (lhs.second->isBool ()) {
+		return make_pair (emit (NotBool, lhs.first, 0, BoolValue), make_shared <MyDB_BoolAttType> ());
+
+	} else {
+		cout << "This is bad... cannot do not on non boolean.\n";
+		exit (1);
+	}
+}
+
+int MyDB_ExprProgram :: addResult (pair <int, MyDB_AttTypePtr> resultIn) {
+
+	results.push_back (resultIn.first);
+	resultVals.push_back (resultIn.second->createAtt ());
+
+	// once the results are in, no more registers will be added, so the string
+	// constants can be pointed at
+	pointStrings ();
+	return results.size () - 1;
+}
+
+void MyDB_ExprProgram :: pointStrings () {
+	for (size_t i = 0; i < regs.size (); i++) {
+		if (types[i] == StringValue) {
+			regs[i].str.chars = strings[i].c_str ();
+			regs[i].str.len = strings[i].size ();
+		}
+	}
+}
+
+bool MyDB_ExprProgram :: isJustLoad (MyDB_Record *&source, int &whichAtt) {
+	if (results.size () != 1 || code.size () != 1 || code[0].dest != results[0] || code[0].op > LoadBool)
+		return false;
+	source = inputs[code[0].lhs].first;
+	whichAtt = inputs[code[0].lhs].second;
+	return true;
+}
+
+size_t MyDB_ExprProgram :: size () {
+	return code.size ();
+}
+
+bool MyDB_ExprProgram :: canTrap () {
+	for (MyDB_ExprInstruction &i : code)
+		if (i.op == DivInt)
+			return true;
+	return false;
+}
+
+void MyDB_ExprProgram :: doLoad (MyDB_ExprInstruction &i) {
+	MyDB_ExprRegister &d = regs[i.dest];
+	MyDB_Value &val = inputs[i.lhs].first->getValue (inputs[i.lhs].second);
+	if (i.op == LoadInt)
+		d.intVal = val.intVal;
+	else if (i.op == LoadDouble)
+		d.doubleVal = val.doubleVal;
+	else if (i.op == LoadBool)
+		d.boolVal = val.boolVal;
+	else {
+		d.str.chars = val.getChars ();
+		d.str.len = val.len;
+	}
+}
+
+void MyDB_ExprProgram :: execute () {
+
+	countRuns (1);
+
+	// machine code does everything but the loads
+	if (nativeRun != nullptr) {
+		for (MyDB_ExprInstruction &i : nativeLoads)
+			doLoad (i);
+		nativeRun (regs.data ());
+		return;
+	}
+
+	MyDB_ExprRegister *r = regs.data ();
+	for (size_t pc = 0; pc < code.size (); pc++) {
+
+		MyDB_ExprInstruction &i = code[pc];
+
+		// a load reads from one of the inputs, rather than from registers, and a jump
+		// skips the other side of an && or || that is already decided
+		if (i.op <= LoadBool)
+			doLoad (i);
+		else if (i.op == JumpIfFalse && !r[i.lhs].boolVal)
+			pc += i.rhs;
+		else if (i.op == JumpIfTrue && r[i.lhs].boolVal)
+			pc += i.rhs;
+		else if (i.op < JumpIfFalse)
+			step (i);
+	}
+}
+
+inline void MyDB_ExprProgram :: step (MyDB_ExprInstruction &i) {
+
+	MyDB_ExprRegister *r = regs.data ();
+	MyDB_ExprRegister &d = r[i.dest];
+	MyDB_ExprRegister &lhs = r[i.lhs];
+	MyDB_ExprRegister &rhs = r[i.rhs];
+	switch (i.op) {
+
+		case IntToDouble: d.doubleVal = lhs.intVal; break;
+		case IntToString: setString (d, strings[i.dest] = to_string (lhs.intVal)); break;
+		case DoubleToString: setString (d, strings[i.dest] = to_string (lhs.doubleVal)); break;
+		case BoolToString: setString (d, strings[i.dest] = lhs.boolVal ? "true" : "false"); break;
+
+		case AddInt: d.intVal = lhs.intVal + rhs.intVal; break;
+		case AddDouble: d.doubleVal = lhs.doubleVal + rhs.doubleVal; break;
+		case AddString:
+			setString (d, strings[i.dest].assign (lhs.str.chars, lhs.str.len).append (rhs.str.chars, rhs.str.len));
+			break;
+		case SubInt: d.intVal = lhs.intVal - rhs.intVal; break;
+		case SubDouble: d.doubleVal = lhs.doubleVal - rhs.doubleVal; break;
+		case MulInt: d.intVal = lhs.intVal * rhs.intVal; break;
+		case MulDouble: d.doubleVal = lhs.doubleVal * rhs.doubleVal; break;
+		case DivInt: d.intVal = lhs.intVal / rhs.intVal; break;
+		case DivDouble: d.doubleVal = lhs.doubleVal / rhs.doubleVal; break;
+		case NegInt: d.intVal = -lhs.intVal; break;
+		case NegDouble: d.doubleVal = -lhs.doubleVal; break;
+
+		case GtInt: d.boolVal = lhs.intVal > rhs.intVal; break;
+		case GtDouble: d.boolVal = lhs.doubleVal > rhs.doubleVal; break;
+		case GtString: d.boolVal = compareChars (lhs, rhs) > 0; break;
+		case LtInt: d.boolVal = lhs.intVal < rhs.intVal; break;
+		case LtDouble: d.boolVal = lhs.doubleVal < rhs.doubleVal; break;
+		case LtString: d.boolVal = compareChars (lhs, rhs) < 0; break;
+		case EqInt: d.boolVal = lhs.intVal == rhs.intVal; break;
+		case EqDouble: d.boolVal = lhs.doubleVal == rhs.doubleVal; break;
+		case EqString: d.boolVal = lhs.str.len == rhs.str.len && compareChars (lhs, rhs) == 0; break;
+		case EqBool: d.boolVal = lhs.boolVal == rhs.boolVal; break;
+		case NeqInt: d.boolVal = lhs.intVal != rhs.intVal; break;
+		case NeqDouble: d.boolVal = lhs.doubleVal != rhs.doubleVal; break;
+		case NeqString: d.boolVal = lhs.str.len != rhs.str.len || compareChars (lhs, rhs) != 0; break;
+		case NeqBool: d.boolVal = lhs.boolVal != rhs.boolVal; break;
+
+		case AndBool: d.boolVal = lhs.boolVal && rhs.boolVal; break;
+		case OrBool: d.boolVal = lhs.boolVal || rhs.boolVal; break;
+		case NotBool: d.boolVal = !lhs.boolVal; break;
+
+		default: break;
+	}
+}
+
+MyDB_AttValPtr MyDB_ExprProgram :: run () {
+	execute ();
+	return getResult (0);
+}
+
+MyDB_AttValPtr MyDB_ExprProgram :: getResult (int whichResult) {
+
+	int result = results[whichResult];
+	MyDB_Value &val = resultVals[whichResult]->getValue ();
+	MyDB_ExprRegister &answer = regs[result];
+	if (types[result] == IntValue)
+		val.intVal = answer.intVal;
+	else if (types[result] == DoubleValue)
+		val.doubleVal = answer.doubleVal;
+	else if (types[result] == BoolValue)
+		val.boolVal = answer.boolVal;
+	else
+		val.setChars (answer.str.chars, answer.str.len);
+	return resultVals[whichResult];
+}
+
+bool MyDB_ExprProgram :: runBool () {
+	execute ();
+	return regs[results[0]].boolVal;
+}
+
+void MyDB_ExprProgram :: setUpBatch () {
+
+	batchMemory.resize (regs.size () * EXPR_BATCH_SIZE * 2);
+	batchStrings.resize (regs.size ());
+	batchRecs.resize (EXPR_BATCH_SIZE);
+	for (size_t reg = 0; reg < regs.size (); reg++)
+		batchColumns.push_back (&batchMemory[reg * EXPR_BATCH_SIZE * 2]);
+
+	// the registers that are not written by an instruction are constants, so their
+	// columns are filled in now, once and for all
+	vector <bool> written (regs.size (), false);
+	size_t numJumps = 0;
+	batchDivides = false;
+	for (MyDB_ExprInstruction &i : code) {
+		batchDivides = batchDivides || (i.op == DivInt);
+		if (i.op >= JumpIfFalse) {
+			numJumps++;
+			continue;
+		}
+		written[i.dest] = true;
+		if (i.op == IntToString || i.op == DoubleToString || i.op == BoolToString || i.op == AddString)
+			batchStrings[i.dest].resize (EXPR_BATCH_SIZE);
+	}
+
+	batchLive.resize (numJumps * EXPR_BATCH_SIZE);
+
+	for (size_t reg = 0; reg < regs.size (); reg++) {
+		if (written[reg])
+			continue;
+		for (int i = 0; i < EXPR_BATCH_SIZE; i++) {
+			if (types[reg] == IntValue)
+				intColumn (reg)[i] = regs[reg].intVal;
+			else if (types[reg] == DoubleValue)
+				doubleColumn (reg)[i] = regs[reg].doubleVal;
+			else if (types[reg] == BoolValue)
+				boolColumn (reg)[i] = regs[reg].boolVal;
+			else
+				stringColumn (reg)[i] = regs[reg];
+		}
+	}
+}
+
+void MyDB_ExprProgram :: runBatch (MyDB_Record *source, void **recs, int *which, int numRecs) {
+
+	if (batchMemory.empty ())
+		setUpBatch ();
+	countRuns (numRecs);
+
+	// get a view for the records, if it is not the one that we already have
+	if (viewOf != source) {
+		batchView = source->getView ();
+		viewOf = source;
+	}
+
+	// find all of the records
+	char **batch = batchRecs.data ();
+	for (int i = 0; i < numRecs; i++)
+		batch[i] = (char *) recs[which == nullptr ? i : which[i]];
+
+	// machine code does everything but the loads, all in one loop over the records
+	vector <MyDB_ExprInstruction> &todo = (nativeBatch != nullptr) ? nativeLoads : code;
+	vector <size_t> rangeEnds;
+	for (size_t pc = 0; pc < todo.size (); pc++) {
+
+		MyDB_ExprInstruction &ins = todo[pc];
+		while (rangeEnds.size () > 0 && rangeEnds.back () == pc)
+			rangeEnds.pop_back ();
+
+		// over a batch, both sides of an && or || are worked out, since doing that
+		// without branching is cheaper than a jump for each record.  But a divide
+		// on the right side is only done for the records where the left side does
+		// not decide the answer (the others could be dividing by zero), so those
+		// are noted in the range's column
+		if (ins.op >= JumpIfFalse) {
+			if (!batchDivides)
+				continue;
+			unsigned char *outer = rangeEnds.size () > 0 ? liveColumn (rangeEnds.size () - 1) : nullptr;
+			unsigned char *live = liveColumn (rangeEnds.size ());
+			unsigned char *lhs = boolColumn (ins.lhs);
+			unsigned char decides = (ins.op == JumpIfTrue);
+			for (int i = 0; i < numRecs; i++)
+				live[i] = (lhs[i] != decides) & (outer == nullptr ? 1 : outer[i]);
+			rangeEnds.push_back (pc + 1 + ins.rhs);
+			continue;
+		}
+
+		int n = numRecs;
+
+		// a load of one of source's attributes reads it from each of the records; the
+		// data of an attribute comes after the short with its length
+		if (ins.op <= LoadBool && inputs[ins.lhs].first == source) {
+			int whichAtt = inputs[ins.lhs].second;
+			for (int i = 0; i < n; i++) {
+				batchView.setPointer (batch[i]);
+				char *att = batchView.getAtt (whichAtt);
+				char *data = att + sizeof (short);
+				if (ins.op == LoadInt)
+					intColumn (ins.dest)[i] = *((int *) data);
+				else if (ins.op == LoadDouble)
+					doubleColumn (ins.dest)[i] = *((double *) data);
+				else if (ins.op == LoadBool)
+					boolColumn (ins.dest)[i] = (*data == 1);
+				else {
+					stringColumn (ins.dest)[i].str.chars = data;
+					stringColumn (ins.dest)[i].str.len = *((short *) att) - sizeof (short) - 1;
+				}
+			}
+			continue;
+		}
+
+		// any other load is the same for all of them
+		if (ins.op <= LoadBool) {
+			MyDB_Value &val = inputs[ins.lhs].first->getValue (inputs[ins.lhs].second);
+			for (int i = 0; i < n; i++) {
+				if (ins.op == LoadInt)
+					intColumn (ins.dest)[i] = val.intVal;
+				else if (ins.op == LoadDouble)
+					doubleColumn (ins.dest)[i] = val.doubleVal;
+				else if (ins.op == LoadBool)
+					boolColumn (ins.dest)[i] = val.boolVal;
+				else {
+					stringColumn (ins.dest)[i].str.chars = val.getChars ();
+					stringColumn (ins.dest)[i].str.len = val.len;
+				}
+			}
+			continue;
+		}
+
+		int d = ins.dest, l = ins.lhs, r = ins.rhs;
+		switch (ins.op) {
+
+			case IntToDouble:
+				batchLoop (doubleColumn (d), intColumn (l), n, [] (int a) {return (double) a;});
+				break;
+			case IntToString:
+				for (int i = 0; i < n; i++)
+					setString (stringColumn (d)[i], batchStrings[d][i] = to_string (intColumn (l)[i]));
+				break;
+			case DoubleToString:
+				for (int i = 0; i < n; i++)
+					setString (stringColumn (d)[i], batchStrings[d][i] = to_string (doubleColumn (l)[i]));
+				break;
+			case BoolToString:
+				for (int i = 0; i < n; i++)
+					setString (stringColumn (d)[i], batchStrings[d][i] = boolColumn (l)[i] ? "true" : "false");
+				break;
+
+			case AddInt: batchLoop (intColumn (d), intColumn (l), intColumn (r), n, [] (int a, int b) {return a + b;}); break;
+			case AddDouble: batchLoop (doubleColumn (d), doubleColumn (l), doubleColumn (r), n, [] (double a, double b) {return a + b;}); break;
+			case AddString:
+				for (int i = 0; i < n; i++) {
+					MyDB_ExprRegister &a = stringColumn (l)[i], &b = stringColumn (r)[i];
+					setString (stringColumn (d)[i], batchStrings[d][i].assign (a.str.chars, a.str.len).append (b.str.chars, b.str.len));
+				}
+				break;
+			case SubInt: batchLoop (intColumn (d), intColumn (l), intColumn (r), n, [] (int a, int b) {return a - b;}); break;
+			case SubDouble: batchLoop (doubleColumn (d), doubleColumn (l), doubleColumn (r), n, [] (double a, double b) {return a - b;}); break;
+			case MulInt: batchLoop (intColumn (d), intColumn (l), intColumn (r), n, [] (int a, int b) {return a * b;}); break;
+			case MulDouble: batchLoop (doubleColumn (d), doubleColumn (l), doubleColumn (r), n, [] (double a, double b) {return a * b;}); break;
+			case DivInt:
+				if (rangeEnds.size () == 0) {
+					batchLoop (intColumn (d), intColumn (l), intColumn (r), n, [] (int a, int b) {return a / b;});
+				} else {
+					unsigned char *live = liveColumn (rangeEnds.size () - 1);
+					for (int i = 0; i < n; i++)
+						intColumn (d)[i] = intColumn (l)[i] / (live[i] ? intColumn (r)[i] : 1);
+				}
+				break;
+			case DivDouble: batchLoop (doubleColumn (d), doubleColumn (l), doubleColumn (r), n, [] (double a, double b) {return a / b;}); break;
+			case NegInt: batchLoop (intColumn (d), intColumn (l), n, [] (int a) {return -a;}); break;
+			case NegDouble: batchLoop (doubleColumn (d), doubleColumn (l), n, [] (double a) {return -a;}); break;
+
+			case GtInt: batchLoop (boolColumn (d), intColumn (l), intColumn (r), n, [] (int a, int b) {return a > b;}); break;
+			case GtDouble: batchLoop (boolColumn (d), doubleColumn (l), doubleColumn (r), n, [] (double a, double b) {return a > b;}); break;
+			case LtInt: batchLoop (boolColumn (d), intColumn (l), intColumn (r), n, [] (int a, int b) {return a < b;}); break;
+			case LtDouble: batchLoop (boolColumn (d), doubleColumn (l), doubleColumn (r), n, [] (double a, double b) {return a < b;}); break;
+			case EqInt: batchLoop (boolColumn (d), intColumn (l), intColumn (r), n, [] (int a, int b) {return a == b;}); break;
+			case EqDouble: batchLoop (boolColumn (d), doubleColumn (l), doubleColumn (r), n, [] (double a, double b) {return a == b;}); break;
+			case NeqInt: batchLoop (boolColumn (d), intColumn (l), intColumn (r), n, [] (int a, int b) {return a != b;}); break;
+			case NeqDouble: batchLoop (boolColumn (d), doubleColumn (l), doubleColumn (r), n, [] (double a, double b) {return a != b;}); break;
+			case EqBool:
+				batchLoop (boolColumn (d), boolColumn (l), boolColumn (r), n, [] (unsigned char a, unsigned char b) {return a == b;});
+				break;
+			case NeqBool:
+				batchLoop (boolColumn (d), boolColumn (l), boolColumn (r), n, [] (unsigned char a, unsigned char b) {return a != b;});
+				break;
+
+			case GtString:
+			case LtString:
+			case EqString:
+			case NeqString:
+				for (int i = 0; i < n; i++) {
+					MyDB_ExprRegister &a = stringColumn (l)[i], &b = stringColumn (r)[i];
+					if (ins.op == GtString)
+						boolColumn (d)[i] = compareChars (a, b) > 0;
+					else if (ins.op == LtString)
+						boolColumn (d)[i] = compareChars (a, b) < 0;
+					else if (ins.op == EqString)
+						boolColumn (d)[i] = a.str.len == b.str.len && compareChars (a, b) == 0;
+					else
+						boolColumn (d)[i] = a.str.len != b.str.len || compareChars (a, b) != 0;
+				}
+				break;
+
+			// the bools are all zero or one, so these are just bit operations
+			case AndBool:
+				batchLoop (boolColumn (d), boolColumn (l), boolColumn (r), n, [] (unsigned char a, unsigned char b) {return a & b;});
+				break;
+			case OrBool:
+				batchLoop (boolColumn (d), boolColumn (l), boolColumn (r), n, [] (unsigned char a, unsigned char b) {return a | b;});
+				break;
+			case NotBool:
+				batchLoop (boolColumn (d), boolColumn (l), n, [] (unsigned char a) {return a ^ 1;});
+				break;
+
+			default: break;
+		}
+	}
+
+	if (nativeBatch != nullptr)
+		nativeBatch (batchColumns.data (), numRecs);
+}
+
+int MyDB_ExprProgram :: select (MyDB_Record *source, void **recs, int numRecs, int *selected) {
+
+	runBatch (source, recs, nullptr, numRecs);
+
+	// write every record's position, but only move past the ones that are accepted
+	unsigned char *accepted = boolColumn (results[0]);
+	int numSelected = 0;
+	for (int i = 0; i < numRecs; i++) {
+		selected[numSelected] = i;
+		numSelected += accepted[i];
+	}
+	return numSelected;
+}
+
+int MyDB_ExprProgram :: refine (MyDB_Record *source, void **recs, int *selected, int numSelected) {
+
+	runBatch (source, recs, selected, numSelected);
+
+	// as in select; a record is never written to before it has been looked at
+	unsigned char *accepted = boolColumn (results[0]);
+	int numKept = 0;
+	for (int i = 0; i < numSelected; i++) {
+		selected[numKept] = selected[i];
+		numKept += accepted[i];
+	}
+	return numKept;
+}
+
+MyDB_AttValPtr MyDB_ExprProgram :: getBatchResult (int whichRec, int whichResult) {
+
+	int result = results[whichResult];
+	MyDB_Value &val = resultVals[whichResult]->getValue ();
+	if (types[result] == IntValue)
+		val.intVal = intColumn (result)[whichRec];
+	else if (types[result] == DoubleValue)
+		val.doubleVal = doubleColumn (result)[whichRec];
+	else if (types[result] == BoolValue)
+		val.boolVal = boolColumn (result)[whichRec];
+	else
+		val.setChars (stringColumn (result)[whichRec].str.chars, stringColumn (result)[whichRec].str.len);
+	return resultVals[whichResult];
+}
+
+bool MyDB_ExprProgram :: isNative () {
+	return native != nullptr;
+}
+
+bool MyDB_ExprProgram :: compileNative () {
+
+	triedNative = true;
+	string source = nativeSource ();
+	if (source == "")
+		return false;
+
+	MyDB_NativeCodePtr lib = MyDB_NativeCode :: load (source);
+	if (lib == nullptr)
+		return false;
+	void *runSym = lib->getSymbol ("mydb_run");
+	void *batchSym = lib->getSymbol ("mydb_batch");
+	if (runSym == nullptr || batchSym == nullptr)
+		return false;
+
+	nativeLoads.clear ();
+	for (MyDB_ExprInstruction &i : code)
+		if (i.op <= LoadBool)
+			nativeLoads.push_back (i);
+	native = lib;
+	nativeRun = (void (*) (MyDB_ExprRegister *)) runSym;
+	nativeBatch = (void (*) (void **, int)) batchSym;
+	return true;
+}
+
+string MyDB_ExprProgram :: nativeRegister (int reg, bool inBatch, vector <bool> &computed) {
+
+	// in a batch, what an instruction works out is kept in a local, and anything else
+	// (a load or a constant) is read from its column
+	if (inBatch)
+		return (computed[reg] ? "v" : "c") + to_string (reg) + (computed[reg] ? "" : "[i]");
+
+	string field = types[reg] == IntValue ? ".i" : types[reg] == DoubleValue ? ".d" : types[reg] == BoolValue ? ".b" : "";
+	return "r[" + to_string (reg) + "]" + field;
+}
+
+string MyDB_ExprProgram :: nativeSource () {
+
+	// strings that are built need memory that belongs to the program, so those programs
+	// stay interpreted; so do ones that do nothing but load
+	vector <bool> computed (regs.size (), false);
+	vector <bool> jumpedTo (code.size () + 1, false);
+	bool anyComputed = false, anyDivides = false;
+	for (size_t pc = 0; pc < code.size (); pc++) {
+		MyDB_ExprInstruction &i = code[pc];
+		if (i.op == IntToString || i.op == DoubleToString || i.op == BoolToString || i.op == AddString)
+			return "";
+		anyDivides = anyDivides || (i.op == DivInt);
+		if (i.op >= JumpIfFalse)
+			jumpedTo[pc + 1 + i.rhs] = true;
+		else if (i.op > LoadBool)
+			computed[i.dest] = anyComputed = true;
+	}
+	if (!anyComputed)
+		return "";
+
+	// the C++ types of registers: bools are kept as bytes in the columns of a batch,
+	// and a string is an R, as it is in a register
+	auto localType = [&] (int reg) -> string {
+		return types[reg] == IntValue ? "int" : types[reg] == DoubleValue ? "double" : types[reg] == BoolValue ? "bool" : "R";
+	};
+	auto columnType = [&] (int reg) -> string {
+		return types[reg] == BoolValue ? "unsigned char" : localType (reg);
+	};
+
+	ostringstream run, batch, columns;
+	vector <bool> declared (regs.size (), false);
+	auto declare = [&] (int reg) {
+		if (!computed[reg] && !declared[reg]) {
+			columns << "\t" << columnType (reg) << " *c" << reg << " = (" << columnType (reg) << " *) c[" << reg << "];\n";
+			declared[reg] = true;
+		}
+	};
+	for (int inBatch = 0; inBatch < 2; inBatch++) {
+		vector <pair <size_t, string>> ranges;
+		for (size_t pc = 0; pc < code.size (); pc++) {
+
+			// run () jumps over the other side of an && or || that is decided, and a
+			// batch just works out both sides (the loads are done before either); an
+			// integer divide on the other side is only done if the first side does not
+			// decide the answer, so each side gets a flag for that (as in runBatch)
+			MyDB_ExprInstruction &i = code[pc];
+			while (ranges.size () > 0 && ranges.back ().first == pc)
+				ranges.pop_back ();
+			if (!inBatch && jumpedTo[pc])
+				run << "L" << pc << ": ;\n";
+			if (!inBatch && i.op >= JumpIfFalse)
+				run << "\tif (" << (i.op == JumpIfFalse ? "!" : "") << nativeRegister (i.lhs, false, computed) << ") goto L" << pc + 1 + i.rhs << ";\n";
+			if (inBatch && anyDivides && i.op >= JumpIfFalse) {
+				declare (i.lhs);
+				string live = "m" + to_string (pc);
+				batch << "\t\tbool " << live << " = " << (ranges.size () > 0 ? ranges.back ().second + " && " : "");
+				batch << (i.op == JumpIfFalse ? "" : "!") << nativeRegister (i.lhs, true, computed) << ";\n";
+				ranges.push_back (make_pair (pc + 1 + i.rhs, live));
+			}
+			if (i.op <= LoadBool || i.op >= JumpIfFalse)
+				continue;
+
+			string l = nativeRegister (i.lhs, inBatch, computed);
+			string r = nativeRegister (i.rhs, inBatch, computed);
+			string expr;
+			switch (i.op) {
+				case IntToDouble: expr = "(double) " + l; break;
+				case AddInt: case AddDouble: expr = l + " + " + r; break;
+				case SubInt: case SubDouble: expr = l + " - " + r; break;
+				case MulInt: case MulDouble: expr = l + " * " + r; break;
+				case DivInt:
+					expr = l + " / " + (inBatch && ranges.size () > 0 ? "(" + ranges.back ().second + " ? " + r + " : 1)" : r);
+					break;
+				case DivDouble: expr = l + " / " + r; break;
+				case NegInt: case NegDouble: expr = "-" + l; break;
+				case GtInt: case GtDouble: expr = l + " > " + r; break;
+				case LtInt: case LtDouble: expr = l + " < " + r; break;
+				case EqInt: case EqDouble: case EqBool: expr = l + " == " + r; break;
+				case NeqInt: case NeqDouble: case NeqBool: expr = l + " != " + r; break;
+				case GtString: expr = "cmp (" + l + ", " + r + ") > 0"; break;
+				case LtString: expr = "cmp (" + l + ", " + r + ") < 0"; break;
+				case EqString: expr = l + ".s.n == " + r + ".s.n && cmp (" + l + ", " + r + ") == 0"; break;
+				case NeqString: expr = l + ".s.n != " + r + ".s.n || cmp (" + l + ", " + r + ") != 0"; break;
+				case AndBool: expr = l + " & " + r; break;
+				case OrBool: expr = l + " | " + r; break;
+				case NotBool: expr = "!" + l; break;
+				default: break;
+			}
+
+			if (!inBatch) {
+				run << "\t" << nativeRegister (i.dest, false, computed) << " = " << expr << ";\n";
+				continue;
+			}
+
+			// the columns that are read are declared before the loop
+			int reads[] = {i.lhs, i.op == IntToDouble || i.op == NegInt || i.op == NegDouble || i.op == NotBool ? i.lhs : i.rhs};
+			for (int reg : reads)
+				declare (reg);
+			batch << "\t\t" << localType (i.dest) << " v" << i.dest << " = " << expr << ";\n";
+		}
+	}
+
+	ostringstream source;
+	source << "\n#include <string.h>\n\n";
+	source << "struct R {\n\tunion {\n\t\tint i;\n\t\tdouble d;\n\t\tbool b;\n";
+	source << "\t\tstruct {\n\t\t\tconst char *c;\n\t\t\tunsigned n;\n\t\t} s;\n\t};\n};\n\n";
+	source << "static inline int cmp (const R &l, const R &r) {\n";
+	source << "\tint res = memcmp (l.s.c, r.s.c, l.s.n < r.s.n ? l.s.n : r.s.n);\n";
+	source << "\tif (res != 0)\n\t\treturn res;\n";
+	source << "\treturn (l.s.n < r.s.n) ? -1 : (l.s.n > r.s.n);\n}\n\n";
+	source << "extern \"C\" void mydb_run (R *r) {\n" << run.str () << "}\n\n";
+	source << "extern \"C\" void mydb_batch (void **c, int n) {\n" << columns.str ();
+
+	// the results that are worked out are written to their columns (any others, which
+	// are loads or constants, are there already)
+	ostringstream outputs;
+	for (size_t k = 0; k < results.size (); k++) {
+		int reg = results[k];
+		if (!computed[reg])
+			continue;
+		source << "\t" << columnType (reg) << " *out" << k << " = (" << columnType (reg) << " *) c[" << reg << "];\n";
+		outputs << "\t\tout" << k << "[i] = v" << reg << ";\n";
+	}
+	source << "\tfor (int i = 0; i < n; i++) {\n" << batch.str () << outputs.str () << "\t}\n}\n";
+	return source.str ();
+}
+
+#endif
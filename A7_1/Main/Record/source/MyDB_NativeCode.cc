@@ -0,0 +1,168 @@
+
+#ifndef NATIVE_CODE_C
+#define NATIVE_CODE_C
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include "MyDB_NativeCode.h"
+#include <stdio.h>
+#include <sstream>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+string MyDB_NativeCode :: cacheDir;
+
+bool MyDB_NativeCode :: enable (string cacheDirIn) {
+
+	// libraries are loaded from the directory, so it is only used if it is ours and no
+	// one else can put anything in it; it may already be there
+	cacheDir = "";
+	struct stat info;
+	mkdir (cacheDirIn.c_str (), 0700);
+	if (lstat (cacheDirIn.c_str (), &info) != 0 || !S_ISDIR (info.st_mode) ||
+			info.st_uid != geteuid () || (info.st_mode & 0777) != 0700)
+		return false;
+	cacheDir = cacheDirIn;
+	return true;
+}
+
+void MyDB_NativeCode :: disable () {
+	cacheDir = "";
+}
+
+bool MyDB_NativeCode :: isEnabled () {
+	return cacheDir != "";
+}
+
+// a 64-bit FNV-1a hash of the text; unlike hash <string>, this is the same for every
+// build, so a cache directory can be shared across them
+static unsigned long long fnv1a (const string &text) {
+	unsigned long long hashVal = 14695981039346656037ULL;
+	for (unsigned char c : text) {
+		hashVal ^= c;
+		hashVal *= 1099511628211ULL;
+	}
+	return hashVal;
+}
+
+// true if the file has exactly the given text
+static bool sameText (string path, const string &text) {
+	ifstream in (path, ios :: binary);
+	if (!in)
+		return false;
+	string contents ((istreambuf_iterator <char> (in)), istreambuf_iterator <char> ());
+	return contents == text;
+}
+
+// runs the command (no shell is involved, so the arguments are taken as they are), with
+// its output thrown away; true if it succeeded
+static bool run (vector <string> args) {
+
+	vector <char *> argv;
+	for (auto &arg : args)
+		argv.push_back (&arg[0]);
+	argv.push_back (nullptr);
+
+	pid_t child = fork ();
+	if (child == -1)
+		return false;
+	if (child == 0) {
+		int devNull = open ("/dev/null", O_WRONLY);
+		if (devNull != -1) {
+			dup2 (devNull, 1);
+			dup2 (devNull, 2);
+		}
+		execvp (argv[0], argv.data ());
+		_exit (127);
+	}
+
+	int status;
+	while (waitpid (child, &status, 0) == -1)
+		if (errno != EINTR)
+			return false;
+	return WIFEXITED (status) && WEXITSTATUS (status) == 0;
+}
+
+MyDB_NativeCodePtr MyDB_NativeCode :: load (string source) {
+
+	if (!isEnabled ())
+		return nullptr;
+
+	// what is compiled is the source, after a line saying how it is compiled, so that
+	// a library built by another compiler is not taken for this one
+	// ($CXX may have arguments of its own, split on spaces)
+	const char *compiler = getenv ("CXX");
+	vector <string> command;
+	istringstream words (compiler == nullptr ? "c++" : compiler);
+	for (string word; words >> word; )
+		command.push_back (word);
+	if (command.size () == 0)
+		command.push_back ("c++");
+	for (string flag : {"-std=c++11", "-O3", "-shared", "-fPIC"})
+		command.push_back (flag);
+	string text = "//";
+	for (auto &arg : command)
+		text += " " + arg;
+	text += "\n" + source;
+
+	// the library is named for a hash of that, and its source is kept next to it; if a
+	// library with that name was built from something else, the next name is tried
+	char name[32];
+	snprintf (name, 32, "%016llx", fnv1a (text));
+	string base, lib;
+	for (int i = 0; ; i++) {
+		base = cacheDir + "/expr_" + name + (i == 0 ? "" : "_" + to_string (i));
+		lib = base + ".so";
+		if (access (lib.c_str (), R_OK) != 0 || sameText (base + ".cc", text))
+			break;
+	}
+
+	// if it is not in the cache, compile it; it is built under a name of its own and
+	// then moved into place (its source first), so that another process never sees
+	// half of a library, or a library without its source
+	if (access (lib.c_str (), R_OK) != 0) {
+		string src = base + "." + to_string (getpid ()) + ".cc";
+		string temp = base + "." + to_string (getpid ()) + ".so";
+		{
+			ofstream out (src);
+			out << text;
+			if (!out)
+				return nullptr;
+		}
+		for (string arg : {string ("-o"), temp, src})
+			command.push_back (arg);
+		if (!run (command) || rename (src.c_str (), (base + ".cc").c_str ()) != 0 ||
+				rename (temp.c_str (), lib.c_str ()) != 0) {
+			unlink (src.c_str ());
+			unlink (temp.c_str ());
+			return nullptr;
+		}
+	}
+
+	void *handle = dlopen (lib.c_str (), RTLD_NOW | RTLD_LOCAL);
+	if (handle == nullptr)
+		return nullptr;
+	return MyDB_NativeCodePtr (new MyDB_NativeCode (handle));
+}
+
+void *MyDB_NativeCode :: getSymbol (string name) {
+	return dlsym (handle, name.c_str ());
+}
+
+MyDB_NativeCode :: MyDB_NativeCode (void *handleIn) {
+	handle = handleIn;
+}
+
+MyDB_NativeCode :: ~MyDB_NativeCode () {
+	dlclose (handle);
+}
+
+#endif
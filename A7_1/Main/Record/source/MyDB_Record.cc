@@ -2,10 +2,12 @@
 #ifndef RECORD_CC
 #define RECORD_CC
 
+#include <algorithm>
 #include "MyDB_Record.h"
 #include "MyDB_Schema.h"
 #include <iostream>
 #include <string.h>
+#include <utility>
 
 using namespace std;
 
@@ -16,12 +18,32 @@ char *MyDB_Record :: findsymbol (char val, char *input) {
 	return input + 1;
 }
 
+MyDB_ExprProgramPtr MyDB_Record :: compileProgram (string compileMe) {
+	return compileProgram (vector <string> {compileMe});
+}
+
+MyDB_ExprProgramPtr MyDB_Record :: compileProgram (vector <string> compileUs) {
+	MyDB_ExprProgramPtr prog = make_shared <MyDB_ExprProgram> ();
+	for (string &compileMe : compileUs) {
+		char *str = (char *) compileMe.c_str ();
+		prog->addResult (compileHelper (str, *prog));
+	}
+	return prog;
+}
+
 func MyDB_Record :: compileComputation (string compileMe) {
-	char *str = (char *) compileMe.c_str ();
-	return compileHelper (str).first;
+	MyDB_ExprProgramPtr prog = compileProgram (compileMe);
+
+	// just reading an attribute gives the handle to it, as it always has
+	MyDB_Record *source;
+	int sourceAtt;
+	if (prog->isJustLoad (source, sourceAtt)) {
+		return [source, sourceAtt] {source->loadAtt (sourceAtt); return source->values[sourceAtt];};
+	}
+	return [prog] {return prog->run ();};
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
+pair <int, MyDB_AttTypePtr> MyDB_Record :: compileHelper (char * &vals, MyDB_ExprProgram &prog) {
 	
 	// search for one of the infix symbols
 	while (true) {
@@ -38,19 +60,19 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return neq (lres, rres);
+			return prog.neq (lres, rres);
 
 		// not
 		} else if (vals[0] == '!') {
@@ -59,13 +81,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the result
-			auto res = compileHelper (vals);
+			auto res = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return nott (res);
+			return prog.nott (res);
 			
 		// or
 		} else if (vals[0] == '|' && vals[1] == '|') {
@@ -74,19 +96,20 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
-			// find the right result
-			auto rres = compileHelper (vals);
+			// find the right result, noting where its instructions start
+			size_t rhsStart = prog.size ();
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return orr (lres, rres);
+			return prog.orr (lres, rres, rhsStart);
 
 		// plus
 		} else if (vals[0] == '+') {
@@ -95,19 +118,19 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return plus (lres, rres);
+			return prog.plus (lres, rres);
 
 		// and
 		} else if (vals[0] == '&' && vals[1] == '&') {
@@ -116,19 +139,20 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
-			// find the right result
-			auto rres = compileHelper (vals);
+			// find the right result, noting where its instructions start
+			size_t rhsStart = prog.size ();
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return andd (lres, rres);
+			return prog.andd (lres, rres, rhsStart);
 
 		// equals
 		} else if (vals[0] == '=' && vals[1] == '=') {
@@ -137,19 +161,19 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return eq (lres, rres);
+			return prog.eq (lres, rres);
 
 		// greater than
 		} else if (vals[0] == '>') {
@@ -158,19 +182,19 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return gt (lres, rres);
+			return prog.gt (lres, rres);
 
 		// less than
 		} else if (vals[0] == '<') {
@@ -179,19 +203,19 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return lt (lres, rres);
+			return prog.lt (lres, rres);
 
 		// times
 		} else if (vals[0] == '*') {
@@ -200,19 +224,19 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return times (lres, rres);
+			return prog.times (lres, rres);
 
 		// divide
 		} else if (vals[0] == '/') {
@@ -221,19 +245,19 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return divide (lres, rres);
+			return prog.divide (lres, rres);
 
 		// minus
 		} else if (vals[0] == '-') {
@@ -242,19 +266,19 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return minus (lres, rres);
+			return prog.minus (lres, rres);
 
 		// unary minus
 		} else if (vals[0] == 'u' && vals[1] == 'm') {
@@ -263,13 +287,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the result
-			auto res = compileHelper (vals);
+			auto res = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return unaryMinus (res);
+			return prog.unaryMinus (res);
 
 		// not equal
 		} else if (vals[0] == '!' && vals[1] == '=') {
@@ -278,19 +302,19 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, prog);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, prog);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
 			
 			// outta here!
-			return neq (lres, rres);
+			return prog.neq (lres, rres);
 
 		} else if (vals[0] == '[') {
 
@@ -310,7 +334,7 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol (']', vals);
 	
 			// and get that attribute
-			return fromData (name);		
+			return fromData (name, prog);		
 
 		} else if (strncmp (vals, "int", 3) == 0) {
 
@@ -318,13 +342,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			int val = stoi (vals);
 			vals = findsymbol (']', vals);
 
-			// remember this value
-			MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-			scratch.push_back (temp);
-			temp->set (val);
-
-			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_IntAttType> ());
+			// it is just a register that is set up now
+			return prog.intConstant (val);
 
 		} else if (strncmp (vals, "double", 6) == 0) {
 
@@ -332,13 +351,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			double val = stod (vals);
 			vals = findsymbol (']', vals);
 
-			// remember this value
-			MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-			scratch.push_back (temp);
-			temp->set (val);
-
-			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_DoubleAttType> ());
+			// it is just a register that is set up now
+			return prog.doubleConstant (val);
 
 		} else if (strncmp (vals, "bool", 4) == 0) {
 
@@ -349,13 +363,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			}
 			vals = findsymbol (']', vals);
 
-			// remember this value
-			MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-			scratch.push_back (temp);
-			temp->set (val);
-
-			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_BoolAttType> ());
+			// it is just a register that is set up now
+			return prog.boolConstant (val);
 
 		} else if (strncmp (vals, "string", 6) == 0) {
 
@@ -366,7 +375,7 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			for (; vals[cnt] != ']'; cnt++);
 
 			// copy the string over
-			char name[cnt];
+			char name[cnt + 1];
 			for (cnt = 0; vals[cnt] != ']'; cnt++) {
 				name[cnt] = vals[cnt];
 			}	
@@ -375,13 +384,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			// find the ]
 			vals = findsymbol (']', vals);
 	
-			// remember this value
-			MyDB_StringAttValPtr temp = make_shared <MyDB_StringAttVal> ();
-			scratch.push_back (temp);
-			temp->set (name);
-
-			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_StringAttType> ());
+			// it is just a register that is set up now
+			return prog.stringConstant (name);
 			
 		} else {
 			vals++;
@@ -389,367 +393,11 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: fromData (string attName) {
+pair <int, MyDB_AttTypePtr> MyDB_Record :: fromData (string attName, MyDB_ExprProgram &prog) {
 
-	// just return a particular attribute
+	// read a particular attribute, from the record that it comes from
 	auto whichAtt = mySchema->getAttByName (attName);
-	return make_pair ([this, whichAtt] {return values[whichAtt.first];}, whichAtt.second);		
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: plus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () + rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_IntAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be doubles, then do so
-	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () + rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_DoubleAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be strings, then do so
-	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_StringAttValPtr temp = make_shared <MyDB_StringAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () + rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_StringAttType> ());
-
-	} else {
-		cout << "This is bad... cannot do anything with the plus.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: minus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () - rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_IntAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be doubles, then do so
-	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () - rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_DoubleAttType> ());
-	
-	} else {
-		cout << "This is bad... cannot do anything with the minus.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: unaryMinus (pair <func, MyDB_AttTypePtr> lhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs] {temp->set (-lhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_IntAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be doubles, then do so
-	} else if (lhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs] {temp->set (-lhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_DoubleAttType> ());
-	
-	} else {
-		cout << "This is bad... cannot do anything with the unary minus.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: times (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () * rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_IntAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be doubles, then do so
-	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () * rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_DoubleAttType> ());
-
-	} else {
-		cout << "This is bad... cannot do anything with the times.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: divide (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-//    cout << "left promotable to int" << lhs.second->promotableToInt() << "\n";
-//    cout << "right promotable to int" << rhs.second->promotableToInt() << "\n";
-//    cout << "left promotable to double" << lhs.second->promotableToDouble() << "\n";
-//    cout << "right promotable to double" << rhs.second->promotableToDouble() << "\n";
-//    cout << "left promotable to String" << lhs.second->promotableToString() << "\n";
-//    cout << "right promotable to String" << rhs.second->promotableToString() << "\n";
-//    cout << "left promotable to bool" << lhs.second->isBool() << "\n";
-//    cout << "right promotable to bool" << rhs.second->isBool() << "\n";
-//    cout << "left to string" << lhs.second->toString() << "\n";
-//    cout << "right to string" << rhs.second->toString() << "\n";
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () / rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_IntAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be doubles, then do so
-	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () / rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_DoubleAttType> ());
-
-	} else {
-		cout << "This is bad... cannot do anything with the divide.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () > rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be doubles, then do so
-	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () > rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be strings, then do so
-	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () > rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	} else {
-		cout << "This is bad... cannot do anything with the >.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () < rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be doubles, then do so
-	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () < rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be strings, then do so
-	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () < rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	} else {
-		cout << "This is bad... cannot do anything with the >.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: eq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () == rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be doubles, then do so
-	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () == rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	} else if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () == rhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be strings, then do so
-	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () == rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	} else {
-		cout << "This is bad... cannot do anything with the >.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: neq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () != rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	} else if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () != rhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be doubles, then do so
-	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () != rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	// otherwise, if both sides can be cast upwards to be strings, then do so
-	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () != rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	} else {
-		cout << "This is bad... cannot do anything with the >.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: orr (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () || rhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	} else {
-		cout << "This is bad... cannot do or on non booleans.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: andd (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () && rhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	} else {
-		cout << "This is bad... cannot do or on non booleans.\n";
-		exit (1);
-	}
-}
-
-pair <func, MyDB_AttTypePtr> MyDB_Record :: nott (pair <func, MyDB_AttTypePtr> lhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs] {temp->set (!lhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
-
-	} else {
-		cout << "This is bad... cannot do not on non boolean.\n";
-		exit (1);
-	}
+	return prog.load (sources[whichAtt.first].first, sources[whichAtt.first].second, whichAtt.second);
 }
 
 size_t MyDB_Record :: getBinarySize () {
@@ -765,20 +413,36 @@ void MyDB_Record :: recordContentHasChanged () {
 }
 
 void MyDB_Record :: writeAttsToBuffer () {
+	loadAllAtts ();
+	viewed = false;
 	recSize = sizeof (short);
-	for (MyDB_AttValPtr temp : values) {
-		temp->serialize (buffer, allocatedSize, recSize);
+	for (MyDB_Value *temp : atts) {
+		temp->serialize (spare, spareSize, recSize);
 	}		
-	*((short *) buffer) = (short) recSize;
+	*((short *) spare) = (short) recSize;
+
+	// the long strings that point into the old buffer now point at where they were written
+	size_t pos = sizeof (short);
+	for (MyDB_Value *temp : atts) {
+		if (temp->home == BorrowedChars && temp->str.ptr >= buffer && temp->str.ptr < buffer + allocatedSize)
+			temp->str.ptr = spare + pos + sizeof (short);
+		pos += temp->getBinarySize ();
+	}
+	swap (buffer, spare);
+	swap (allocatedSize, spareSize);
 	bufferOld = false;
 }
 
 void *MyDB_Record :: toBinary (void *toHere) {
 
-	// if we have not written ourselves to the buffer, do so
+	// if we have not written ourselves to the buffer, do so; a record that is just
+	// being looked at is copied from where it is
 	if (bufferOld) {
 		writeAttsToBuffer ();
-	} 
+	} else if (viewed) {
+		memcpy (toHere, view.getPointer (), recSize);
+		return ((char *) toHere) + recSize;
+	}
 	memcpy (toHere, buffer, recSize);
 	return ((char *) toHere) + recSize;
 }
@@ -800,17 +464,40 @@ void *MyDB_Record :: fromBinary (void *fromHere) {
 
 	// and set up the attributes
 	char *recLoc = buffer + sizeof (short);
-	for (MyDB_AttValPtr temp : values) {
+	for (MyDB_Value *temp : atts) {
 		recLoc = temp->fromBinary (recLoc);
 	}		
 
+	bufferOld = false;
+	viewed = false;
+
+	return ((char *) fromHere) + recSize;
+
+}
+
+void *MyDB_Record :: fromView (void *fromHere) {
+
+	view.setPointer (fromHere);
+	recSize = view.getSize ();
+	viewed = true;
 	bufferOld = false;
 
+	// a new generation means that none of the attributes have been read in
+	if (++generation == 0) {
+		fill (loadedAt.begin (), loadedAt.end (), 0);
+		generation = 1;
+	}
 	return ((char *) fromHere) + recSize;
+}
 
+void MyDB_Record :: loadAllAtts () {
+	for (auto &source : sources) {
+		source.first->loadAtt (source.second);
+	}
 }
 
 void MyDB_Record :: fromString (string res) {	
+	viewed = false;
 	int i = 0;
         for (int pos = 0; pos < (int) res.size (); pos = (int) res.find ("|", pos + 1) + 1) {
                 string temp = res.substr (pos, res.find ("|", pos + 1) - pos);
@@ -820,6 +507,7 @@ void MyDB_Record :: fromString (string res) {
 }
 
 std::ostream& operator<<(std::ostream& os, const MyDB_Record printMe) {
+	const_cast <MyDB_Record &> (printMe).loadAllAtts ();
 	for (MyDB_AttValPtr temp : printMe.values) {
 		os << temp->toString () << "|";
 	}
@@ -829,6 +517,7 @@ std::ostream& operator<<(std::ostream& os, const MyDB_Record printMe) {
 std::ostream& operator<<(std::ostream& os, const MyDB_RecordPtr printMe) {
 	if (printMe == nullptr)
 		return os;
+	printMe->loadAllAtts ();
 	for (MyDB_AttValPtr temp : printMe->values) {
 		os << temp->toString () << "|";
 	}
@@ -837,18 +526,17 @@ std::ostream& operator<<(std::ostream& os, const MyDB_RecordPtr printMe) {
 
 function <bool ()> buildRecordComparator (MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs, string computation) {
 
-	// compile a computation over the LHS and over the RHS
+	// compile a computation over the LHS and over the RHS, into one program
+	MyDB_ExprProgramPtr prog = make_shared <MyDB_ExprProgram> ();
 	char *str = (char *) computation.c_str ();
-	pair <func, MyDB_AttTypePtr> lhsFunc = lhs->compileHelper (str);
+	pair <int, MyDB_AttTypePtr> lhsReg = lhs->compileHelper (str, *prog);
 
 	str = (char *) computation.c_str ();
-	pair <func, MyDB_AttTypePtr> rhsFunc = rhs->compileHelper (str);
+	pair <int, MyDB_AttTypePtr> rhsReg = rhs->compileHelper (str, *prog);
 
 	// and then build a lambda that performs the computatation
-	auto res = lhs->lt (lhsFunc, rhsFunc);
-	func temp = res.first;
-	return [=] {return temp ()->toBool ();};
-	
+	prog->addResult (prog->lt (lhsReg, rhsReg));
+	return [prog] {return prog->runBool ();};
 }
 
 MyDB_Record :: MyDB_Record (MyDB_SchemaPtr mySchemaIn) {
@@ -856,26 +544,55 @@ MyDB_Record :: MyDB_Record (MyDB_SchemaPtr mySchemaIn) {
 
 	buffer = new char[256];
 	allocatedSize = 256;
+	spare = new char[256];
+	spareSize = 256;
 	recSize = 0;
 	bufferOld = true;
+	viewed = false;
+	generation = 0;
 
 	if (mySchemaIn == nullptr)
 		return;
 
+	// the values all go in the slots, which are never resized after this
+	slots.resize (mySchema->getAtts ().size ());
 	for (auto &val : mySchema->getAtts ()) {
 		values.push_back (val.second->createAtt ());	
+		values.back ()->bindTo (&slots[values.size () - 1]);
+	}
+	valuesChanged ();
+
+	// and set up the view, for fromView
+	vector <MyDB_ValueType> types;
+	for (auto &slot : slots) {
+		types.push_back (slot.type);
 	}
+	view = MyDB_RecordView (types);
 }
 
-MyDB_SchemaPtr &MyDB_Record :: getSchema () {
-	return mySchema;
+void MyDB_Record :: valuesChanged () {
+	atts.clear ();
+	for (auto &val : values) {
+		atts.push_back (&val->getValue ());
+	}
+	loadedAt.resize (values.size (), 0);
+
+	// unless the record was built from others, its values are its own
+	if (sources.size () != values.size ()) {
+		sources.clear ();
+		for (size_t i = 0; i < values.size (); i++) {
+			sources.push_back (make_pair (this, (int) i));
+		}
+	}
 }
 
-MyDB_AttValPtr &MyDB_Record :: getAtt (int whichAtt) {
-	return values[whichAtt];
+MyDB_SchemaPtr &MyDB_Record :: getSchema () {
+	return mySchema;
 }
 
 void MyDB_Record :: buildFrom (MyDB_RecordPtr left, MyDB_RecordPtr right) {
+	sources = left->sources;
+	sources.insert (sources.end (), right->sources.begin (), right->sources.end ());
         vector <MyDB_AttValPtr> newValues;
         for (auto &v : left->values) {
                 newValues.push_back (v);
@@ -884,10 +601,12 @@ void MyDB_Record :: buildFrom (MyDB_RecordPtr left, MyDB_RecordPtr right) {
                 newValues.push_back (v);
         }
         values = newValues;
+	valuesChanged ();
 }
 
 MyDB_Record :: ~MyDB_Record () {
 	delete [] buffer;
+	delete [] spare;
 }
 
 #endif
@@ -0,0 +1,130 @@
+
+#ifndef VALUE_C
+#define VALUE_C
+
+#include <functional>
+#include <iostream>
+#include "MyDB_Value.h"
+#include <stdlib.h>
+
+using namespace std;
+
+static const char *typeName (MyDB_ValueType type) {
+	if (type == IntValue)
+		return "int";
+	if (type == LongValue)
+		return "long";
+	if (type == DoubleValue)
+		return "double";
+	if (type == StringValue)
+		return "string";
+	return "bool";
+}
+
+void MyDB_Value :: cantConvert (const char *toType) const {
+	cout << "Oops!  Can't convert " << typeName (type) << " to " << toType;
+	exit (1);
+}
+
+string MyDB_Value :: toString () const {
+	if (type == StringValue)
+		return string (getChars (), len);
+	if (type == IntValue)
+		return to_string (intVal);
+	if (type == DoubleValue)
+		return to_string (doubleVal);
+	if (type == LongValue)
+		return to_string (longVal);
+	return boolVal ? "true" : "false";
+}
+
+void MyDB_Value :: fromString (const string &fromMe) {
+	if (type == StringValue)
+		setChars (fromMe.c_str (), fromMe.size ());
+	else if (type == IntValue)
+		intVal = stoi (fromMe);
+	else if (type == DoubleValue)
+		doubleVal = stod (fromMe);
+	else if (type == LongValue)
+		longVal = stol (fromMe);
+	else if (fromMe == "false")
+		boolVal = false;
+	else if (fromMe == "true")
+		boolVal = true;
+	else {
+		cout << "Oops!  Bad string for boolean\n";
+		exit (1);
+	}
+}
+
+void MyDB_Value :: fromInt (int fromMe) {
+	if (type == StringValue) {
+		string asString = to_string (fromMe);
+		setChars (asString.c_str (), asString.size ());
+	} else if (type == IntValue)
+		intVal = fromMe;
+	else if (type == DoubleValue)
+		doubleVal = fromMe;
+	else if (type == LongValue)
+		longVal = fromMe;
+	else
+		boolVal = (fromMe == 1);
+}
+
+void MyDB_Value :: set (const MyDB_Value &fromMe) {
+	if (type == IntValue)
+		intVal = fromMe.toInt ();
+	else if (type == DoubleValue)
+		doubleVal = fromMe.toDouble ();
+	else if (type == LongValue)
+		longVal = fromMe.toLong ();
+	else if (type == BoolValue)
+		boolVal = fromMe.toBool ();
+	else if (fromMe.type == StringValue)
+		setChars (fromMe.getChars (), fromMe.len);
+	else {
+		string asString = fromMe.toString ();
+		setChars (asString.c_str (), asString.size ());
+	}
+}
+
+size_t MyDB_Value :: hash () const {
+	if (type == IntValue)
+		return std :: hash <int> () (intVal);
+	if (type == DoubleValue)
+		return std :: hash <int> () (doubleVal);
+	if (type == StringValue)
+		return std :: hash <string> () (toString ());
+	if (type == LongValue)
+		return std :: hash <long> () (longVal);
+	return std :: hash <int> () (boolVal);
+}
+
+void MyDB_Value :: serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) const {
+
+	size_t mySize = getBinarySize ();
+	if (totSize + mySize > allocatedSize) {
+		size_t newSize = (totSize + mySize) * 2;
+		char *newBuff = new char[newSize];
+		memcpy (newBuff, buffer, totSize);
+		delete [] buffer;
+		buffer = newBuff;
+		allocatedSize = newSize;
+	}
+
+	char *data = buffer + totSize + sizeof (short);
+	*((short *) (buffer + totSize)) = (short) mySize;
+	if (type == IntValue)
+		*((int *) data) = intVal;
+	else if (type == DoubleValue)
+		*((double *) data) = doubleVal;
+	else if (type == StringValue)
+		memcpy (data, getChars (), len + 1);
+	else if (type == LongValue)
+		*((long *) data) = longVal;
+	else
+		*data = boolVal ? 1 : 0;
+	totSize += mySize;
+}
+
+#endif
@@ -5,7 +5,10 @@
 #include "MyDB_AttType.h"  
 #include "MyDB_BufferManager.h"
 #include "MyDB_Catalog.h"  
+#include "MyDB_Conjunction.h"
+#include "MyDB_INRecord.h"
 #include "MyDB_Page.h"
+#include "MyDB_PageCursor.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_Record.h"
 #include "MyDB_Table.h"
@@ -13,7 +16,9 @@
 #include "MyDB_Schema.h"
 #include "QUnit.h"
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
@@ -50,6 +55,47 @@ void initialize() {
 	cout << "finish initialization..." << flush;
 }
 
+// what the tests of records and computations run on: a record whose schema is made
+// from the names of its attributes (a name has the same type in every test), and the
+// rows that are given, written one after another the way they would be on a page
+struct TestRecords {
+
+	MyDB_SchemaPtr schema;
+	MyDB_RecordPtr rec;
+	char bytes[16384];
+	void *recs[200];
+	char *end;
+
+	TestRecords(vector <string> atts, int numRecs = 0, function <string (int)> row = nullptr) {
+		map <string, MyDB_AttTypePtr> types {
+			{"id", make_shared <MyDB_IntAttType>()},
+			{"name", make_shared <MyDB_StringAttType>()},
+			{"shortName", make_shared <MyDB_StringAttType>()},
+			{"longName", make_shared <MyDB_StringAttType>()},
+			{"comment", make_shared <MyDB_StringAttType>()},
+			{"balance", make_shared <MyDB_DoubleAttType>()},
+			{"limit", make_shared <MyDB_DoubleAttType>()},
+			{"active", make_shared <MyDB_BoolAttType>()}};
+		schema = make_shared <MyDB_Schema>();
+		for (auto &att : atts)
+			schema->appendAtt(make_pair(att, types[att]));
+		rec = make_shared <MyDB_Record>(schema);
+		end = bytes;
+		for (int i = 0; i < numRecs; i++) {
+			rec->fromString(row(i));
+			recs[i] = end;
+			end = (char *) rec->toBinary(end);
+		}
+	}
+};
+
+// prints how a test came out, and hands the answer on to be checked
+bool report(bool ok) {
+	if (ok) cout << "CORRECT" << endl << flush;
+	else cout << "***FAIL***" << endl << flush;
+	return ok;
+}
+
 int main(int argc, char *argv[]) {
 	int start = 1;
 	if (argc > 1 && argv[1][0] >= '0' && argv[1][0] <= '9') {
@@ -417,6 +463,510 @@ int main(int argc, char *argv[]) {
 		QUNIT_IS_EQUAL(counter, 10000);
 	}
 	FALLTHROUGH_INTENDED;
+	case 10:
+	{
+		// page cursors: a cursor walks the table, and pins and unpins the page it is on
+		cout << "TEST 10..." << flush;
+		initialize();
+		int counter = 0;
+		bool pinsOK = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+
+			cout << "create TableReaderWriter..." << flush;
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+
+			cout << "walk the pages..." << flush;
+			MyDB_PageCursor cursor(supplierTable);
+			if (cursor.getPageNum() != -1 || cursor.pin()) pinsOK = false;
+			for (int i = 0; i < supplierTable.getNumPages(); i++) {
+				if (cursor.moveTo(i).getType() != MyDB_PageType::RegularPage) continue;
+				MyDB_RecordIteratorPtr myIter = cursor->getIterator(temp);
+				while (myIter->hasNext()) {
+					myIter->getNext();
+					counter++;
+				}
+			}
+			if (cursor.getPageNum() != supplierTable.getNumPages() - 1) pinsOK = false;
+
+			cout << "pin..." << flush;
+			vector <MyDB_PageCursor> pinned;
+			for (int i = 0; i < 16; i++) {
+				pinned.push_back(MyDB_PageCursor(supplierTable));
+				pinned.back().moveTo(i);
+				if (!pinned.back().pin() || !pinned.back().isPinned()) pinsOK = false;
+			}
+			MyDB_PageCursor extra(supplierTable);
+			extra.moveTo(20);
+			if (extra.pin()) pinsOK = false;
+
+			// unpinning a page, or moving off of it, makes room
+			pinned[0].unpin();
+			if (pinned[0].isPinned() || !extra.pin()) pinsOK = false;
+			extra.unpin();
+			pinned[1].moveTo(21);
+			if (pinned[1].isPinned() || !extra.pin()) pinsOK = false;
+
+			cout << "shutdown manager..." << flush;
+		}
+		if (counter == 10000 && pinsOK) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_EQUAL(counter, 10000);
+		QUNIT_IS_TRUE(pinsOK);
+	}
+	FALLTHROUGH_INTENDED;
+	case 11:
+	{
+		// 64-bit page numbers: a table whose pages go past 2^31 (a sparse file, so only
+		// the pages that are written take up space) is written and read back, and the
+		// pointers in B+-Tree internal records can point past 2^31 as well
+		cout << "TEST 11..." << flush;
+		initialize();
+		int counter = 0;
+		bool bigOK = true;
+		long big = (1L << 31);
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+
+			cout << "write past 2^31 pages..." << flush;
+			unlink("bigTable.bin");
+			MyDB_TablePtr bigTable = make_shared <MyDB_Table>("bigTable", "bigTable.bin", allTables["supplier"]->getSchema());
+			bigTable->setLastPage(big + 1);
+			bigTable->putInCatalog(myCatalog);
+			MyDB_TableReaderWriter bigTableRW(bigTable, myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordIteratorPtr myIter = supplierTable.getIterator(temp);
+			for (long page = big - 2; page <= big + 1; page++) {
+				bigTableRW[page].clear();
+				for (int i = 0; i < 4 && myIter->hasNext(); i++) {
+					myIter->getNext();
+					bigTableRW[page].append(temp);
+				}
+			}
+			if (bigTableRW.getNumPages() != big + 2) bigOK = false;
+
+			// an internal record round-trips a pointer that does not fit in an int
+			MyDB_INRecord inRec(make_shared <MyDB_IntAttVal>());
+			inRec.setPtr((1L << 32) + 7);
+			char bytes[64];
+			inRec.toBinary(bytes);
+			MyDB_INRecord readBack(make_shared <MyDB_IntAttVal>());
+			readBack.fromBinary(bytes);
+			if (readBack.getPtr() != (1L << 32) + 7) bigOK = false;
+			cout << "shutdown manager..." << flush;
+		}
+		{
+			cout << "read back..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			if (allTables["bigTable"]->lastPage() != big + 1) bigOK = false;
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter bigTableRW(allTables["bigTable"], myMgr);
+			MyDB_RecordPtr temp = bigTableRW.getEmptyRecord();
+			MyDB_RecordIteratorAltPtr myIter = bigTableRW.getIteratorAlt(big - 2, big + 1);
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+				if (temp->getAtt(0)->toInt() != counter + 1) bigOK = false;
+				counter++;
+			}
+			cout << "shutdown manager..." << flush;
+		}
+		unlink("bigTable.bin");
+		if (counter == 16 && bigOK) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_EQUAL(counter, 16);
+		QUNIT_IS_TRUE(bigOK);
+	}
+	FALLTHROUGH_INTENDED;
+	case 12:
+	{
+		// the values of a record: short strings are kept in the values themselves and
+		// long ones point into the record's buffer, and both survive the record being
+		// changed and written out again, and being read back in
+		cout << "TEST 12..." << flush;
+		bool valuesOK = true;
+		TestRecords t({"id", "shortName", "longName", "balance", "active"});
+		MyDB_RecordPtr rec = t.rec;
+		MyDB_RecordPtr readBack = make_shared <MyDB_Record>(t.schema);
+		rec->fromString("17|short|a string that is too long to fit in a value|12.5|true|");
+		char bytes[256];
+		rec->toBinary(bytes);
+		readBack->fromBinary(bytes);
+		if (readBack->getValue(1).home != InlineChars || readBack->getValue(2).home != BorrowedChars) valuesOK = false;
+		if (readBack->getAtt(0)->toInt() != 17 || readBack->getAtt(1)->toString() != "short") valuesOK = false;
+		if (readBack->getAtt(2)->toString() != "a string that is too long to fit in a value") valuesOK = false;
+		if (readBack->getAtt(3)->toDouble() != 12.5 || !readBack->getAtt(4)->toBool()) valuesOK = false;
+
+		// growing the short string moves the long one when the record is written again
+		readBack->getAtt(1)->set(readBack->getAtt(2));
+		readBack->recordContentHasChanged();
+		char moreBytes[256];
+		readBack->toBinary(moreBytes);
+		if (readBack->getAtt(2)->toString() != "a string that is too long to fit in a value") valuesOK = false;
+		rec->fromBinary(moreBytes);
+		if (rec->getAtt(1)->toString() != rec->getAtt(2)->toString() || rec->getAtt(0)->toInt() != 17) valuesOK = false;
+
+		// a copy has its own characters, and computations see the current values
+		MyDB_AttValPtr copy = rec->getAtt(2)->getCopy();
+		func sameNames = rec->compileComputation("== ([shortName], [longName])");
+		func bigger = rec->compileComputation("> ([id], int[16])");
+		if (!sameNames()->toBool() || !bigger()->toBool()) valuesOK = false;
+		rec->fromBinary(bytes);
+		if (sameNames()->toBool() || copy->toString() != "a string that is too long to fit in a value") valuesOK = false;
+		QUNIT_IS_TRUE(report(valuesOK));
+	}
+	FALLTHROUGH_INTENDED;
+	case 13:
+	{
+		// a record that is only looked at with fromView reads its attributes from the
+		// bytes when they are used, sees the next record's bytes once it is moved on,
+		// and can be combined with another one, changed, and written out like any other
+		cout << "TEST 13..." << flush;
+		bool viewOK = true;
+		TestRecords t({"id", "name", "balance", "comment"}, 2, [](int i) {
+			return i == 0 ? "1|first|10.5|a comment that is too long to fit in a value|" : "2|second|20.5|short|";
+		});
+		MyDB_RecordPtr rec = t.rec;
+		char *first = (char *) t.recs[0], *next = (char *) t.recs[1];
+
+		MyDB_RecordPtr viewed = make_shared <MyDB_Record>(t.schema);
+		func rich = viewed->compileComputation("> ([balance], double[15.0])");
+		func named = viewed->compileComputation("== ([comment], string[short])");
+		if (viewed->fromView(first) != next) viewOK = false;
+		if (rich()->toBool() || named()->toBool() || viewed->getAtt(0)->toInt() != 1) viewOK = false;
+		if (viewed->getValue(3).home != BorrowedChars) viewOK = false;
+		if (viewed->fromView(next) != t.end) viewOK = false;
+		if (!named()->toBool() || viewed->getAtt(1)->toString() != "second" || !rich()->toBool()) viewOK = false;
+
+		// the bytes are copied as they are, and a change is written out
+		char copied[512];
+		viewed->toBinary(copied);
+		if (memcmp(copied, next, t.end - next) != 0) viewOK = false;
+		string changed = "changed";
+		viewed->getAtt(1)->fromString(changed);
+		viewed->recordContentHasChanged();
+		viewed->toBinary(copied);
+		rec->fromBinary(copied);
+		if (rec->getAtt(1)->toString() != "changed" || rec->getAtt(3)->toString() != "short") viewOK = false;
+
+		// a combined record reads through to the viewed ones
+		MyDB_RecordPtr other = make_shared <MyDB_Record>(t.schema);
+		MyDB_SchemaPtr bothSchema = make_shared <MyDB_Schema>();
+		for (auto &a : t.schema->getAtts()) bothSchema->appendAtt(a);
+		for (auto &a : t.schema->getAtts()) bothSchema->appendAtt(make_pair("o_" + a.first, a.second));
+		MyDB_RecordPtr both = make_shared <MyDB_Record>(bothSchema);
+		both->buildFrom(viewed, other);
+		func same = both->compileComputation("== ([id], [o_id])");
+		viewed->fromView(first);
+		other->fromView(next);
+		if (same()->toBool() || both->getAtt(7)->toString() != "short" || both->getAtt(3)->toString() != "a comment that is too long to fit in a value") viewOK = false;
+		other->fromView(first);
+		if (!same()->toBool()) viewOK = false;
+		QUNIT_IS_TRUE(report(viewOK));
+	}
+	FALLTHROUGH_INTENDED;
+	case 14:
+	{
+		// compiled computations: the types are promoted the same way as always, and
+		// the program sees whatever is in the record when it is run
+		cout << "TEST 14..." << flush;
+		bool computeOK = true;
+		MyDB_RecordPtr rec = TestRecords({"id", "name", "balance", "active"}).rec;
+		func sum = rec->compileComputation("+ ([id], [balance])");
+		func joined = rec->compileComputation("+ ([name], [id])");
+		func half = rec->compileComputation("/ ([id], int[2])");
+		func negated = rec->compileComputation("um ([balance])");
+		func both = rec->compileComputation("&& (> ([balance], int[10]), ! (== ([name], string[long])))");
+		func either = rec->compileComputation("|| (< ([name], string[a]), != ([active], bool[true]))");
+		func mixed = rec->compileComputation("== ([id], double[17.0])");
+		func asStrings = rec->compileComputation("> ([name], [id])");
+		rec->fromString("17|short|12.5|true|");
+		if (sum()->toDouble() != 29.5 || joined()->toString() != "short17" || half()->toInt() != 8) computeOK = false;
+		if (negated()->toDouble() != -12.5 || !both()->toBool() || either()->toBool()) computeOK = false;
+		if (!mixed()->toBool() || !asStrings()->toBool()) computeOK = false;
+		rec->fromString("4|long|2.0|false|");
+		if (sum()->toDouble() != 6.0 || joined()->toString() != "long4" || half()->toInt() != 2) computeOK = false;
+		if (both()->toBool() || !either()->toBool() || mixed()->toBool()) computeOK = false;
+		QUNIT_IS_TRUE(report(computeOK));
+	}
+	FALLTHROUGH_INTENDED;
+	case 15:
+	{
+		// a program run over a batch of serialized records gives the same answers as
+		// one record at a time, and reads any other record as it is
+		cout << "TEST 15..." << flush;
+		bool batchOK = true;
+		TestRecords t({"id", "name", "balance"}, 20, [](int i) {
+			return to_string(i) + "|name number " + to_string(i) + "|" + to_string(i * 0.5) + "|";
+		});
+		MyDB_RecordPtr rec = t.rec;
+		TestRecords limits({"limit"});
+		MyDB_RecordPtr other = limits.rec;
+		MyDB_SchemaPtr bothSchema = make_shared <MyDB_Schema>();
+		for (auto &a : t.schema->getAtts()) bothSchema->appendAtt(a);
+		bothSchema->appendAtt(limits.schema->getAtts()[0]);
+		MyDB_RecordPtr both = make_shared <MyDB_Record>(bothSchema);
+		both->buildFrom(rec, other);
+		other->fromString("5.0|");
+
+		MyDB_ExprProgramPtr pred = both->compileProgram("&& (> ([balance], [limit]), ! (== ([id], int[13])))");
+		MyDB_ExprProgramPtr label = both->compileProgram("+ ([name], + (string[:], [id]))");
+		int selected[20];
+		int numSelected = pred->select(rec.get(), t.recs, 20, selected);
+		if (numSelected != 8 || selected[0] != 11 || selected[2] != 14) batchOK = false;
+		label->runBatch(rec.get(), t.recs, selected, numSelected);
+		if (label->getBatchResult(0)->toString() != "name number 11:11") batchOK = false;
+		if (label->getBatchResult(7)->toString() != "name number 19:19") batchOK = false;
+		for (int i = 0; i < numSelected; i++) {
+			string fromBatch = label->getBatchResult(i)->toString();
+			rec->fromView(t.recs[selected[i]]);
+			if (!pred->runBool() || label->run()->toString() != fromBatch) batchOK = false;
+		}
+		QUNIT_IS_TRUE(report(batchOK));
+	}
+	FALLTHROUGH_INTENDED;
+	case 16:
+	{
+		// a program compiled to machine code gives the same answers as the interpreter
+		// (if there is no compiler, it just stays interpreted); one that builds strings
+		// is never compiled
+		cout << "TEST 16..." << flush;
+		bool nativeOK = true;
+		TestRecords t({"id", "name", "balance"}, 20, [](int i) {
+			return to_string(i) + "|name " + to_string(i % 4) + "|" + to_string(i * 0.5) + "|";
+		});
+		MyDB_RecordPtr rec = t.rec;
+
+		string predText = "|| (&& (> (* ([balance], double[2.0]), - ([id], int[4])), ! (== ([name], string[name 1]))), < ([id], int[2]))";
+		string sumText = "+ (/ ([id], int[3]), * ([balance], - (int[0], [id])))";
+		MyDB_ExprProgramPtr pred = rec->compileProgram(predText);
+		MyDB_ExprProgramPtr sum = rec->compileProgram(sumText);
+		MyDB_ExprProgramPtr nativePred = rec->compileProgram(predText);
+		MyDB_ExprProgramPtr nativeSum = rec->compileProgram(sumText);
+		MyDB_ExprProgramPtr label = rec->compileProgram("+ ([name], [id])");
+
+		MyDB_NativeCode :: enable("nativeCodeCache");
+		bool compiled = nativePred->compileNative();
+		if (nativeSum->compileNative() != compiled || nativePred->isNative() != compiled) nativeOK = false;
+		if (label->compileNative() || label->isNative()) nativeOK = false;
+		MyDB_NativeCode :: disable();
+
+		int selected[20], nativeSelected[20];
+		int numSelected = pred->select(rec.get(), t.recs, 20, selected);
+		if (nativePred->select(rec.get(), t.recs, 20, nativeSelected) != numSelected) nativeOK = false;
+		for (int i = 0; i < numSelected && nativeOK; i++)
+			if (selected[i] != nativeSelected[i]) nativeOK = false;
+		sum->runBatch(rec.get(), t.recs, nullptr, 20);
+		nativeSum->runBatch(rec.get(), t.recs, nullptr, 20);
+		for (int i = 0; i < 20; i++) {
+			if (sum->getBatchResult(i)->toDouble() != nativeSum->getBatchResult(i)->toDouble()) nativeOK = false;
+			rec->fromView(t.recs[i]);
+			if (pred->runBool() != nativePred->runBool()) nativeOK = false;
+			if (sum->run()->toDouble() != nativeSum->run()->toDouble()) nativeOK = false;
+		}
+		QUNIT_IS_TRUE(report(nativeOK));
+	}
+	FALLTHROUGH_INTENDED;
+	case 17:
+	{
+		// constants are worked out when a program is compiled, what is already there is
+		// not added again (also across the results of a group), and the right side of
+		// && or || is not run when the left side decides the answer
+		cout << "TEST 17..." << flush;
+		bool optimizeOK = true;
+		TestRecords t({"id", "name", "balance"}, 4, [](int i) {
+			return to_string(i) + "|name " + to_string(i) + "|" + to_string(i * 2.0) + "|";
+		});
+		MyDB_RecordPtr rec = t.rec;
+
+		MyDB_ExprProgramPtr folded = rec->compileProgram("> (+ (int[1], * (int[2], double[3.5])), + (string[ab], int[7]))");
+		MyDB_ExprProgramPtr shared = rec->compileProgram("&& (== ([id], int[5]), == (int[5], [id]))");
+		MyDB_ExprProgramPtr decided = rec->compileProgram("|| (bool[true], > ([id], int[3]))");
+		MyDB_ExprProgramPtr guarded = rec->compileProgram("&& (!= ([id], int[0]), > (/ (int[10], [id]), int[1]))");
+		MyDB_ExprProgramPtr either = rec->compileProgram("|| (== ([id], int[0]), < (/ (int[10], [id]), int[1]))");
+		if (folded->size() != 0 || shared->size() != 2 || decided->size() != 0) optimizeOK = false;
+
+		vector <string> group {"* ([balance], - (int[1], [id]))", "+ (* ([balance], - (int[1], [id])), [balance])", "[name]"};
+		MyDB_ExprProgramPtr both = rec->compileProgram(group);
+		if (both->size() != 7) optimizeOK = false;
+
+		rec->fromString("0|zero|2.5|");
+		if (folded->run()->toString() != "false" || shared->runBool() || !decided->runBool()) optimizeOK = false;
+		if (guarded->runBool() || !either->runBool()) optimizeOK = false;
+		if (both->run()->toDouble() != 2.5 || both->getResult(1)->toDouble() != 5.0) optimizeOK = false;
+		if (both->getResult(2)->toString() != "zero") optimizeOK = false;
+		rec->fromString("4|four|1.5|");
+		if (!guarded->runBool() || either->runBool()) optimizeOK = false;
+		if (both->run()->toDouble() != -4.5 || both->getResult(1)->toDouble() != -3.0) optimizeOK = false;
+
+		both->runBatch(rec.get(), t.recs, nullptr, 4);
+		if (both->getBatchResult(3, 0)->toDouble() != -12.0 || both->getBatchResult(3, 1)->toDouble() != -6.0) optimizeOK = false;
+		if (both->getBatchResult(2, 2)->toString() != "name 2") optimizeOK = false;
+		QUNIT_IS_TRUE(report(optimizeOK));
+	}
+	FALLTHROUGH_INTENDED;
+	case 18:
+	{
+		// a conjunction gives the same answers as the predicate compiled as a whole, and
+		// learns to put the conjunct that throws out the most records first
+		cout << "TEST 18..." << flush;
+		bool conjunctionOK = true;
+		TestRecords t({"id", "name"}, 200, [](int i) {
+			return to_string(i) + "|name, (number) " + to_string(i % 7) + "|";
+		});
+		MyDB_RecordPtr rec = t.rec;
+
+		string predicate = "&& ( != ([name], string[name, (number) 9]),&& ( < ([id], int[150]), < ([id], int[5])))";
+		MyDB_ExprProgramPtr whole = rec->compileProgram(predicate);
+		MyDB_Conjunction pred (rec, predicate);
+		if (pred.getOrder().size() != 3 || pred.getOrder()[2] != " < ([id], int[5])") conjunctionOK = false;
+
+		for (int i = 0; i < 1000; i++) {
+			rec->fromView(t.recs[i % 200]);
+			if (pred.run() != whole->runBool()) conjunctionOK = false;
+		}
+		int selected[200], wholeSelected[200];
+		for (int i = 0; i < 200; i++) {
+			int numSelected = pred.select(rec.get(), t.recs, 200, selected);
+			if (numSelected != 5 || whole->select(rec.get(), t.recs, 200, wholeSelected) != 5) conjunctionOK = false;
+			for (int j = 0; j < 5 && conjunctionOK; j++)
+				if (selected[j] != wholeSelected[j]) conjunctionOK = false;
+		}
+		if (pred.getOrder()[0] != " < ([id], int[5])") conjunctionOK = false;
+		QUNIT_IS_TRUE(report(conjunctionOK));
+	}
+	FALLTHROUGH_INTENDED;
+	case 19:
+	{
+		// over a batch, an integer divide on the right side of && or || is only done
+		// for the records where the left side does not decide the answer, so one that
+		// is guarded against dividing by zero does not trap (interpreted or not)
+		cout << "TEST 19..." << flush;
+		bool guardOK = true;
+		TestRecords t({"id"}, 40, [](int i) {
+			return to_string(i % 5) + "|";
+		});
+		MyDB_RecordPtr rec = t.rec;
+
+		vector <string> texts {"&& (!= ([id], int[0]), > (/ (int[10], [id]), int[1]))",
+			"|| (== ([id], int[0]), < (/ (int[10], [id]), int[3]))",
+			"&& (< ([id], int[100]), && (!= ([id], int[0]), == (/ (int[4], [id]), int[2])))"};
+		int answers[] = {32, 16, 8};
+		for (int native = 0; native < 2; native++) {
+			for (size_t i = 0; i < texts.size(); i++) {
+				MyDB_ExprProgramPtr prog = rec->compileProgram(texts[i]);
+				if (native) {
+					MyDB_NativeCode :: enable("nativeCodeCache");
+					prog->compileNative();
+					MyDB_NativeCode :: disable();
+				}
+				int selected[40];
+				int numSelected = prog->select(rec.get(), t.recs, 40, selected);
+				if (numSelected != answers[i]) guardOK = false;
+				for (int j = 0, k = 0; j < 40; j++) {
+					rec->fromView(t.recs[j]);
+					bool passed = prog->runBool();
+					if (passed != (k < numSelected && selected[k] == j)) guardOK = false;
+					k += passed;
+				}
+				for (int j = 0; j < 40; j++) selected[j] = j;
+				if (prog->refine(rec.get(), t.recs, selected, 40) != answers[i]) guardOK = false;
+			}
+		}
+		QUNIT_IS_TRUE(report(guardOK));
+	}
+	FALLTHROUGH_INTENDED;
+	case 20:
+	{
+		// a conjunct with a divide stays behind the ones that guard it, even if it has
+		// fewer instructions or throws out more records, and samples do not run it on
+		// the records that those throw out
+		cout << "TEST 20..." << flush;
+		bool trapOK = true;
+		TestRecords t({"id"}, 200, [](int i) {
+			return to_string(i % 5) + "|";
+		});
+		MyDB_RecordPtr rec = t.rec;
+
+		string predicate = "&& (!= (* ([id], + ([id], int[1])), int[0]), > (/ (int[10], [id]), int[4]))";
+		MyDB_ExprProgramPtr whole = rec->compileProgram(predicate);
+		MyDB_Conjunction pred (rec, predicate);
+		if (pred.getOrder().size() != 2 || pred.getOrder()[1] != " > (/ (int[10], [id]), int[4])") trapOK = false;
+
+		for (int i = 0; i < 1000; i++) {
+			rec->fromView(t.recs[i % 200]);
+			if (pred.run() != whole->runBool()) trapOK = false;
+		}
+		int selected[200];
+		for (int i = 0; i < 200; i++)
+			if (pred.select(rec.get(), t.recs, 200, selected) != 80) trapOK = false;
+		if (pred.getOrder()[1] != " > (/ (int[10], [id]), int[4])") trapOK = false;
+		QUNIT_IS_TRUE(report(trapOK));
+	}
+	FALLTHROUGH_INTENDED;
+	case 21:
+	{
+		// a batch from a table iterator stays put while the records in it are written to
+		// another table (four times each, so the writing goes through pages faster than
+		// the reading does), even with a buffer so small that the writing has to kick
+		// pages out
+		cout << "TEST 21..." << flush;
+		initialize();
+		bool batchPinOK = true;
+		int counter = 0;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 2, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			unlink("supplierCopy.bin");
+			MyDB_TablePtr copyTable = make_shared <MyDB_Table>("supplierCopy", "supplierCopy.bin", allTables["supplier"]->getSchema());
+			MyDB_TableReaderWriter copyTableRW(copyTable, myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+
+			cout << "copy a batch at a time..." << flush;
+			vector <string> expected;
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt(supplierTable.getBulkReadStrategy());
+			void *recs[64];
+			int numRecs;
+			while ((numRecs = myIter->getBatch(recs, 64)) > 0) {
+				for (int j = 0; j < numRecs; j++) {
+					temp->fromBinary(recs[j]);
+					expected.push_back(temp->getAtt(6)->toString());
+				}
+				for (int j = 0; j < numRecs; j++) {
+					for (int k = 0; k < 4; k++) {
+						temp->fromBinary(recs[j]);
+						copyTableRW.append(temp);
+					}
+				}
+			}
+
+			cout << "read back..." << flush;
+			MyDB_RecordIteratorAltPtr copyIter = copyTableRW.getIteratorAlt();
+			while (copyIter->advance()) {
+				copyIter->getCurrent(temp);
+				if (counter / 4 >= (int) expected.size() || temp->getAtt(6)->toString() != expected[counter / 4]) batchPinOK = false;
+				if (temp->getAtt(0)->toInt() != counter / 4 + 1) batchPinOK = false;
+				counter++;
+			}
+			cout << "shutdown manager..." << flush;
+		}
+		unlink("supplierCopy.bin");
+		report(counter == 40000 && batchPinOK);
+		QUNIT_IS_EQUAL(counter, 40000);
+		QUNIT_IS_TRUE(batchPinOK);
+	}
+	FALLTHROUGH_INTENDED;
 	case 0:
 	{
 		// table hasNext with all pages cleared
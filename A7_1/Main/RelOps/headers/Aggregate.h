@@ -7,9 +7,10 @@
 #include <utility>
 #include <vector>
 
-// This class encapulates a simple, hash-based aggregation + group by.  It does not
-// need to work when there is not enough space in the buffer manager to store all of
-// the groups.
+// This class encapulates a simple, hash-based aggregation + group by.  The pages
+// that store the groups are pinned against a reservation; it does not work when
+// there is not enough space in the buffer manager to store all of the groups, but
+// it says so (and stops), rather than running the buffer out of frames.
 
 enum MyDB_AggType {sums, avgs, cnts};
 
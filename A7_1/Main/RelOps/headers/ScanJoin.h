@@ -8,9 +8,10 @@
 #include <vector>
 
 // This class encapulates a scan join, where one table is hashed, and then the 
-// other is scanned and joined with the hashed table.  If the smaller table is
-// too large to be stored in the buffer manager in its entirity, then the join
-// will fail.
+// other is scanned and joined with the hashed table.  The hashed table's pages
+// are pinned against a reservation; if the smaller table is too large to be
+// stored in the buffer manager in its entirity, then it is hashed a chunk at a
+// time, and the other table is scanned once per chunk.
 //
 class ScanJoin {
 
@@ -2,6 +2,7 @@
 #ifndef AGG_CC
 #define AGG_CC
 
+#include "MyDB_Conjunction.h"
 #include "MyDB_Record.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableReaderWriter.h"
@@ -98,8 +99,16 @@ void Aggregate :: run (bool groupFirst) {
 	MyDB_RecordPtr combinedRec = make_shared <MyDB_Record> (combinedSchema);
 	combinedRec->buildFrom (inputRec, aggRec);
 	
+	// the pages of aggregate records are pinned against a reservation, which grows a
+	// page at a time as the groups come in
+	MyDB_ReservationPtr grant = input->getBufferMgr ()->reserve (1);
+	if (grant == nullptr) {
+		cout << "Can't reserve any buffer frames for the aggregation!!\n";
+		return;
+	}
+
 	// this is the current page where we are writing aggregate records
-	MyDB_PageReaderWriter lastPage (true, *(input->getBufferMgr ()));
+	MyDB_PageReaderWriter lastPage (grant, *(input->getBufferMgr ()));
 
 	// this is the list all of the pages used to store aggregate records
 	vector <MyDB_PageReaderWriter> allPages;
@@ -157,18 +166,20 @@ void Aggregate :: run (bool groupFirst) {
 	}
 	aggComps.push_back (combinedRec->compileComputation ("+ ( int[1], [MyDB_CntAtt])"));
 
-	// and this runs the selection on the input records
-	func inputPred = inputRec->compileComputation (selectionPredicate);
+	// and this runs the selection on the input records, with the conjuncts in the order
+	// that works best for them
+	MyDB_Conjunction inputPred (inputRec, selectionPredicate);
 
-	// at this point, we are ready to go!!
-	MyDB_RecordIteratorPtr myIter = input->getIterator (inputRec);
+	// at this point, we are ready to go!!  The input is only read once, so a big input
+	// goes through a ring of frames, and leaves the rest of the buffer alone
+	MyDB_RecordIteratorPtr myIter = input->getIterator (inputRec, input->getBulkReadStrategy ());
 	MyDB_AttValPtr zero = make_shared <MyDB_IntAttVal> ();
 	while (myIter->hasNext ()) {
 
 		myIter->getNext ();
 
 		// see if it is accepted by the preicate
-		if (!inputPred ()->toBool ()) {
+		if (!inputPred.run ()) {
 			continue;
 		}
 
@@ -252,9 +263,14 @@ void Aggregate :: run (bool groupFirst) {
 		if (loc == nullptr) {
 			loc = lastPage.appendAndReturnLocation (aggRec);
 
-			// if we could not write, then the page was full
+			// if we could not write, then the page was full; if there is no memory for
+			// another page, the groups do not fit in the buffer, and we have to give up
 			if (loc == nullptr) {
-				MyDB_PageReaderWriter nextPage (true, *(input->getBufferMgr ()));
+				if (grant->getNumLeft () == 0 && !grant->grow (1)) {
+					cout << "Can't reserve buffer frames for more than " << allPages.size () << " pages of groups!!\n";
+					return;
+				}
+				MyDB_PageReaderWriter nextPage (grant, *(input->getBufferMgr ()));
 				lastPage = nextPage;
 				allPages.push_back (lastPage);
 				loc = lastPage.appendAndReturnLocation (aggRec);	
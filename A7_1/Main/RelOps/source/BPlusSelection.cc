@@ -3,6 +3,7 @@
 #define BPLUS_SELECTION_C
 
 #include "BPlusSelection.h"
+#include "MyDB_Conjunction.h"
 
 BPlusSelection :: BPlusSelection (MyDB_BPlusTreeReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
                 MyDB_AttValPtr lowIn, MyDB_AttValPtr highIn,
@@ -26,16 +27,17 @@ void BPlusSelection :: run () {
 	for (string s : projections) {
 		finalComputations.push_back (inputRec->compileComputation (s));
 	}
-	func pred = inputRec->compileComputation (selectionPredicate);
+	MyDB_Conjunction pred (inputRec, selectionPredicate);
 
 	// now, iterate through the B+-tree query results
 	MyDB_RecordIteratorAltPtr myIter = input->getRangeIteratorAlt (low, high);
 	while (myIter->advance ()) {
 
-		myIter->getCurrent (inputRec);
+		// only look at the record in its page; just the attributes we need are read
+		myIter->getCurrentView (inputRec);
 
 		// see if it is accepted by the predicate
-		if (!pred()->toBool ()) {
+		if (!pred.run ()) {
 			continue;
 		}
 
@@ -2,6 +2,7 @@
 #ifndef REG_SELECTION_C                                        
 #define REG_SELECTION_C
 
+#include "MyDB_Conjunction.h"
 #include "RegularSelection.h"
 
 RegularSelection :: RegularSelection (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
@@ -18,37 +19,36 @@ void RegularSelection :: run () {
 	MyDB_RecordPtr inputRec = input->getEmptyRecord ();
 	MyDB_RecordPtr outputRec = output->getEmptyRecord ();
 	
-	// compile all of the coputations that we need here
-	vector <func> finalComputations;
-	for (string s : projections) {
-        //cout << "projections: " << s << "\n";
-		finalComputations.push_back (inputRec->compileComputation (s));
-	}
-	func pred = inputRec->compileComputation (selectionPredicate);
-
-	// now, iterate through the B+-tree query results
-	MyDB_RecordIteratorAltPtr myIter = input->getIteratorAlt ();
-    int count = 0;
-	while (myIter->advance ()) {
-        count++;
-		myIter->getCurrent (inputRec);
-        //cout << "records: " << inputRec << "\n";
-		// see if it is accepted by the predicate
-		if (!pred()->toBool ()) {
+	// compile all of the coputations that we need here, into one program so that they
+	// share what they have in common; they are run over a batch of records at a time
+	MyDB_ExprProgramPtr finalComputations = inputRec->compileProgram (projections);
+	MyDB_Conjunction pred (inputRec, selectionPredicate);
+
+	// now, iterate through the input a page-sized batch at a time; this is a one-time
+	// scan, so a big input goes through a ring of frames rather than the whole buffer
+	MyDB_RecordIteratorAltPtr myIter = input->getIteratorAlt (input->getBulkReadStrategy ());
+	void *recs[EXPR_BATCH_SIZE];
+	int selected[EXPR_BATCH_SIZE];
+	int numRecs;
+	while ((numRecs = myIter->getBatch (recs, EXPR_BATCH_SIZE)) > 0) {
+
+		// see which records are accepted by the predicate
+		int numSelected = pred.select (inputRec.get (), recs, numRecs, selected);
+		if (numSelected == 0)
 			continue;
-		}
 
-		// run all of the computations
-		int i = 0;
-		for (auto &f : finalComputations) {
-			outputRec->getAtt (i++)->set (f());
+		// run all of the computations, over just those records
+		finalComputations->runBatch (inputRec.get (), recs, selected, numSelected);
+
+		// and write them out; the page with the batch stays pinned all the while
+		for (int j = 0; j < numSelected; j++) {
+			for (int i = 0; i < (int) projections.size (); i++) {
+				outputRec->getAtt (i)->set (finalComputations->getBatchResult (j, i));
+			}
+			outputRec->recordContentHasChanged ();
+			output->append (outputRec);
 		}
-//        cout << "rec: " << inputRec << "\n";
-		outputRec->recordContentHasChanged ();
-		output->append (outputRec);
-//        cout << "new rec: " << outputRec << "\n";
 	}
-//    cout << "count :" << count << "\n";
 }
 
 #endif
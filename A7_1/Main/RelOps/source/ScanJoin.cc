@@ -2,6 +2,7 @@
 #ifndef SCAN_JOIN_C
 #define SCAN_JOIN_C
 
+#include "MyDB_Conjunction.h"
 #include "MyDB_Record.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableReaderWriter.h"
@@ -51,13 +52,6 @@ ScanJoin :: ScanJoin (MyDB_TableReaderWriterPtr leftInputIn, MyDB_TableReaderWri
 
 void ScanJoin :: run () {
 
-	// this is the hash map we'll use to look up data... the key is the hashed value
-	// of all of the records' join keys, and the value is a list of pointers were all
-	// of the records with that hsah value are located
-	unordered_map <size_t, vector <void *>> myHash;
-
-	// get all of the pages
-	vector <MyDB_PageReaderWriter> allData;
 //    cout << "left table: " << leftTable->getTable()->getName() << "\n";
 //    cout << "right table: " << rightTable->getTable()->getName() << "\n";
 //    cout << "leftSelectionPredicate: " << leftSelectionPredicate << "\n";
@@ -68,14 +62,7 @@ void ScanJoin :: run () {
 //    }
 //    cout << "left page num: " << leftTable->getNumPages () << "\n";
 //    cout << "right page num: " << rightTable->getNumPages () << "\n";
-    
-	for (int i = 0; i < leftTable->getNumPages (); i++) {
-//        cout << "i " << i << "\n";
-		MyDB_PageReaderWriter temp = leftTable->getPinned (i);
-		if (temp.getType () == MyDB_PageType :: RegularPage)
-			allData.push_back (leftTable->getPinned (i));
-	}
-	
+
 	// get the left input record 
 	MyDB_RecordPtr leftInputRec = leftTable->getEmptyRecord ();
 
@@ -86,33 +73,8 @@ void ScanJoin :: run () {
 	}
 
 	// now get the predicate
-	func leftPred = leftInputRec->compileComputation (leftSelectionPredicate);
-
-	// add all of the records to the hash table
-	MyDB_RecordIteratorAltPtr myIter = getIteratorAlt (allData);
-
-	while (myIter->advance ()) {
-
-		// hash the current record
-		myIter->getCurrent (leftInputRec);
-
-		// see if it is accepted by the preicate
-		if (!leftPred ()->toBool ()) {
-			continue;
-		}
-
-		// compute its hash
-		size_t hashVal = 0;
-		for (auto &f : leftEqualities) {
-			hashVal ^= f ()->hash ();
-		}
-
-		// see if it is in the hash table
-		myHash [hashVal].push_back (myIter->getCurrentPointer ());
-	}
+	MyDB_Conjunction leftPred (leftInputRec, leftSelectionPredicate);
 
-	// and now we iterate through the other table
-	
 	// get the right input record, and get the various functions over it
 	MyDB_RecordPtr rightInputRec = rightTable->getEmptyRecord ();
 	vector <func> rightEqualities;
@@ -121,7 +83,7 @@ void ScanJoin :: run () {
 	}
 
 	// now get the predicate
-	func rightPred = rightInputRec->compileComputation (rightSelectionPredicate);
+	MyDB_Conjunction rightPred (rightInputRec, rightSelectionPredicate);
 
 	// and get the schema that results from combining the left and right records
 	MyDB_SchemaPtr mySchemaOut = make_shared <MyDB_Schema> ();
@@ -139,66 +101,127 @@ void ScanJoin :: run () {
 	combinedRec->buildFrom (leftInputRec, rightInputRec);
 	
 
-	// now, get the final predicate over it
-	func finalPredicate = combinedRec->compileComputation (finalSelectionPredicate);
+	// now, get the final predicate over it; this, and the computations, are run over
+	// all of the left records that might match a right one at once
+	MyDB_Conjunction finalPredicate (combinedRec, finalSelectionPredicate);
 
-	// and get the final set of computatoins that will be used to buld the output record
-	vector <func> finalComputations;
-	for (string s : projections) {
-		finalComputations.push_back (combinedRec->compileComputation (s));
-	}
+	// and get the final set of computatoins that will be used to buld the output record;
+	// they are all in one program, so that they share what they have in common
+	MyDB_ExprProgramPtr finalComputations = combinedRec->compileProgram (projections);
+	int selected[EXPR_BATCH_SIZE];
 
 	// this is the output record
 	MyDB_RecordPtr outputRec = output->getEmptyRecord ();
-	
-	// now, iterate through the right table
-	MyDB_RecordIteratorPtr myIterAgain = rightTable->getIterator (rightInputRec);
-	while (myIterAgain->hasNext ()) {
 
-		myIterAgain->getNext ();
+	// the pages of the left table are pinned while they are hashed, so reserve frames
+	// for them; if the buffer cannot hold all of them, the left table is hashed a chunk
+	// at a time (as big a chunk as we can get), and the right table is scanned once for
+	// each chunk
+	MyDB_BufferManagerPtr myMgr = leftTable->getBufferMgr ();
+	size_t numLeftPages = leftTable->getNumPages ();
+	MyDB_ReservationPtr grant = myMgr->reserve (numLeftPages);
+	if (grant == nullptr)
+		grant = myMgr->reserve (myMgr->getNumReservable ());
+	if (grant == nullptr || grant->getNumFrames () == 0) {
+		cout << "Can't reserve any buffer frames for the scan join!!\n";
+		return;
+	}
+	size_t chunkSize = grant->getNumFrames ();
 
-		// see if it is accepted by the preicate
-		if (!rightPred ()->toBool ()) {
-			continue;
-		}
+	for (size_t chunkStart = 0; chunkStart < numLeftPages; chunkStart += chunkSize) {
 
-		// hash the current record
-		size_t hashVal = 0;
-		for (auto &f : rightEqualities) {
-			hashVal ^= f ()->hash ();
+		// this is the hash map we'll use to look up data... the key is the hashed value
+		// of all of the records' join keys, and the value is a list of pointers were all
+		// of the records with that hsah value are located
+		unordered_map <size_t, vector <void *>> myHash;
+
+		// get all of the pages in this chunk
+		vector <MyDB_PageReaderWriter> allData;
+		for (size_t i = chunkStart; i < numLeftPages && i < chunkStart + chunkSize; i++) {
+			MyDB_PageReaderWriter temp = leftTable->getPinned (i, grant);
+			if (temp.getType () == MyDB_PageType :: RegularPage)
+				allData.push_back (temp);
 		}
 
-		// get the list of potential matches... first verify that there IS
-		// a match in there
-		if (myHash.count (hashVal) == 0) {
-			continue;
+		// add all of the records to the hash table
+		MyDB_RecordIteratorAltPtr myIter = getIteratorAlt (allData);
+
+		while (myIter->advance ()) {
+
+			// hash the current record; it is only looked at in its page, since all that
+			// is needed is the predicate and the join attributes
+			myIter->getCurrentView (leftInputRec);
+
+			// see if it is accepted by the preicate
+			if (!leftPred.run ()) {
+				continue;
+			}
+
+			// compute its hash
+			size_t hashVal = 0;
+			for (auto &f : leftEqualities) {
+				hashVal ^= f ()->hash ();
+			}
+
+			// see if it is in the hash table
+			myHash [hashVal].push_back (myIter->getCurrentPointer ());
 		}
 
-		// if there is a match, then get the list of matches
-		vector <void *> &potentialMatches = myHash [hashVal];
-		
-		// and iterate though the potential matches, checking each of them
-		for (auto &v : potentialMatches) {
+		// now, iterate through the right table; it is only read once per chunk, so a big
+		// table goes through a ring of frames, and leaves the rest of the buffer alone
+		MyDB_RecordIteratorPtr myIterAgain = rightTable->getIterator (rightInputRec, rightTable->getBulkReadStrategy ());
+		while (myIterAgain->hasNext ()) {
 
-			// build the combined record
-			leftInputRec->fromBinary (v);
+			myIterAgain->getNext ();
 
-			// check to see if it is accepted by the join predicate
-			if (finalPredicate ()->toBool ()) {
+			// see if it is accepted by the preicate
+			if (!rightPred.run ()) {
+				continue;
+			}
 
-				// run all of the computations
-				int i = 0;
-				for (auto &f : finalComputations) {
-					outputRec->getAtt (i++)->set (f());
-				}
+			// hash the current record
+			size_t hashVal = 0;
+			for (auto &f : rightEqualities) {
+				hashVal ^= f ()->hash ();
+			}
+
+			// get the list of potential matches... first verify that there IS
+			// a match in there
+			if (myHash.count (hashVal) == 0) {
+				continue;
+			}
 
-				// the record's content has changed because it 
-				// is now a composite of two records whose content
-				// has changed via a read... we have to tell it this,
-				// or else the record's internal buffer may cause it
-				// to write old values
-				outputRec->recordContentHasChanged ();
-				output->append (outputRec);	
+			// if there is a match, then get the list of matches
+			vector <void *> &potentialMatches = myHash [hashVal];
+			
+			// and go though the potential matches a batch at a time; the left pages are
+			// all pinned, so the records can just be looked at where they are
+			for (size_t start = 0; start < potentialMatches.size (); start += EXPR_BATCH_SIZE) {
+
+				void **recs = potentialMatches.data () + start;
+				int numRecs = min ((size_t) EXPR_BATCH_SIZE, potentialMatches.size () - start);
+
+				// check to see which are accepted by the join predicate
+				int numSelected = finalPredicate.select (leftInputRec.get (), recs, numRecs, selected);
+				if (numSelected == 0)
+					continue;
+
+				// run all of the computations over those
+				finalComputations->runBatch (leftInputRec.get (), recs, selected, numSelected);
+
+				for (int j = 0; j < numSelected; j++) {
+					for (int i = 0; i < (int) projections.size (); i++) {
+						outputRec->getAtt (i)->set (finalComputations->getBatchResult (j, i));
+					}
+
+					// the record's content has changed because it 
+					// is now a composite of two records whose content
+					// has changed via a read... we have to tell it this,
+					// or else the record's internal buffer may cause it
+					// to write old values
+					outputRec->recordContentHasChanged ();
+					output->append (outputRec);	
+				}
 			}
 		}
 	}
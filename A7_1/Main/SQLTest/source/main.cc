@@ -11,8 +11,13 @@
 #include <algorithm>
 #include <iterator>
 #include <cstring>
+#include <thread>
 
 using namespace std;
+
+// the number of pages in the buffer; the temp pool's sizes are worked out from it
+#define BUFFER_PAGES 9056
+
 string toLower (string data) {
 	transform(data.begin(), data.end(), data.begin(), ::tolower);
 	return data;
@@ -30,8 +35,32 @@ int main (int numArgs, char **args) {
 	//MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> (args [1]);
     MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
 
-	// start up the buffer manager
-	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 9056, "tempFile");
+	// start up the buffer manager; table scans read 32 pages ahead, and the temp pages
+	// that sorts and joins spill go in a pool of their own (a quarter of the buffer,
+	// growing to half of it if the tables leave room), so they cannot push the tables out
+	MyDB_BufferOptions bufferOptions;
+	bufferOptions.readAhead = 32;
+	bufferOptions.hugePages = true;
+	bufferOptions.warmStartFile = "bufferManifest";
+	bufferOptions.pools.push_back (MyDB_PoolOptions ("temp", BUFFER_PAGES / 4, BUFFER_PAGES / 2));
+	bufferOptions.tempPool = "temp";
+
+	// shells that are started with MYDB_SHARED_BUFFER set to the same name (say, "/mydb")
+	// share one buffer for the tables' pages
+	if (getenv ("MYDB_SHARED_BUFFER") != nullptr)
+		bufferOptions.sharedBuffer = getenv ("MYDB_SHARED_BUFFER");
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, BUFFER_PAGES, "tempFile", bufferOptions);
+
+	// with MYDB_CODEGEN set to a directory, the computations that are run the most are
+	// compiled to machine code, which is cached there
+	if (getenv ("MYDB_CODEGEN") != nullptr && !MyDB_NativeCode :: enable (getenv ("MYDB_CODEGEN")))
+		cout << "Not compiling to machine code; " << getenv ("MYDB_CODEGEN") << " has to be a directory that only you can use.\n";
+
+	// read back in the pages that were buffered when the shell last shut down; this
+	// goes on while the tables are being set up
+	thread warmer ([myMgr] () {
+		myMgr->warmStart ();
+	});
 
 	// and create tables for everything in the database
 	static map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
@@ -51,6 +80,7 @@ int main (int numArgs, char **args) {
 			allTableReaderWriters[a.first] = allBPlusReaderWriters[a.first];	
 		}
 	}
+	warmer.join ();
 
 	// print out the intro notification
 	cout << "\n          Welcome to MyDB v0.1\n\n";
@@ -91,6 +121,28 @@ int main (int numArgs, char **args) {
 					return 0;
 				}
 
+				// see if we got a "stats" (print what the buffer manager has been doing) or a
+				// "stats reset" (start counting over, say, before a query)
+				if (tokens.size () >= 1 && tokens.size () <= 2 && toLower (tokens[0]) == "stats") {
+					if (tokens.size () == 2 && toLower (tokens[1]) == "reset") {
+						myMgr->resetStats ();
+						cout << "OK, buffer stats reset.\n";
+					} else {
+						cout << myMgr->getStats ();
+					}
+					break;
+				}
+
+				// see if we got a "checkpoint" (remember what is buffered now, so that it
+				// is read back in when the shell is next started)
+				if (tokens.size () == 1 && toLower (tokens[0]) == "checkpoint") {
+					if (myMgr->checkpoint ())
+						cout << "OK, buffer manifest written.\n";
+					else
+						cout << "Could not write the buffer manifest.\n";
+					break;
+				}
+
 				// see if we got a "load soandso from afile"
 				if (tokens.size () == 4 && toLower(tokens[0]) == "load" && toLower(tokens[2]) == "from") {
 